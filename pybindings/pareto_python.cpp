@@ -416,6 +416,7 @@ template <class C, class def_t> void bind_front_container_concept(def_t &p) {
     p.def("hypervolume", [](const C &lhs, const point_type& p) { return lhs.hypervolume(p); });
     p.def("hypervolume", [](const C &lhs, size_t sample_size) { return lhs.hypervolume(sample_size); });
     p.def("hypervolume", [](const C &lhs, size_t sample_size, const point_type& p) { return lhs.hypervolume(sample_size, p); });
+    p.def("seed", [](C &lhs, uint64_t s) { lhs.seed(s); });
     p.def("coverage", [](const C &lhs, const C& rhs) { return lhs.coverage(rhs); });
     p.def("coverage_ratio", [](const C &lhs, const C& rhs) { return lhs.coverage_ratio(rhs); });
     p.def("gd", [](const C &lhs, const C& rhs) { return lhs.gd(rhs); });
@@ -9,6 +9,7 @@
 #include <pareto/common/promote_to_floating_point.h>
 #include <pareto/front.h>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 namespace pareto {
@@ -26,7 +27,7 @@ namespace pareto {
         using unprotected_key_type = unprotected_point_type;
         using protected_key_type = protected_point_type;
         using unprotected_value_type =
-            std::pair<unprotected_key_type, unprotected_mapped_type>;
+            element_pair_t<unprotected_key_type, unprotected_mapped_type>;
         using point_type = typename container_type::key_type;
 
       public /* Forward declarations */:
@@ -239,7 +240,7 @@ namespace pareto {
             /// \param current_front Front with the current
             /// element
             iterator_impl(archive_pointer ar,
-                          const std::vector<front_set_iterator> &begins,
+                          const std::vector<container_iterator> &begins,
                           container_iterator current_iter,
                           size_t current_front_idx)
                 : current_archive_(ar), current_element_(current_iter),
@@ -541,7 +542,9 @@ namespace pareto {
         /// \param rhs
         archive(const archive &rhs)
             : fronts_(rhs.fronts_), is_minimization_(rhs.is_minimization_),
-              size_(rhs.size_), capacity_(rhs.capacity_), alloc_(rhs.alloc_){};
+              size_(rhs.size_), capacity_(rhs.capacity_), alloc_(rhs.alloc_),
+              generator_(rhs.generator_),
+              hypervolume_streams_(rhs.hypervolume_streams_){};
 
         /// \brief Copy constructor data but use another allocator
         archive(const archive &rhs, const allocator_type &alloc)
@@ -550,17 +553,21 @@ namespace pareto {
                   front_set_allocator_type(
                       construct_allocator<front_set_allocator_type>(alloc))),
               is_minimization_(rhs.is_minimization_), size_(rhs.size_),
-              capacity_(rhs.capacity_), alloc_(rhs.alloc_){};
+              capacity_(rhs.capacity_), alloc_(rhs.alloc_),
+              generator_(rhs.generator_),
+              hypervolume_streams_(rhs.hypervolume_streams_){};
 
         /// \brief Move constructor
         /// Move constructors obtain their instances of allocators
         /// by move-constructing from the allocator belonging to
         /// the old container
         archive(archive &&rhs) noexcept
-            : fronts_(std::move(rhs.fronts_)),
+            : container_with_pool(std::move(rhs)),
+              fronts_(std::move(rhs.fronts_)),
               is_minimization_(std::move(rhs.is_minimization_)),
               size_(std::move(rhs.size_)), capacity_(std::move(rhs.capacity_)),
-              alloc_(std::move(rhs.alloc_)) {}
+              alloc_(std::move(rhs.alloc_)), generator_(rhs.generator_),
+              hypervolume_streams_(rhs.hypervolume_streams_) {}
 
         /// \brief Move constructor data but use new allocator
         archive(archive &&rhs, const allocator_type &alloc) noexcept
@@ -570,7 +577,8 @@ namespace pareto {
                       construct_allocator<front_set_allocator_type>(alloc))),
               is_minimization_(std::move(rhs.is_minimization_)),
               size_(std::move(rhs.size_)), capacity_(std::move(rhs.capacity_)),
-              alloc_(rhs.alloc_) {}
+              alloc_(rhs.alloc_), generator_(rhs.generator_),
+              hypervolume_streams_(rhs.hypervolume_streams_) {}
 
         /// \brief Destructor
         ~archive() = default;
@@ -904,6 +912,10 @@ namespace pareto {
                 alloc_ = rhs.alloc_;
             }
             comp_ = rhs.comp_;
+            generator_ = rhs.generator_;
+            hypervolume_streams_ = rhs.hypervolume_streams_;
+            log_reset();
+            record_reset();
             return *this;
         };
 
@@ -940,13 +952,17 @@ namespace pareto {
                 }
             }
             comp_ = std::move(rhs.comp_);
+            generator_ = rhs.generator_;
+            hypervolume_streams_ = rhs.hypervolume_streams_;
+            log_reset();
+            record_reset();
             return *this;
         }
 
       public /* Assignment: AssociativeContainer */:
         /// \brief Initializer list assignment
         archive &operator=(std::initializer_list<value_type> il) noexcept {
-            fronts_.clear();
+            clear();
             insert(il.begin(), il.end());
             return *this;
         }
@@ -1287,6 +1303,8 @@ namespace pareto {
         /// \see
         /// http://www.cs.nott.ac.uk/~pszjds/research/files/dls_emo2009_1.pdf
         bool dominates(const point_type &p) const {
+            trace_scope trace(traced_operation::dominates, size());
+            recording_scope record(operation_trace_, trace_opcode::dominates, p);
             if (fronts_.empty()) {
                 return false;
             }
@@ -1447,6 +1465,9 @@ namespace pareto {
         /// \param reference_point Reference point
         /// \return Hypervolume of this front
         dimension_type hypervolume(point_type reference_point) const {
+            trace_scope trace(traced_operation::hypervolume, size());
+            recording_scope record(operation_trace_, trace_opcode::hypervolume,
+                                   reference_point);
             if (fronts_.empty()) {
                 return dimension_type{0};
             }
@@ -1463,16 +1484,25 @@ namespace pareto {
 
         /// \brief Get hypervolume with monte-carlo simulation
         /// This function uses monte-carlo simulation as getting the
-        /// exact indicator is too costly.
+        /// exact indicator is too costly. Each call draws new samples
+        /// from the generator of the archive (see seed), so repeated
+        /// calls give independent estimates.
         /// \param reference_point Reference for the hyper-volume
         /// \param sample_size Number of samples for the simulation
+        /// \param max_threads Maximum number of threads sampling points
         /// \return Hypervolume of the pareto front
         dimension_type hypervolume(size_t sample_size,
-                                   const point_type &reference_point) const {
+                                   const point_type &reference_point,
+                                   size_t max_threads = 1) const {
+            trace_scope trace(traced_operation::hypervolume, size());
+            recording_scope record(operation_trace_, trace_opcode::hypervolume,
+                                   reference_point, sample_size);
             if (fronts_.empty()) {
                 return dimension_type{0};
             }
-            return fronts_.begin()->hypervolume(sample_size, reference_point);
+            return fronts_.begin()->monte_carlo_hypervolume(
+                sample_size, reference_point,
+                generator_.split(hypervolume_streams_.next()), max_threads);
         }
 
         /// \brief Coverage indicator
@@ -1644,7 +1674,7 @@ namespace pareto {
             if (fronts_.empty()) {
                 return std::numeric_limits<dimension_type>::max();
             }
-            if (reference.fronts_.empty()) {
+            if (reference.empty()) {
                 return dimension_type{0};
             }
             return fronts_.begin()->std_igd_plus(reference);
@@ -1885,6 +1915,23 @@ namespace pareto {
             return static_cast<double>(conflict(a, b)) / denominator;
         }
 
+      public /* Level of detail */:
+        /// \brief Representative subsets of the fronts for plotting
+        /// Each front is decimated with front::decimate, from the first
+        /// front to the last. We return the fronts instead of an archive
+        /// because the elements of a decimated front might not dominate
+        /// the elements of the next decimated front anymore, and the
+        /// archive would move them to another front.
+        /// \param resolution Number of cells along each axis of a 2-d plot
+        std::vector<front_type> decimate(size_t resolution) const {
+            std::vector<front_type> r;
+            r.reserve(fronts_.size());
+            for (const front_type &pf : fronts_) {
+                r.emplace_back(pf.decimate(resolution));
+            }
+            return r;
+        }
+
       public /* Modifying Functions: Container + AllocatorAwareContainer */:
         /// \brief Swap the content of two objects
         /// Swap will replace the allocator only if
@@ -1913,13 +1960,23 @@ namespace pareto {
                 std::swap(alloc_, rhs.alloc_);
             }
             std::swap(comp_, rhs.comp_);
+            std::swap(generator_, rhs.generator_);
+            std::swap(hypervolume_streams_, rhs.hypervolume_streams_);
+            log_reset();
+            rhs.log_reset();
+            record_reset();
+            rhs.record_reset();
         }
 
       public /* Modifiers: Multimap Concept */:
         /// \brief Clear the front
-        void clear() noexcept {
+        /// This is not noexcept because the change log and the operation
+        /// trace might throw while recording the clear.
+        void clear() {
+            recording_scope record(operation_trace_, trace_opcode::clear);
             fronts_.clear();
             size_ = 0;
+            log_change(change_type::clear);
         }
 
         /// \brief Insert element pair
@@ -1929,6 +1986,9 @@ namespace pareto {
         /// \return Iterator to the new element
         /// \return True if insertion happened successfully
         std::pair<iterator, bool> insert(const value_type &v) {
+            trace_scope trace(traced_operation::insert, size());
+            recording_scope record(operation_trace_, trace_opcode::insert,
+                                   v.first);
             maybe_adjust_dimensions(v);
             auto front_it = find_front(v.first);
             return try_insert(front_it, v);
@@ -1939,14 +1999,32 @@ namespace pareto {
         /// \return Iterator to the new element
         /// \return True if insertion happened successfully
         std::pair<iterator, bool> insert(value_type &&v) {
+            trace_scope trace(traced_operation::insert, size());
+            recording_scope record(operation_trace_, trace_opcode::insert,
+                                   v.first);
             maybe_adjust_dimensions(v);
             auto front_it = find_front(v.first);
             return try_insert(front_it, std::move(v));
         }
 
         template <class P> std::pair<iterator, bool> insert(P &&v) {
-            static_assert(std::is_constructible_v<value_type, P &&>);
-            return emplace(std::forward<P>(v));
+            if constexpr (is_key_only_v<mapped_type> &&
+                          std::is_convertible_v<P &&, key_type>) {
+                return insert(value_type(std::forward<P>(v), mapped_type()));
+            } else {
+                static_assert(std::is_constructible_v<value_type, P &&>);
+                return emplace(std::forward<P>(v));
+            }
+        }
+
+        /// \brief Insert a key in a container that only stores keys
+        /// \param k Point
+        /// \return Iterator to the new element
+        /// \return True if insertion happened successfully
+        template <class U = mapped_type,
+                  std::enable_if_t<is_key_only_v<U>, int> = 0>
+        std::pair<iterator, bool> insert(const key_type &k) {
+            return insert(value_type(k, mapped_type()));
         }
 
         /// \brief Insert element with a hint
@@ -2025,6 +2103,9 @@ namespace pareto {
         /// \brief Erase element pointed by iterator from the archive
         /// \warning The modification of the rtree may invalidate the iterators.
         iterator erase(const iterator &position) {
+            trace_scope trace(traced_operation::erase, size());
+            recording_scope record(operation_trace_, trace_opcode::erase_one,
+                                   position->first);
             iterator next_position = std::next(position);
             if (next_position != end()) {
                 key_type next_key = next_position->first;
@@ -2064,6 +2145,9 @@ namespace pareto {
         /// \brief Erase element from the archive
         /// \param v Point
         size_type erase(const key_type &point) {
+            trace_scope trace(traced_operation::erase, size());
+            recording_scope record(operation_trace_, trace_opcode::erase,
+                                   point);
             auto first_non_dominated = find_front(point);
             if (first_non_dominated != fronts_.end()) {
                 return try_erase(first_non_dominated, point);
@@ -2072,29 +2156,130 @@ namespace pareto {
             }
         }
 
+      public /* Change log */:
+        /// \brief Record all modifications in a change log
+        /// Events carry the rank of the elements. Elements pushed down
+        /// or promoted by insertion and erasure cascades are recorded
+        /// as moves between ranks.
+        /// Copies and moves of the archive are not attached to the log.
+        /// \param log Change log or nullptr to stop recording
+        void set_change_log(change_log<key_type> *log) noexcept {
+            change_log_ = log;
+        }
+
+        /// \brief Change log recording the modifications, if any
+        change_log<key_type> *get_change_log() const noexcept {
+            return change_log_;
+        }
+
+      public /* Operation trace */:
+        /// \brief Record all operations in a trace
+        /// The capacity and the current elements are recorded first, so
+        /// that replaying the trace starts from the same archive.
+        /// Merges are recorded as the elements of the merged archive.
+        /// Copies and moves of the archive are not attached to the trace.
+        /// \param writer Trace writer or nullptr to stop recording
+        void set_operation_trace(operation_trace_writer *writer) {
+            operation_trace_ = writer;
+            record_reset();
+        }
+
+        /// \brief Trace writer recording the operations, if any
+        operation_trace_writer *get_operation_trace() const noexcept {
+            return operation_trace_;
+        }
+
+      public /* Random numbers */:
+        /// \brief Seed the generator of randomized algorithms
+        /// The archive uses its generator to estimate the hypervolume
+        /// and to choose the elements it prunes at capacity. Seeding also
+        /// restarts the sequence of hypervolume estimates.
+        void seed(uint64_t s) noexcept {
+            generator_.seed(s);
+            hypervolume_streams_.reset();
+        }
+
+        /// \brief Generator of randomized algorithms
+        const counter_generator &generator() const noexcept {
+            return generator_;
+        }
+
+      public /* What-if / Pareto Concept */:
+        using insert_preview = typename front_type::insert_preview;
+
+        /// \brief Find out what inserting a point would change
+        /// The archive is not modified.
+        /// The rank is the index of the front where the element would
+        /// be inserted, and the evicted elements are the elements of
+        /// this front that would move to the next rank. This does not
+        /// account for elements pruned when the archive is full.
+        insert_preview preview_insert(const key_type &k) const {
+            auto front_it = find_front(k);
+            if (front_it == fronts_.end()) {
+                insert_preview r;
+                r.inserted = size() < capacity();
+                r.rank = fronts_.size();
+                return r;
+            }
+            insert_preview r = front_it->preview_insert(k);
+            r.rank =
+                static_cast<size_t>(std::distance(fronts_.begin(), front_it));
+            return r;
+        }
+
+        /// \brief Find out what inserting a point would change
+        /// \param reference_point Reference for the hypervolume delta
+        /// of the first front
+        insert_preview preview_insert(const key_type &k,
+                                      const point_type &reference_point) const {
+            insert_preview r = preview_insert(k);
+            if (r.inserted && r.rank == 0) {
+                if (fronts_.empty()) {
+                    front_type first_front({}, is_minimization_.begin(),
+                                           is_minimization_.end(), comp_,
+                                           alloc_);
+                    r.hypervolume_delta = first_front.hypervolume_contribution(
+                        k, reference_point);
+                } else {
+                    r.hypervolume_delta =
+                        fronts_.begin()->hypervolume_contribution(
+                            k, reference_point);
+                }
+            }
+            return r;
+        }
+
+      public /* Modifiers: Multimap Concept */:
         /// \brief Merge and move fronts
+        /// The fronts are merged rank by rank.
+        /// \see merge_ranks
         void merge(archive &source) {
-            insert(source.begin(), source.end());
-            source.clear();
+            if (&source != this) {
+                {
+                    recording_scope record(operation_trace_);
+                    merge_ranks(source.fronts_.begin(), source.fronts_.end(),
+                                true);
+                }
+                record_reset();
+                source.clear();
+            }
         }
 
         /// \brief Merge and move fronts
         void merge(front_type &source) {
-            insert(source.begin(), source.end());
+            {
+                recording_scope record(operation_trace_);
+                merge_ranks(&source, &source + 1, true);
+            }
+            record_reset();
             source.clear();
         }
 
         /// \brief Merge and move fronts
-        void merge(archive &&source) {
-            insert(source.begin(), source.end());
-            source.clear();
-        }
+        void merge(archive &&source) { merge(source); }
 
         /// \brief Merge and move fronts
-        void merge(front_type &&source) {
-            insert(source.begin(), source.end());
-            source.clear();
-        }
+        void merge(front_type &&source) { merge(source); }
 
         /// \brief Resize the archive
         /// If new size is more than the number of elements
@@ -2105,6 +2290,9 @@ namespace pareto {
         /// \param new_size
         void resize(size_t new_size) {
             size_t current_size = size();
+            trace_scope trace(traced_operation::resize, current_size);
+            recording_scope record(operation_trace_, trace_opcode::resize,
+                                   new_size);
             capacity_ = new_size;
             if (new_size < current_size) {
                 prune(current_size - new_size);
@@ -2179,7 +2367,7 @@ namespace pareto {
             typename iterator::fronts_and_elements_type begins;
             for (auto front_it = fronts_.begin(); front_it != fronts_.end();
                  ++front_it) {
-                auto value_it = front_it->find(ps);
+                auto value_it = unconst_reference(*front_it).find(ps);
                 if (value_it != front_it->end()) {
                     begins.emplace_back(front_it, value_it);
                 }
@@ -2264,6 +2452,9 @@ namespace pareto {
 
         /// \brief Find nearest point
         iterator find_nearest(const point_type &p) {
+            trace_scope trace(traced_operation::find_nearest, size());
+            recording_scope record(operation_trace_,
+                                   trace_opcode::find_nearest, p);
             // each begin points to the nearest in each front
             typename iterator::fronts_and_elements_type nearests;
             for (auto front_it = fronts_.begin(); front_it != fronts_.end();
@@ -2273,6 +2464,9 @@ namespace pareto {
                     nearests.emplace_back(front_it, it);
                 }
             }
+            if (nearests.empty()) {
+                return end();
+            }
 
             // check which begin has the nearest point
             auto best_it =
@@ -2294,6 +2488,9 @@ namespace pareto {
 
         /// \brief Find k nearest points
         iterator find_nearest(const point_type &p, size_t k) {
+            trace_scope trace(traced_operation::find_nearest, size());
+            recording_scope record(operation_trace_,
+                                   trace_opcode::find_nearest, p, k);
             // Store up to k * fronts() closest points with front iterators
             std::vector<unprotected_value_type> closest_candidates;
 
@@ -2307,6 +2504,12 @@ namespace pareto {
                 }
             }
 
+            // There might be fewer than k points in all fronts
+            k = std::min(k, closest_candidates.size());
+            if (k == 0) {
+                return end();
+            }
+
             // Sort these points by distance
             auto dist_comp = [&p](const value_type &a, const value_type &b) {
                 return p.distance(a.first) < p.distance(b.first);
@@ -2481,13 +2684,17 @@ namespace pareto {
 
       public /* Lookup: ArchiveContainer */:
         /// \brief Find first front that does not dominate p
+        /// The dominance checks of the search are not reported to
+        /// the tracing hooks.
         typename front_set_type::iterator find_front(const point_type &p) {
+            trace_scope untraced;
             return fronts_.find(p);
         }
 
         /// \brief Find first front that does not dominate p
         typename front_set_type::const_iterator
         find_front(const point_type &p) const {
+            trace_scope untraced;
             return fronts_.find(p);
         }
 
@@ -2633,7 +2840,8 @@ namespace pareto {
         /// The same comments can be applied to our erase algorithm.
         std::pair<iterator, bool>
         try_insert(typename front_set_type::iterator front_it,
-                   const value_type &v) {
+                   const value_type &v, bool cascading = false) {
+            cascade_counter cascade;
             const bool front_is_valid = front_it != fronts_.end();
             if (front_is_valid) {
                 const bool can_solve_in_constant_time =
@@ -2653,6 +2861,7 @@ namespace pareto {
                     const bool new_front_is_valid =
                         new_front_it != fronts_.end();
                     if (new_front_is_valid) {
+                        log_placement(new_front_it, v.first, cascading, true);
                         // If inserting v made the archive exceed its max size
                         if (size() > capacity()) {
                             resize(capacity());
@@ -2715,6 +2924,7 @@ namespace pareto {
                 auto [front_element_it, ok] = pf.insert(v);
                 if (ok) {
                     ++size_;
+                    log_placement(front_it, v.first, cascading, false);
                 }
 
                 // Recursively reinsert previously dominated solutions
@@ -2723,7 +2933,7 @@ namespace pareto {
                 // to the next front after insertion.
                 for (const auto &v2 : dominated_solutions) {
                     auto next_front_it = std::next(front_it);
-                    try_insert(next_front_it, v2);
+                    try_insert(next_front_it, v2, true);
                 }
 
                 // Create archive iterator to this new solution
@@ -2766,6 +2976,7 @@ namespace pareto {
                     const bool new_front_is_valid =
                         new_front_it != fronts_.end();
                     if (new_front_is_valid) {
+                        log_placement(new_front_it, v.first, cascading, true);
                         iterator it2 = iterator(
                             this,
                             typename iterator::fronts_and_elements_type{
@@ -2778,6 +2989,14 @@ namespace pareto {
                     }
                 }
             }
+            // v does not fit in the archive
+            if (removed_log_ != nullptr) {
+                removed_log_->emplace_back(v);
+            }
+            if (cascading && change_log_ != nullptr) {
+                // v was pushed out of the last front
+                log_change(change_type::erase, v.first, fronts_.size() - 1);
+            }
             return {end(), false};
         }
 
@@ -2815,7 +3034,7 @@ namespace pareto {
         /// \param point
         /// \return
         size_type try_erase(typename front_set_type::iterator front_it,
-                            const key_type &point_ref) {
+                            const key_type &point_ref, bool moved = false) {
             // Make a copy of the point because if the pointer reference
             // is a reference inside the a front, we might delete the
             // very parameter we need to make this work
@@ -2826,10 +3045,18 @@ namespace pareto {
                 return 0;
             }
             size_ -= n_erased;
+            const size_t rank = change_log_ != nullptr ? rank_of(front_it) : 0;
+            if (!moved) {
+                // moved elements were logged when they were promoted
+                for (size_t i = 0; i < n_erased; ++i) {
+                    log_change(change_type::erase, point, rank);
+                }
+            }
 
             const bool front_became_empty = pf.empty();
             if (front_became_empty) {
                 fronts_.erase(front_it);
+                log_change(change_type::erase_front, key_type{}, rank);
             } else {
                 auto next_front = std::next(front_it);
                 const bool there_is_a_next_front = next_front != fronts_.end();
@@ -2855,7 +3082,9 @@ namespace pareto {
                                 auto [it, ok] = pf.insert(v);
                                 if (ok) {
                                     ++size_;
-                                    try_erase(next_front, v.first);
+                                    log_change(change_type::move, v.first,
+                                               rank, rank + 1);
+                                    try_erase(next_front, v.first, true);
                                 }
                             }
                         }
@@ -2865,6 +3094,255 @@ namespace pareto {
             return n_erased;
         }
 
+        /// \brief Merge a sequence of fronts into the archive rank by rank
+        /// The i-th source front is merged into our i-th front together
+        /// with the elements pushed down from the previous rank. The
+        /// elements pushed down to the next rank are the elements
+        /// rejected by our front and the elements of our front evicted
+        /// by the incoming elements. Each rank is merged with the
+        /// front merge, which uses the indexes of both fronts, instead
+        /// of cascading every element through the archive.
+        template <class FrontIterator>
+        void merge_ranks(FrontIterator first, FrontIterator last,
+                         bool move_values) {
+            if (first != last && !first->empty()) {
+                maybe_adjust_dimensions(*first->begin());
+            }
+            // ranks of our elements before the merge for the change log
+            std::unordered_map<key_type, std::vector<size_t>> previous_ranks;
+            const size_t previous_fronts = fronts_.size();
+            if (change_log_ != nullptr) {
+                size_t rank = 0;
+                for (const front_type &pf : fronts_) {
+                    for (const value_type &v : pf) {
+                        previous_ranks[v.first].emplace_back(rank);
+                    }
+                    ++rank;
+                }
+            }
+            auto front_it = fronts_.begin();
+            std::vector<value_type> carry;
+            while (first != last || !carry.empty()) {
+                // non-dominated elements arriving at this rank
+                front_type incoming({}, is_minimization_.begin(),
+                                    is_minimization_.end(), comp_, alloc_);
+                std::vector<value_type> next_carry;
+                if (first != last) {
+                    incoming.merge_and_split(unconst_reference(*first),
+                                             move_values, &next_carry);
+                    ++first;
+                }
+                for (value_type &v : carry) {
+                    if (incoming.dominates(v.first)) {
+                        next_carry.emplace_back(std::move(v));
+                    } else {
+                        auto dominated_it = incoming.find_dominated(v.first);
+                        std::copy(dominated_it, incoming.end(),
+                                  std::back_inserter(next_carry));
+                        incoming.erase(dominated_it, incoming.end());
+                        incoming.data_.insert(std::move(v));
+                    }
+                }
+
+                // merge them with the front at this rank
+                if (!incoming.empty()) {
+                    if (front_it != fronts_.end()) {
+                        // Removing the constness is safe here because
+                        // all elements pushed down are dominated by the
+                        // merged front, so the order of the set holds
+                        front_type &pf = unconst_reference(*front_it);
+                        pf.merge_and_split(incoming, true, &next_carry,
+                                           &next_carry);
+                        ++front_it;
+                    } else {
+                        fronts_.emplace_hint(fronts_.end(),
+                                             std::move(incoming));
+                    }
+                }
+                carry = std::move(next_carry);
+            }
+
+            size_ = total_front_sizes();
+            log_merge(previous_ranks, previous_fronts);
+            if (size() > capacity()) {
+                prune(size() - capacity());
+            }
+        }
+
+        /// \brief Rank of a front
+        size_t rank_of(typename front_set_type::const_iterator front_it) const {
+            return static_cast<size_t>(std::distance(fronts_.begin(), front_it));
+        }
+
+        /// \brief Record a change if there is a change log
+        void log_change(change_type type, const key_type &k = key_type{},
+                        size_t rank = 0, size_t previous_rank = 0) {
+            if (change_log_ != nullptr) {
+                change_log_->record(type, k, rank, previous_rank);
+            }
+        }
+
+        /// \brief Record where try_insert placed an element
+        /// Elements pushed down by a cascade come from the previous rank.
+        void log_placement(typename front_set_type::const_iterator front_it,
+                           const key_type &k, bool cascading, bool new_front) {
+            if (change_log_ != nullptr) {
+                const size_t rank = rank_of(front_it);
+                if (new_front) {
+                    log_change(change_type::insert_front, key_type{}, rank);
+                }
+                if (cascading) {
+                    log_change(change_type::move, k, rank, rank - 1);
+                } else {
+                    log_change(change_type::insert, k, rank);
+                }
+            }
+        }
+
+        /// \brief Record what a merge changed
+        /// Merges only append new fronts. Each element is matched with
+        /// the ranks its key had before the merge: elements still at
+        /// one of these ranks did not change, elements at another rank
+        /// moved, and the other elements were inserted. The ranks left
+        /// without a match belong to elements the merge evicted.
+        void log_merge(
+            std::unordered_map<key_type, std::vector<size_t>> &previous_ranks,
+            size_t previous_fronts) {
+            if (change_log_ == nullptr) {
+                return;
+            }
+            for (size_t rank = previous_fronts; rank < fronts_.size(); ++rank) {
+                log_change(change_type::insert_front, key_type{}, rank);
+            }
+            std::vector<std::pair<const key_type *, size_t>> arrived;
+            size_t rank = 0;
+            for (const front_type &pf : fronts_) {
+                for (const value_type &v : pf) {
+                    auto it = previous_ranks.find(v.first);
+                    if (it != previous_ranks.end()) {
+                        std::vector<size_t> &ranks = it->second;
+                        auto same_rank =
+                            std::find(ranks.begin(), ranks.end(), rank);
+                        if (same_rank != ranks.end()) {
+                            *same_rank = ranks.back();
+                            ranks.pop_back();
+                            continue;
+                        }
+                    }
+                    arrived.emplace_back(&v.first, rank);
+                }
+                ++rank;
+            }
+            for (const auto &[k, new_rank] : arrived) {
+                auto it = previous_ranks.find(*k);
+                if (it != previous_ranks.end() && !it->second.empty()) {
+                    log_change(change_type::move, *k, new_rank,
+                               it->second.back());
+                    it->second.pop_back();
+                } else {
+                    log_change(change_type::insert, *k, new_rank);
+                }
+            }
+            for (const auto &[k, ranks] : previous_ranks) {
+                for (size_t previous_rank : ranks) {
+                    log_change(change_type::erase, k, previous_rank);
+                }
+            }
+        }
+
+        /// \brief Record the current elements in the operation trace
+        /// Inserting the elements rank by rank recreates the same fronts.
+        void record_reset() const {
+            if (operation_trace_ != nullptr && !recording_scope::nested()) {
+                operation_trace_->record(trace_opcode::resize, capacity_);
+                operation_trace_->record(trace_opcode::clear);
+                for (const front_type &pf : fronts_) {
+                    for (const value_type &v : pf) {
+                        operation_trace_->record(trace_opcode::insert, v.first);
+                    }
+                }
+            }
+        }
+
+        /// \brief Record that all elements were replaced
+        /// Assignments and swaps are recorded as a clear
+        /// followed by the insertion of each element at its rank.
+        void log_reset() {
+            if (change_log_ != nullptr) {
+                log_change(change_type::clear);
+                size_t rank = 0;
+                for (const front_type &pf : fronts_) {
+                    log_change(change_type::insert_front, key_type{}, rank);
+                    for (const value_type &v : pf) {
+                        log_change(change_type::insert, v.first, rank);
+                    }
+                    ++rank;
+                }
+            }
+        }
+
+        /// \brief Insert an element and log the elements removed
+        /// Elements pruned or dropped from the archive are logged
+        /// while the insertion runs. Elements only moved to another
+        /// rank are not logged because ranks are restored by the
+        /// cascades when the insertion is undone. Elements with the
+        /// same key as v are logged because undoing the insertion
+        /// erases the key.
+        /// \see transaction
+        /// \return True if the element was inserted
+        bool insert_and_log(const value_type &v,
+                            std::vector<value_type> &removed) {
+            std::vector<value_type> same_key;
+            std::copy(find_intersection(v.first), end(),
+                      std::back_inserter(same_key));
+            removed_log_ = &removed;
+            bool inserted = false;
+            try {
+                inserted = insert(v).second;
+            } catch (...) {
+                removed_log_ = nullptr;
+                throw;
+            }
+            removed_log_ = nullptr;
+            // v itself might have been pruned or dropped
+            std::vector<value_type> others;
+            for (value_type &r : removed) {
+                if (r.first != v.first) {
+                    others.emplace_back(std::move(r));
+                }
+            }
+            removed = std::move(others);
+            if (inserted || !removed.empty()) {
+                for (value_type &r : same_key) {
+                    removed.emplace_back(std::move(r));
+                }
+            }
+            return inserted;
+        }
+
+        /// \brief Erase all elements with key k and log them
+        /// \see transaction
+        size_type erase_and_log(const key_type &k,
+                                std::vector<value_type> &removed) {
+            std::copy(find_intersection(k), end(),
+                      std::back_inserter(removed));
+            return erase(k);
+        }
+
+        /// \brief Undo an operation logged by a transaction
+        /// Erasing and inserting elements moves the other elements
+        /// back to their previous ranks. The archive size is never
+        /// larger than its previous size, so nothing is pruned.
+        void undo(const std::optional<key_type> &key,
+                  std::vector<value_type> &removed) {
+            if (key) {
+                erase(*key);
+            }
+            for (value_type &v : removed) {
+                insert(std::move(v));
+            }
+        }
+
         /// \brief Remove elements from the last archive fronts
         /// This function removes the elements without changing the
         /// max size
@@ -2873,6 +3351,18 @@ namespace pareto {
                 const bool excess_larger_than_last_front =
                     excess >= fronts_.rbegin()->size();
                 if (excess_larger_than_last_front) {
+                    if (change_log_ != nullptr) {
+                        const size_t rank = fronts_.size() - 1;
+                        for (const value_type &v : *fronts_.rbegin()) {
+                            log_change(change_type::erase, v.first, rank);
+                        }
+                        log_change(change_type::erase_front, key_type{}, rank);
+                    }
+                    if (removed_log_ != nullptr) {
+                        std::copy(fronts_.rbegin()->begin(),
+                                  fronts_.rbegin()->end(),
+                                  std::back_inserter(*removed_log_));
+                    }
                     excess -= fronts_.rbegin()->size();
                     size_ -= fronts_.rbegin()->size();
                     fronts_.erase(std::prev(fronts_.end()));
@@ -2894,7 +3384,7 @@ namespace pareto {
         void prune_random(size_t n_to_remove) {
             front_type &last_front = unconst_reference(*fronts_.rbegin());
             box_type b(last_front.ideal(), last_front.nadir());
-            auto &g = archive::generator();
+            auto &g = generator_;
             for (size_t i = 0; i < n_to_remove; ++i) {
                 point_type r(dimensions());
                 for (size_t j = 0; j < r.dimensions(); ++j) {
@@ -2904,6 +3394,10 @@ namespace pareto {
                     r[j] = d(g);
                 }
                 auto it = last_front.find_nearest(r);
+                if (removed_log_ != nullptr) {
+                    removed_log_->emplace_back(*it);
+                }
+                log_change(change_type::erase, it->first, fronts_.size() - 1);
                 last_front.erase(it);
                 --size_;
             }
@@ -2931,6 +3425,19 @@ namespace pareto {
                     return a.second < b.second;
                 });
             for (size_t i = 0; i < n_to_remove; ++i) {
+                if (removed_log_ != nullptr) {
+                    std::copy(last_front.find_intersection(candidates[i].first),
+                              last_front.end(),
+                              std::back_inserter(*removed_log_));
+                }
+                if (change_log_ != nullptr) {
+                    for (auto it = last_front.find_intersection(
+                             candidates[i].first);
+                         it != last_front.end(); ++it) {
+                        log_change(change_type::erase, it->first,
+                                   fronts_.size() - 1);
+                    }
+                }
                 size_ -= last_front.erase(candidates[i].first);
             }
         }
@@ -2969,29 +3476,12 @@ namespace pareto {
 
         iterator create_unconst_iterator(const_iterator position) {
             iterator it(const_cast<archive *>(position.current_archive_));
-            std::vector<std::pair<typename front_set_type::iterator,
-                                  typename container_type::iterator>>
-                begins;
-            for (const auto &item : position.front_begins_) {
-                begins.emplace_back(item);
-            }
-            it.current_element_ =
-                reinterpret_cast<decltype(it.current_element_)>(
-                    position.current_element_);
+            it.front_begins_ = position.front_begins_;
+            it.current_element_ = position.current_element_;
             it.current_front_idx_ = position.current_front_idx_;
             return it;
         }
 
-        static std::mt19937 &generator() {
-            static std::mt19937 g(static_cast<unsigned int>(
-                static_cast<unsigned int>(std::random_device()()) |
-                static_cast<unsigned int>(
-                    std::chrono::high_resolution_clock::now()
-                        .time_since_epoch()
-                        .count())));
-            return g;
-        }
-
         void initialize_directions(size_t target_size = 1, bool fill = true) {
             constexpr bool compile_time_dimension =
                 number_of_compile_dimensions != 0;
@@ -3070,6 +3560,24 @@ namespace pareto {
 
         /// \brief Key comparison (single dimension)
         dimension_compare comp_{std::less<dimension_type>()};
+
+        /// \brief Receives the elements removed by the current operation
+        /// Only set while a transaction runs an operation.
+        std::vector<value_type> *removed_log_{nullptr};
+
+        /// \brief Log recording the modifications (optional)
+        change_log<key_type> *change_log_{nullptr};
+
+        /// \brief Trace recording the operations (optional)
+        operation_trace_writer *operation_trace_{nullptr};
+
+        /// \brief Generator of randomized algorithms
+        counter_generator generator_;
+
+        /// \brief Index of the next hypervolume sample stream
+        mutable stream_counter hypervolume_streams_;
+
+        template <class> friend class transaction;
     };
 
     /// \brief Relational operator < for archives and archives
@@ -3198,6 +3706,15 @@ namespace pareto {
         return !(lhs == rhs);
     }
 
+    /// \brief Pareto archive that only stores keys
+    /// The elements have no mapped values, so keys can be inserted
+    /// directly. All dominance, query and indicator functions work as
+    /// in a archive with mapped values. The elements are key_only_pair
+    /// objects, which take as much memory as their keys.
+    template <class K, size_t M,
+              class Container = spatial_map<K, M, no_value>>
+    using archive_set = archive<K, M, no_value, Container>;
+
 } // namespace pareto
 
 #endif // PARETO_FRONT_ARCHIVE_H
@@ -0,0 +1,507 @@
+#ifndef PARETO_ARROW_H
+#define PARETO_ARROW_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <pareto/archive.h>
+#include <pareto/front.h>
+
+/// Arrow C Data Interface
+/// These are the ABI-stable structs Arrow implementations use to share
+/// columns without copying them. We define them here so that we don't
+/// depend on Arrow. Arrow headers define the same macro.
+/// \see https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    // Array type description
+    const char *format;
+    const char *name;
+    const char *metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema **children;
+    struct ArrowSchema *dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema *);
+    // Opaque producer-specific data
+    void *private_data;
+};
+
+struct ArrowArray {
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void **buffers;
+    struct ArrowArray **children;
+    struct ArrowArray *dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray *);
+    // Opaque producer-specific data
+    void *private_data;
+};
+
+#endif // ARROW_C_DATA_INTERFACE
+
+namespace pareto {
+    /// \brief Arrow format string of a number type
+    /// \return Format string or nullptr if Arrow has no such primitive
+    template <class N> constexpr const char *arrow_format() {
+        if constexpr (std::is_same_v<N, double>) {
+            return "g";
+        } else if constexpr (std::is_same_v<N, float>) {
+            return "f";
+        } else if constexpr (std::is_integral_v<N> && !std::is_same_v<N, bool>) {
+            constexpr bool s = std::is_signed_v<N>;
+            if constexpr (sizeof(N) == 1) {
+                return s ? "c" : "C";
+            } else if constexpr (sizeof(N) == 2) {
+                return s ? "s" : "S";
+            } else if constexpr (sizeof(N) == 4) {
+                return s ? "i" : "I";
+            } else if constexpr (sizeof(N) == 8) {
+                return s ? "l" : "L";
+            } else {
+                return nullptr;
+            }
+        } else {
+            return nullptr;
+        }
+    }
+
+    /// \class Column of an Arrow array we can read numbers from
+    /// This only looks at the buffers of the array. Nothing is copied.
+    class arrow_column {
+      public:
+        arrow_column(const ArrowArray &array, const ArrowSchema &schema)
+            : data_(nullptr), offset_(array.offset), format_(schema.format[0]) {
+            if (std::strlen(schema.format) != 1 ||
+                std::strchr("gfcCsSiIlL", format_) == nullptr) {
+                throw std::invalid_argument(
+                    std::string("arrow_column: unsupported format ") +
+                    schema.format);
+            }
+            if (array.n_buffers != 2) {
+                throw std::invalid_argument(
+                    "arrow_column: primitive arrays have two buffers");
+            }
+            // a null count of -1 means the producer did not count the
+            // nulls, so we need to look at the validity bitmap
+            if (array.null_count != 0 && array.buffers[0] != nullptr) {
+                validity_ = static_cast<const uint8_t *>(array.buffers[0]);
+            } else if (array.null_count > 0) {
+                throw std::invalid_argument(
+                    "arrow_column: columns cannot have null values");
+            }
+            data_ = array.buffers[1];
+        }
+
+        /// rief True if no row in [first, last) is null
+        [[nodiscard]] bool all_valid(int64_t first, int64_t last) const {
+            if (validity_ == nullptr) {
+                return true;
+            }
+            for (int64_t row = first; row < last; ++row) {
+                const int64_t i = row + offset_;
+                if ((validity_[i / 8] & (1 << (i % 8))) == 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// \brief Value at a row converted to N
+        template <class N> N get(int64_t row) const {
+            const int64_t i = row + offset_;
+            switch (format_) {
+            case 'g':
+                return static_cast<N>(static_cast<const double *>(data_)[i]);
+            case 'f':
+                return static_cast<N>(static_cast<const float *>(data_)[i]);
+            case 'c':
+                return static_cast<N>(static_cast<const int8_t *>(data_)[i]);
+            case 'C':
+                return static_cast<N>(static_cast<const uint8_t *>(data_)[i]);
+            case 's':
+                return static_cast<N>(static_cast<const int16_t *>(data_)[i]);
+            case 'S':
+                return static_cast<N>(static_cast<const uint16_t *>(data_)[i]);
+            case 'i':
+                return static_cast<N>(static_cast<const int32_t *>(data_)[i]);
+            case 'I':
+                return static_cast<N>(static_cast<const uint32_t *>(data_)[i]);
+            case 'l':
+                return static_cast<N>(static_cast<const int64_t *>(data_)[i]);
+            default:
+                return static_cast<N>(static_cast<const uint64_t *>(data_)[i]);
+            }
+        }
+
+      private:
+        const void *data_;
+        const uint8_t *validity_{nullptr};
+        int64_t offset_;
+        char format_;
+    };
+
+    /// \class Rows of a struct array with one column per objective
+    /// The children of the struct array are the objective columns, in
+    /// order, except for the columns named "id" and "rank". The "id"
+    /// column, if any, has the mapped values. The "rank" column is
+    /// what we export for archives and is ignored on import.
+    ///
+    /// The iterators create the elements from the columns as the
+    /// container reads them, so no element is materialized before the
+    /// container stores it.
+    template <class K, size_t M, class T> class arrow_rows {
+      public:
+        using key_type = point<K, M>;
+        using value_type = std::pair<const key_type, T>;
+
+        class iterator {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = arrow_rows::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = value_type;
+
+            iterator() = default;
+
+            iterator(const arrow_rows *rows, int64_t row)
+                : rows_(rows), row_(row) {}
+
+            value_type operator*() const { return rows_->row(row_); }
+
+            iterator &operator++() {
+                ++row_;
+                return *this;
+            }
+
+            iterator operator++(int) { // NOLINT(cert-dcl21-cpp)
+                auto tmp = *this;
+                ++row_;
+                return tmp;
+            }
+
+            bool operator==(const iterator &rhs) const {
+                return row_ == rhs.row_;
+            }
+
+            bool operator!=(const iterator &rhs) const {
+                return row_ != rhs.row_;
+            }
+
+          private:
+            const arrow_rows *rows_{nullptr};
+            int64_t row_{0};
+        };
+
+      public:
+        /// \brief View the rows of a struct array
+        /// \throws std::invalid_argument if the array is not a struct
+        /// of numeric columns with the front dimensions
+        arrow_rows(const ArrowArray &array, const ArrowSchema &schema)
+            : length_(array.length) {
+            if (std::strcmp(schema.format, "+s") != 0 ||
+                schema.n_children != array.n_children) {
+                throw std::invalid_argument(
+                    "arrow_rows: expected a struct array");
+            }
+            for (int64_t i = 0; i < schema.n_children; ++i) {
+                const ArrowSchema &child_schema = *schema.children[i];
+                const ArrowArray &child = *array.children[i];
+                const std::string name =
+                    child_schema.name != nullptr ? child_schema.name : "";
+                if (child.length < array.offset + array.length) {
+                    throw std::invalid_argument(
+                        "arrow_rows: column is shorter than the array");
+                }
+                if (name == "id") {
+                    if constexpr (arrow_format<T>() != nullptr) {
+                        mapped_.emplace_back(child, child_schema);
+                    }
+                } else if (name != "rank") {
+                    objectives_.emplace_back(child, child_schema);
+                }
+            }
+            offset_ = array.offset;
+            if (objectives_.empty() ||
+                (M != 0 && objectives_.size() != M)) {
+                throw std::invalid_argument(
+                    "arrow_rows: number of objective columns does not "
+                    "match the number of dimensions");
+            }
+            for (const std::vector<arrow_column> *columns :
+                 {&objectives_, &mapped_}) {
+                for (const arrow_column &c : *columns) {
+                    if (!c.all_valid(offset_, offset_ + length_)) {
+                        throw std::invalid_argument(
+                            "arrow_rows: columns cannot have null values");
+                    }
+                }
+            }
+        }
+
+        iterator begin() const { return iterator(this, 0); }
+
+        iterator end() const { return iterator(this, length_); }
+
+        [[nodiscard]] size_t size() const {
+            return static_cast<size_t>(length_);
+        }
+
+        /// \brief Create the element in a row
+        value_type row(int64_t r) const {
+            const int64_t i = r + offset_;
+            key_type p(objectives_.size());
+            for (size_t j = 0; j < objectives_.size(); ++j) {
+                p[j] = objectives_[j].template get<K>(i);
+            }
+            if (mapped_.empty()) {
+                return value_type(p, T{});
+            }
+            return value_type(p, mapped_.front().template get<T>(i));
+        }
+
+      private:
+        int64_t length_;
+        int64_t offset_{0};
+        std::vector<arrow_column> objectives_;
+        std::vector<arrow_column> mapped_;
+    };
+
+    namespace detail {
+        /// \brief Buffers owned by an exported struct array
+        struct arrow_array_data {
+            std::vector<std::vector<char>> values;
+            std::vector<std::array<const void *, 2>> buffers;
+            std::vector<ArrowArray> children;
+            std::vector<ArrowArray *> child_pointers;
+            const void *struct_buffer{nullptr};
+        };
+
+        /// \brief Names and formats owned by an exported schema
+        /// The schema and the array can be released in any order.
+        struct arrow_schema_data {
+            std::vector<std::string> names;
+            std::vector<ArrowSchema> children;
+            std::vector<ArrowSchema *> child_pointers;
+        };
+
+        /// \brief Children are released with their parents
+        inline void release_arrow_child_array(ArrowArray *array) {
+            array->release = nullptr;
+        }
+
+        inline void release_arrow_child_schema(ArrowSchema *schema) {
+            schema->release = nullptr;
+        }
+
+        inline void release_arrow_array(ArrowArray *array) {
+            delete static_cast<arrow_array_data *>(array->private_data);
+            array->release = nullptr;
+        }
+
+        inline void release_arrow_schema(ArrowSchema *schema) {
+            delete static_cast<arrow_schema_data *>(schema->private_data);
+            schema->release = nullptr;
+        }
+
+        /// \brief Column of an export before its buffers exist
+        struct arrow_column_spec {
+            std::string name;
+            const char *format;
+            size_t value_size;
+        };
+
+        /// \brief Allocate the columns of an export
+        /// \return Pointers to the values of each column
+        inline std::vector<char *>
+        make_arrow_export(const std::vector<arrow_column_spec> &columns,
+                          size_t length, ArrowArray *out_array,
+                          ArrowSchema *out_schema) {
+            auto array_data = std::make_unique<arrow_array_data>();
+            auto schema_data = std::make_unique<arrow_schema_data>();
+            const size_t n_columns = columns.size();
+            array_data->values.resize(n_columns);
+            array_data->buffers.resize(n_columns);
+            array_data->children.resize(n_columns);
+            schema_data->children.resize(n_columns);
+            std::vector<char *> values(n_columns);
+            for (size_t i = 0; i < n_columns; ++i) {
+                array_data->values[i].resize(length * columns[i].value_size);
+                values[i] = array_data->values[i].data();
+                array_data->buffers[i] = {nullptr, values[i]};
+                ArrowArray &child = array_data->children[i];
+                child = ArrowArray{};
+                child.length = static_cast<int64_t>(length);
+                child.n_buffers = 2;
+                child.buffers = array_data->buffers[i].data();
+                child.release = release_arrow_child_array;
+                array_data->child_pointers.emplace_back(&child);
+                schema_data->names.emplace_back(columns[i].name);
+            }
+            for (size_t i = 0; i < n_columns; ++i) {
+                ArrowSchema &child = schema_data->children[i];
+                child = ArrowSchema{};
+                child.format = columns[i].format;
+                child.name = schema_data->names[i].c_str();
+                child.release = release_arrow_child_schema;
+                schema_data->child_pointers.emplace_back(&child);
+            }
+
+            *out_schema = ArrowSchema{};
+            out_schema->format = "+s";
+            out_schema->name = "";
+            out_schema->n_children = static_cast<int64_t>(n_columns);
+            out_schema->children = schema_data->child_pointers.data();
+            out_schema->release = release_arrow_schema;
+            out_schema->private_data = schema_data.release();
+
+            *out_array = ArrowArray{};
+            out_array->length = static_cast<int64_t>(length);
+            out_array->n_buffers = 1;
+            out_array->buffers = &array_data->struct_buffer;
+            out_array->n_children = static_cast<int64_t>(n_columns);
+            out_array->children = array_data->child_pointers.data();
+            out_array->release = release_arrow_array;
+            out_array->private_data = array_data.release();
+            return values;
+        }
+
+        /// \brief Export elements column by column
+        /// \param for_each_element Calls write(element, rank) for each
+        /// element of the container
+        /// \param with_ranks Whether to export the ranks
+        template <class Container, class ForEachElement>
+        void export_arrow(const Container &c, size_t dimensions,
+                          ForEachElement for_each_element, bool with_ranks,
+                          ArrowArray *out_array, ArrowSchema *out_schema) {
+            using dimension_type = typename Container::dimension_type;
+            using mapped_type = typename Container::mapped_type;
+            static_assert(arrow_format<dimension_type>() != nullptr,
+                          "Arrow has no format for this number type");
+            constexpr bool with_ids = arrow_format<mapped_type>() != nullptr;
+            std::vector<arrow_column_spec> columns;
+            for (size_t j = 0; j < dimensions; ++j) {
+                columns.push_back({"x" + std::to_string(j),
+                                   arrow_format<dimension_type>(),
+                                   sizeof(dimension_type)});
+            }
+            if constexpr (with_ids) {
+                columns.push_back(
+                    {"id", arrow_format<mapped_type>(), sizeof(mapped_type)});
+            }
+            if (with_ranks) {
+                columns.push_back({"rank", "L", sizeof(uint64_t)});
+            }
+            std::vector<char *> values =
+                make_arrow_export(columns, c.size(), out_array, out_schema);
+
+            // one pass over the container writes all columns
+            std::vector<dimension_type *> objectives(dimensions);
+            for (size_t j = 0; j < dimensions; ++j) {
+                objectives[j] = reinterpret_cast<dimension_type *>(values[j]);
+            }
+            auto *ids = reinterpret_cast<mapped_type *>(
+                with_ids ? values[dimensions] : nullptr);
+            auto *ranks = reinterpret_cast<uint64_t *>(
+                with_ranks ? values.back() : nullptr);
+            size_t i = 0;
+            for_each_element(c, [&](const auto &v, size_t rank) {
+                for (size_t j = 0; j < dimensions; ++j) {
+                    objectives[j][i] = v.first[j];
+                }
+                if constexpr (with_ids) {
+                    ids[i] = v.second;
+                }
+                if (ranks != nullptr) {
+                    ranks[i] = rank;
+                }
+                ++i;
+            });
+        }
+    } // namespace detail
+
+    /// \brief Bulk load the rows of an Arrow struct array into a front
+    /// The columns are read directly by the bulk constructor of the
+    /// container. Rows dominated by other rows or by the front are not
+    /// inserted.
+    /// \see arrow_rows for the expected columns
+    /// \return Number of rows inserted
+    template <class K, size_t M, class T, class Container>
+    size_t import_arrow(front<K, M, T, Container> &pf, const ArrowArray &array,
+                        const ArrowSchema &schema) {
+        arrow_rows<K, M, T> rows(array, schema);
+        return pf.bulk_insert(rows.begin(), rows.end());
+    }
+
+    /// \brief Insert the rows of an Arrow struct array into an archive
+    /// \see arrow_rows for the expected columns
+    template <class K, size_t M, class T, class Container>
+    void import_arrow(archive<K, M, T, Container> &ar, const ArrowArray &array,
+                      const ArrowSchema &schema) {
+        arrow_rows<K, M, T> rows(array, schema);
+        ar.insert(rows.begin(), rows.end());
+    }
+
+    /// \brief Export a front as an Arrow struct array
+    /// The array has one column "x<i>" per objective and a column "id"
+    /// with the mapped values, if Arrow has a format for them. The
+    /// columns are written in one pass without creating the rows.
+    /// The consumer becomes responsible for calling the release
+    /// callbacks of the array and the schema.
+    template <class K, size_t M, class T, class Container>
+    void export_arrow(const front<K, M, T, Container> &pf, ArrowArray *out_array,
+                      ArrowSchema *out_schema) {
+        detail::export_arrow(
+            pf, pf.dimensions(),
+            [](const auto &f, auto &&write) {
+                for (const auto &v : f) {
+                    write(v, 0);
+                }
+            },
+            false, out_array, out_schema);
+    }
+
+    /// \brief Export an archive as an Arrow struct array
+    /// Besides the columns of a front, the array has a column "rank"
+    /// with the index of the front of each element.
+    template <class K, size_t M, class T, class Container>
+    void export_arrow(const archive<K, M, T, Container> &ar, ArrowArray *out_array,
+                      ArrowSchema *out_schema) {
+        detail::export_arrow(
+            ar, ar.dimensions(),
+            [](const auto &a, auto &&write) {
+                size_t rank = 0;
+                for (auto it = a.begin_front(); it != a.end_front(); ++it) {
+                    for (const auto &v : *it) {
+                        write(v, rank);
+                    }
+                    ++rank;
+                }
+            },
+            true, out_array, out_schema);
+    }
+} // namespace pareto
+
+#endif // PARETO_ARROW_H
@@ -0,0 +1,155 @@
+#ifndef PARETO_CHANGE_LOG_H
+#define PARETO_CHANGE_LOG_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+
+namespace pareto {
+    /// \brief Kinds of changes in a front or archive
+    enum class change_type : uint8_t {
+        /// An element was inserted at a rank
+        insert,
+        /// An element was removed from a rank (erased, evicted or pruned)
+        erase,
+        /// An element moved from one archive rank to another
+        move,
+        /// A new archive front was created at a rank
+        /// All fronts from this rank on move one rank down
+        insert_front,
+        /// An empty archive front was removed from a rank
+        /// All fronts after this rank move one rank up
+        erase_front,
+        /// All elements were removed
+        clear
+    };
+
+    /// \brief One change in a front or archive
+    template <class Key> struct change {
+        /// Sequence number of the change in its log
+        uint64_t sequence{0};
+        /// Kind of change
+        change_type type{change_type::insert};
+        /// Element key (empty for front and clear events)
+        Key key{};
+        /// Rank of the element after the change or rank of the front
+        /// Elements of a front always have rank 0
+        size_t rank{0};
+        /// Rank of the element before a move
+        size_t previous_rank{0};
+    };
+
+    /// \class Change log for fronts and archives
+    /// Consumers such as plots, persistence layers, or replicas in
+    /// other processes usually iterate the whole front after each
+    /// generation to find out what changed. A front or archive with
+    /// an attached change log records each modification instead, so
+    /// consumers only process O(changes) per generation.
+    ///
+    /// The log is a feed of changes with increasing sequence numbers.
+    /// Each consumer remembers the last sequence number it processed
+    /// and asks for the changes after it. Changes that all consumers
+    /// processed can be trimmed from the log. If a callback is set,
+    /// it is called for each change as it happens, and the log can
+    /// be told not to keep the changes at all.
+    ///
+    /// The log does not own the container. The container must be
+    /// detached before the log is destroyed.
+    template <class Key> class change_log {
+      public:
+        using key_type = Key;
+        using value_type = change<Key>;
+        using container_type = std::deque<value_type>;
+        using const_iterator = typename container_type::const_iterator;
+        using callback_type = std::function<void(const value_type &)>;
+
+      public /* Constructors */:
+        /// \brief Create a log that keeps the changes
+        change_log() = default;
+
+        /// \brief Create a log that calls callback for each change
+        /// \param keep_changes Also keep the changes in the feed
+        explicit change_log(callback_type callback, bool keep_changes = false)
+            : callback_(std::move(callback)), keep_changes_(keep_changes) {}
+
+      public /* Feed */:
+        const_iterator begin() const noexcept { return changes_.begin(); }
+
+        const_iterator end() const noexcept { return changes_.end(); }
+
+        /// \brief Number of changes kept in the feed
+        [[nodiscard]] size_t size() const noexcept { return changes_.size(); }
+
+        [[nodiscard]] bool empty() const noexcept { return changes_.empty(); }
+
+        /// \brief Sequence number the next change will get
+        [[nodiscard]] uint64_t next_sequence() const noexcept {
+            return next_sequence_;
+        }
+
+        /// \brief First change with sequence number >= sequence
+        /// Changes have consecutive sequence numbers, so this is O(1).
+        const_iterator since(uint64_t sequence) const noexcept {
+            if (changes_.empty() || sequence <= changes_.front().sequence) {
+                return changes_.begin();
+            }
+            const uint64_t offset = sequence - changes_.front().sequence;
+            if (offset >= changes_.size()) {
+                return changes_.end();
+            }
+            return changes_.begin() +
+                   static_cast<typename container_type::difference_type>(
+                       offset);
+        }
+
+        /// \brief Remove changes with sequence number < sequence
+        /// Call this after all consumers processed these changes.
+        void trim(uint64_t sequence) {
+            while (!changes_.empty() && changes_.front().sequence < sequence) {
+                changes_.pop_front();
+            }
+        }
+
+        /// \brief Remove all changes from the feed
+        /// Sequence numbers are not reset.
+        void clear() noexcept { changes_.clear(); }
+
+      public /* Recording */:
+        /// \brief Record a change
+        /// This is called by the containers.
+        void record(change_type type, const key_type &key = key_type{},
+                    size_t rank = 0, size_t previous_rank = 0) {
+            value_type c{next_sequence_++, type, key, rank, previous_rank};
+            if (callback_) {
+                callback_(c);
+            }
+            if (keep_changes_) {
+                changes_.emplace_back(std::move(c));
+            }
+        }
+
+        /// \brief Set the function called for each change
+        void set_callback(callback_type callback) {
+            callback_ = std::move(callback);
+        }
+
+        /// \brief Set whether changes are kept in the feed
+        void keep_changes(bool keep) noexcept { keep_changes_ = keep; }
+
+      private:
+        /// \brief Changes not trimmed yet
+        container_type changes_;
+
+        /// \brief Sequence number of the next change
+        uint64_t next_sequence_{0};
+
+        /// \brief Function called for each change
+        callback_type callback_;
+
+        /// \brief Whether changes are kept in the feed
+        bool keep_changes_{true};
+    };
+} // namespace pareto
+
+#endif // PARETO_CHANGE_LOG_H
@@ -6,7 +6,10 @@
 #define PARETO_FRONT_COMMON_H
 
 #include <pareto/common/metaprogramming.h>
+#include <pareto/common/no_value.h>
 #include <pareto/common/operators.h>
+#include <pareto/common/tracing.h>
+#include <pareto/common/work_stats.h>
 
 namespace pareto {
     /// \brief Convert an initializer list to a vector
@@ -6,6 +6,7 @@
 #define PARETO_DEFAULT_ALLOCATOR_H
 
 #include <iostream>
+#include <pareto/common/numa.h>
 #ifdef BUILD_PARETO_WITH_PMR
 #include <memory>
 #include <memory_resource>
@@ -89,17 +90,26 @@ namespace pareto {
     /// at construction, then we will create a default allocator which
     /// uses this pool (if PMR is available). This is important in spatial
     /// containers to avoid one allocation per node.
+    ///
+    /// If the thread constructing the container has a NUMA node hint
+    /// (see numa_node_guard), the pool takes its pages from that node.
+    /// The hint only applies to this pool, so containers constructed
+    /// with std::allocator, or without PMR, get no placement at all.
+    /// The pool moves with the container, so moved containers keep
+    /// their nodes valid.
     class container_with_pool {
       public:
 #ifdef BUILD_PARETO_WITH_PMR
         /// \brief Create the allocator for the container
         /// This is only used as default allocator, if no allocator
-        /// is provided.
+        /// is provided. Containers that call this more than once
+        /// share the same pool.
         template <class ALLOC> ALLOC construct_allocator(const ALLOC& alloc) {
             if constexpr (is_polymorphic_allocator<ALLOC>::value) {
                 if (is_placeholder_allocator(alloc)) {
-                    memory_pool_ =
-                        std::make_unique<std::pmr::unsynchronized_pool_resource>();
+                    if (!memory_pool_) {
+                        create_memory_pool();
+                    }
                     return ALLOC(memory_pool_.get());
                 }
                 return ALLOC(alloc);
@@ -108,12 +118,42 @@ namespace pareto {
             }
         }
 
+        /// \brief NUMA node of the memory pool or -1 if not bound
+        [[nodiscard]] int memory_pool_numa_node() const noexcept {
+            return numa_resource_ ? numa_resource_->node() : -1;
+        }
+
+      private:
+        void create_memory_pool() {
+            const int node = thread_numa_node_hint();
+            if (node >= 0) {
+                numa_resource_ = std::make_unique<numa_memory_resource>(node);
+                memory_pool_ =
+                    std::make_unique<std::pmr::unsynchronized_pool_resource>(
+                        numa_resource_.get());
+            } else {
+                memory_pool_ =
+                    std::make_unique<std::pmr::unsynchronized_pool_resource>();
+            }
+        }
+
+      public:
+        /// The upstream resource has to outlive the pool
+        std::unique_ptr<numa_memory_resource> numa_resource_{nullptr};
         std::unique_ptr<std::pmr::unsynchronized_pool_resource> memory_pool_{
             nullptr};
 #else
         template <class ALLOC> ALLOC construct_allocator(const ALLOC& alloc) {
             return ALLOC(alloc);
         }
+
+        /// \brief NUMA node of the memory pool or -1 if not bound
+        /// Without PMR, containers have no pools, so the NUMA node hint
+        /// is ignored and nodes are placed on the node of the thread
+        /// that touches them first.
+        [[nodiscard]] int memory_pool_numa_node() const noexcept {
+            return -1;
+        }
 #endif
     };
 
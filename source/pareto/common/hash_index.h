@@ -0,0 +1,79 @@
+#ifndef PARETO_HASH_INDEX_H
+#define PARETO_HASH_INDEX_H
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+
+namespace pareto {
+    /// \class Hash index from keys to the nodes that hold them
+    /// Spatial containers answer exact lookups with a box query whose lower
+    /// and upper bounds are the key. That is O(log n) at best and it has
+    /// to look at every node whose box contains the key.
+    ///
+    /// Containers that keep one element per node can keep this index
+    /// next to their tree, so that find, count, contains and erase by key
+    /// take O(1) expected time. The container is responsible for
+    /// keeping the index in sync whenever a node gets or loses an element.
+    ///
+    /// \tparam Key Key type. It needs std::hash and operator==.
+    /// \tparam Handle Pointer to the node holding the element
+    template <class Key, class Handle> class hash_index {
+      private:
+        using map_type = std::unordered_multimap<Key, Handle, std::hash<Key>>;
+
+      public:
+        using size_type = typename map_type::size_type;
+
+      public /* Modifiers */:
+        /// \brief Record that a node holds a key
+        void insert(const Key &k, Handle h) { map_.emplace(k, h); }
+
+        /// \brief Record that a node does not hold a key anymore
+        /// Nothing happens if the node was not recorded with this key.
+        void erase(const Key &k, Handle h) {
+            auto [first, last] = map_.equal_range(k);
+            for (; first != last; ++first) {
+                if (first->second == h) {
+                    map_.erase(first);
+                    return;
+                }
+            }
+        }
+
+        /// \brief Record that the element with a key moved to another node
+        void relocate(const Key &k, Handle from, Handle to) {
+            auto [first, last] = map_.equal_range(k);
+            for (; first != last; ++first) {
+                if (first->second == from) {
+                    first->second = to;
+                    return;
+                }
+            }
+        }
+
+        /// \brief Remove all keys
+        void clear() noexcept { map_.clear(); }
+
+        /// \brief Reserve space for n keys
+        void reserve(size_type n) { map_.reserve(n); }
+
+      public /* Lookup */:
+        /// \brief Any node holding the key or nullptr
+        Handle find(const Key &k) const {
+            auto it = map_.find(k);
+            return it != map_.end() ? it->second : nullptr;
+        }
+
+        /// \brief Number of nodes holding the key
+        size_type count(const Key &k) const { return map_.count(k); }
+
+        /// \brief Number of keys in the index
+        [[nodiscard]] size_type size() const noexcept { return map_.size(); }
+
+      private:
+        map_type map_;
+    };
+} // namespace pareto
+
+#endif // PARETO_HASH_INDEX_H
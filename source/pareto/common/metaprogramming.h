@@ -6,6 +6,10 @@
 #define PARETO_METAPROGRAMMING_H
 
 #include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <pareto/common/no_value.h>
 
 namespace pareto {
 
@@ -29,6 +33,31 @@ namespace pareto {
         copy_pack(begin, ks...);
     }
 
+    /// \brief Check if a container is a view of memory owned by someone else
+    /// The iterators of views own the element they point to, so adaptors
+    /// cannot return references to elements from iterators.
+    template <class C, class = void>
+    struct is_view_container : std::false_type {};
+
+    template <class C>
+    struct is_view_container<C, std::void_t<decltype(C::is_view)>>
+        : std::bool_constant<C::is_view> {};
+
+    template <class C>
+    constexpr bool is_view_container_v = is_view_container<C>::value;
+
+    /// \brief Check if a container can keep a hash index for exact lookups
+    template <class C, class = void>
+    struct supports_hash_index : std::false_type {};
+
+    template <class C>
+    struct supports_hash_index<
+        C, std::void_t<decltype(std::declval<C &>().enable_hash_index())>>
+        : std::true_type {};
+
+    template <class C>
+    constexpr bool supports_hash_index_v = supports_hash_index<C>::value;
+
     /// \brief Resize if vector, not resize if array
     template <typename T>
     void maybe_resize(T& v, size_t n);
@@ -122,6 +151,26 @@ namespace pareto {
         return cr;
     }
 
+    template <class K>
+    key_only_pair<std::add_const_t<K>>& protect_pair_key(key_only_pair<K>& r) {
+        return *reinterpret_cast<key_only_pair<std::add_const_t<K>> *>(&r);
+    }
+
+    template <class K>
+    const key_only_pair<std::add_const_t<K>>& protect_pair_key(const key_only_pair<K>& r) {
+        return *reinterpret_cast<const key_only_pair<std::add_const_t<K>> *>(&r);
+    }
+
+    template <class K>
+    key_only_pair<std::remove_const_t<K>>& unprotect_pair_key(key_only_pair<K>& r) {
+        return *reinterpret_cast<key_only_pair<std::remove_const_t<K>> *>(&r);
+    }
+
+    template <class K>
+    const key_only_pair<std::remove_const_t<K>>& unprotect_pair_key(const key_only_pair<K>& r) {
+        return *reinterpret_cast<const key_only_pair<std::remove_const_t<K>> *>(&r);
+    }
+
     template <class T1>
     std::remove_const_t<T1>& unconst_reference(T1& r) {
         return const_cast<std::remove_const_t<T1>&>(r);
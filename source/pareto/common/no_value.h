@@ -0,0 +1,147 @@
+#ifndef PARETO_NO_VALUE_H
+#define PARETO_NO_VALUE_H
+
+#include <cstddef>
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace pareto {
+    /// \brief Mapped type of containers that only store keys
+    /// This is the mapped type of front_set and archive_set. The adaptors
+    /// accept keys wherever they would accept elements with this type.
+    struct no_value {};
+
+    /// \brief All empty values are equal
+    constexpr bool operator==(no_value, no_value) noexcept { return true; }
+
+    /// \brief All empty values are equal
+    constexpr bool operator!=(no_value, no_value) noexcept { return false; }
+
+    /// \brief Print an empty value
+    inline std::ostream &operator<<(std::ostream &os, no_value) {
+        return os << "{}";
+    }
+
+    /// \brief Whether a mapped type means the container only stores keys
+    template <class T>
+    constexpr bool is_key_only_v = std::is_same_v<T, no_value>;
+
+    /// \brief Element of containers that only store keys
+    /// A std::pair<K, no_value> still spends a byte on the empty value,
+    /// and that byte is padded to the alignment of the key. This pair
+    /// only stores the key. The empty value is a static member, so
+    /// elements still have the "first" and "second" members and can be
+    /// unpacked with structured bindings like a std::pair.
+    template <class K> struct key_only_pair {
+        using first_type = K;
+        using second_type = no_value;
+
+        key_only_pair() = default;
+
+        key_only_pair(const key_only_pair &) = default;
+
+        key_only_pair(key_only_pair &&) noexcept = default;
+
+        explicit key_only_pair(const K &k) : first(k) {}
+
+        key_only_pair(const K &k, no_value) : first(k) {}
+
+        /// \brief Convert from pairs with convertible keys
+        template <class K2, class = std::enable_if_t<
+                                std::is_constructible_v<K, const K2 &>>>
+        // NOLINTNEXTLINE(google-explicit-constructor)
+        key_only_pair(const key_only_pair<K2> &rhs) : first(rhs.first) {}
+
+        /// \brief Convert from std::pair with an empty value
+        template <class K2, class = std::enable_if_t<
+                                std::is_constructible_v<K, const K2 &>>>
+        // NOLINTNEXTLINE(google-explicit-constructor)
+        key_only_pair(const std::pair<K2, no_value> &rhs) : first(rhs.first) {}
+
+        template <class K2, class = std::enable_if_t<
+                                std::is_constructible_v<K, K2 &&>>>
+        // NOLINTNEXTLINE(google-explicit-constructor)
+        key_only_pair(std::pair<K2, no_value> &&rhs)
+            : first(std::move(rhs.first)) {}
+
+        key_only_pair &operator=(const key_only_pair &) = default;
+
+        key_only_pair &operator=(key_only_pair &&) noexcept = default;
+
+        /// \brief Convert to std::pair
+        template <class K2, class = std::enable_if_t<
+                                std::is_constructible_v<K2, const K &>>>
+        // NOLINTNEXTLINE(google-explicit-constructor)
+        operator std::pair<K2, no_value>() const {
+            return std::pair<K2, no_value>(first, no_value{});
+        }
+
+        K first;
+        static inline no_value second{};
+    };
+
+    template <class K1, class K2>
+    bool operator==(const key_only_pair<K1> &lhs,
+                    const key_only_pair<K2> &rhs) {
+        return lhs.first == rhs.first;
+    }
+
+    template <class K1, class K2>
+    bool operator!=(const key_only_pair<K1> &lhs,
+                    const key_only_pair<K2> &rhs) {
+        return !(lhs == rhs);
+    }
+
+    template <class K1, class K2>
+    bool operator<(const key_only_pair<K1> &lhs,
+                   const key_only_pair<K2> &rhs) {
+        return lhs.first < rhs.first;
+    }
+
+    /// \brief Get the key or the empty value
+    template <size_t I, class K>
+    std::conditional_t<I == 0, K, no_value> &get(key_only_pair<K> &p) {
+        static_assert(I < 2);
+        if constexpr (I == 0) {
+            return p.first;
+        } else {
+            return p.second;
+        }
+    }
+
+    /// \brief Get the key or the empty value
+    template <size_t I, class K>
+    const std::conditional_t<I == 0, K, no_value> &
+    get(const key_only_pair<K> &p) {
+        static_assert(I < 2);
+        if constexpr (I == 0) {
+            return p.first;
+        } else {
+            return p.second;
+        }
+    }
+
+    /// \brief Element type of the containers
+    /// Containers that only store keys store key_only_pair elements.
+    template <class K, class T>
+    using element_pair_t =
+        std::conditional_t<is_key_only_v<T>, key_only_pair<K>, std::pair<K, T>>;
+} // namespace pareto
+
+namespace std {
+    template <class K>
+    struct tuple_size<pareto::key_only_pair<K>>
+        : std::integral_constant<size_t, 2> {};
+
+    template <class K> struct tuple_element<0, pareto::key_only_pair<K>> {
+        using type = K;
+    };
+
+    template <class K> struct tuple_element<1, pareto::key_only_pair<K>> {
+        using type = pareto::no_value;
+    };
+} // namespace std
+
+#endif // PARETO_NO_VALUE_H
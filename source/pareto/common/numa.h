@@ -0,0 +1,195 @@
+#ifndef PARETO_NUMA_H
+#define PARETO_NUMA_H
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+#ifdef BUILD_PARETO_WITH_PMR
+#include <memory_resource>
+#endif
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace pareto {
+    /// \brief Number of NUMA nodes in this machine
+    /// This is 1 if the platform does not tell us about its nodes.
+    inline size_t number_of_numa_nodes() {
+#if defined(__linux__)
+        // The online node list looks like "0" or "0-1" or "0,2-3"
+        std::ifstream online("/sys/devices/system/node/online");
+        std::string nodes;
+        if (online >> nodes) {
+            const size_t last_separator = nodes.find_last_of("-,");
+            const std::string last_node =
+                last_separator == std::string::npos
+                    ? nodes
+                    : nodes.substr(last_separator + 1);
+            try {
+                return static_cast<size_t>(std::stoul(last_node)) + 1;
+            } catch (const std::exception &) {
+                return 1;
+            }
+        }
+#endif
+        return 1;
+    }
+
+    /// \brief NUMA node of the CPU running the calling thread
+    /// This is 0 if the platform does not tell us about its nodes.
+    inline int current_numa_node() {
+#if defined(__linux__) && defined(SYS_getcpu)
+        unsigned cpu = 0;
+        unsigned node = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+            return static_cast<int>(node);
+        }
+#endif
+        return 0;
+    }
+
+    /// \brief NUMA node hint for the memory pools created by this thread
+    /// Containers that create their own memory pool take its memory from
+    /// this node. A negative node means no hint, in which case the
+    /// operating system places pages on the node of the thread that
+    /// touches them first.
+    ///
+    /// Only containers with polymorphic allocators create memory pools,
+    /// so the hint needs BUILD_PARETO_WITH_PMR and the default
+    /// allocators. Containers with std::allocator or any other
+    /// allocator ignore the hint and get first-touch placement.
+    inline int &thread_numa_node_hint() {
+        thread_local int node = -1;
+        return node;
+    }
+
+    /// \brief Set the NUMA node hint of this thread while in scope
+    class numa_node_guard {
+      public:
+        explicit numa_node_guard(int node)
+            : previous_node_(thread_numa_node_hint()) {
+            thread_numa_node_hint() = node;
+        }
+
+        numa_node_guard(const numa_node_guard &) = delete;
+
+        numa_node_guard &operator=(const numa_node_guard &) = delete;
+
+        ~numa_node_guard() { thread_numa_node_hint() = previous_node_; }
+
+      private:
+        int previous_node_;
+    };
+
+    /// \brief Ask the operating system to place a memory range on a node
+    /// The range should be page aligned. This calls mbind with a
+    /// preferred policy, so the pages still go somewhere else if the
+    /// node is out of memory. A policy only places the pages touched
+    /// after it, so we also ask mbind to move the pages that were
+    /// already touched. Moving only works for pages no other process
+    /// maps, and is slow, so bind ranges before touching them when you
+    /// can. We call the system call directly so there is no dependency
+    /// on libnuma.
+    /// \return True if the policy was applied
+    inline bool bind_to_numa_node([[maybe_unused]] void *p,
+                                  [[maybe_unused]] size_t bytes,
+                                  [[maybe_unused]] int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+        if (node < 0) {
+            return false;
+        }
+        constexpr int mpol_preferred = 1;
+        constexpr unsigned mpol_mf_move = 1u << 1;
+        constexpr size_t bits_per_word = sizeof(unsigned long) * CHAR_BIT;
+        const size_t n = static_cast<size_t>(node);
+        std::vector<unsigned long> mask(n / bits_per_word + 1, 0);
+        mask[n / bits_per_word] |= 1ul << (n % bits_per_word);
+        const unsigned long max_node = mask.size() * bits_per_word + 1;
+        return syscall(SYS_mbind, p, bytes, mpol_preferred, mask.data(),
+                       max_node, mpol_mf_move) == 0;
+#else
+        return false;
+#endif
+    }
+
+    /// \brief Size of a memory page
+    inline size_t memory_page_size() {
+#if defined(__linux__)
+        const long page_size = sysconf(_SC_PAGESIZE);
+        if (page_size > 0) {
+            return static_cast<size_t>(page_size);
+        }
+#endif
+        return 4096;
+    }
+
+#ifdef BUILD_PARETO_WITH_PMR
+    /// \brief Memory resource whose pages are placed on a NUMA node
+    /// This is meant as the upstream resource of a memory pool: every
+    /// request is rounded up to whole pages, which are bound to the
+    /// node before anyone touches them. On Linux, the pages come
+    /// straight from mmap, because memory from operator new might
+    /// have been touched by an earlier allocation.
+    class numa_memory_resource : public std::pmr::memory_resource {
+      public:
+        explicit numa_memory_resource(int node)
+            : node_(node), page_size_(memory_page_size()) {}
+
+        /// \brief Node where this resource places its pages
+        [[nodiscard]] int node() const noexcept { return node_; }
+
+      private:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+            const size_t rounded = round_to_pages(bytes);
+#if defined(__linux__)
+            if (alignment <= page_size_) {
+                void *p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (p == MAP_FAILED) {
+                    throw std::bad_alloc();
+                }
+                bind_to_numa_node(p, rounded, node_);
+                return p;
+            }
+#endif
+            const std::align_val_t a{std::max(alignment, page_size_)};
+            void *p = ::operator new(rounded, a);
+            bind_to_numa_node(p, rounded, node_);
+            return p;
+        }
+
+        void do_deallocate(void *p, std::size_t bytes,
+                           std::size_t alignment) override {
+#if defined(__linux__)
+            if (alignment <= page_size_) {
+                munmap(p, round_to_pages(bytes));
+                return;
+            }
+#endif
+            const std::align_val_t a{std::max(alignment, page_size_)};
+            ::operator delete(p, round_to_pages(bytes), a);
+        }
+
+        [[nodiscard]] bool
+        do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+
+        [[nodiscard]] size_t round_to_pages(size_t bytes) const {
+            return (std::max(bytes, size_t{1}) + page_size_ - 1) /
+                   page_size_ * page_size_;
+        }
+
+        int node_;
+        size_t page_size_;
+    };
+#endif
+} // namespace pareto
+
+#endif // PARETO_NUMA_H
@@ -0,0 +1,176 @@
+#ifndef PARETO_PARALLEL_H
+#define PARETO_PARALLEL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pareto {
+    /// \brief Number of threads we use by default for parallel algorithms
+    inline size_t default_number_of_threads() {
+        return std::max(static_cast<size_t>(std::thread::hardware_concurrency()),
+                        size_t{1});
+    }
+
+    /// \brief Persistent worker threads for parallel algorithms
+    /// Starting and joining a thread costs much more than most tasks we
+    /// run in parallel, such as a query on one shard. The workers of a
+    /// pool are started once and wait for tasks between calls. The pool
+    /// grows when a call asks for more workers than it has, so callers
+    /// can use more threads than the hardware has.
+    class thread_pool {
+      public:
+        thread_pool() = default;
+
+        thread_pool(const thread_pool &) = delete;
+
+        thread_pool &operator=(const thread_pool &) = delete;
+
+        ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            has_tasks_.notify_all();
+            for (std::thread &t : workers_) {
+                t.join();
+            }
+        }
+
+        /// \brief Number of worker threads
+        [[nodiscard]] size_t size() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return workers_.size();
+        }
+
+        /// \brief Start workers until the pool has at least n of them
+        void reserve(size_t n) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            while (workers_.size() < n) {
+                workers_.emplace_back([this]() { work(); });
+            }
+        }
+
+        /// \brief Run a task in one of the workers
+        void submit(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                tasks_.emplace_back(std::move(task));
+            }
+            has_tasks_.notify_one();
+        }
+
+        /// \brief True if the calling thread is a worker of a pool
+        /// Tasks that run parallel algorithms run them serially, so
+        /// that workers never wait for each other.
+        [[nodiscard]] static bool is_worker_thread() {
+            return worker_flag();
+        }
+
+      private:
+        static bool &worker_flag() {
+            thread_local bool is_worker = false;
+            return is_worker;
+        }
+
+        void work() {
+            worker_flag() = true;
+            for (;;) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    has_tasks_.wait(
+                        lock, [this]() { return stopping_ || !tasks_.empty(); });
+                    if (tasks_.empty()) {
+                        return;
+                    }
+                    task = std::move(tasks_.front());
+                    tasks_.pop_front();
+                }
+                task();
+            }
+        }
+
+        mutable std::mutex mutex_;
+        std::condition_variable has_tasks_;
+        std::deque<std::function<void()>> tasks_;
+        std::vector<std::thread> workers_;
+        bool stopping_{false};
+    };
+
+    /// \brief Pool shared by all parallel algorithms
+    inline thread_pool &default_thread_pool() {
+        static thread_pool pool;
+        return pool;
+    }
+
+    /// \brief Run f(0), f(1), ..., f(n-1) in parallel
+    /// The tasks are split into contiguous blocks, one block per
+    /// thread. The calling thread runs the first block and the workers
+    /// of the default thread pool run the others. If any task throws,
+    /// the first exception is rethrown after all blocks are finished.
+    /// Calls from inside a pool worker run serially.
+    /// \param n Number of tasks
+    /// \param f Function receiving the task index
+    /// \param max_threads Maximum number of threads, including the caller
+    template <class F>
+    void parallel_for(size_t n, F f,
+                      size_t max_threads = default_number_of_threads()) {
+        const size_t n_threads = std::min(n, std::max(max_threads, size_t{1}));
+        if (n_threads <= 1 || thread_pool::is_worker_thread()) {
+            for (size_t i = 0; i < n; ++i) {
+                f(i);
+            }
+            return;
+        }
+
+        std::exception_ptr first_exception = nullptr;
+        std::mutex exception_mutex;
+        auto run_block = [&](size_t t) {
+            try {
+                const size_t first = t * n / n_threads;
+                const size_t last = (t + 1) * n / n_threads;
+                for (size_t i = first; i < last; ++i) {
+                    f(i);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(exception_mutex);
+                if (!first_exception) {
+                    first_exception = std::current_exception();
+                }
+            }
+        };
+
+        // workers notify while holding the lock, so the caller cannot
+        // destroy the condition variable before they are done with it
+        std::mutex done_mutex;
+        std::condition_variable done;
+        size_t remaining = n_threads - 1;
+        thread_pool &pool = default_thread_pool();
+        pool.reserve(n_threads - 1);
+        for (size_t t = 1; t < n_threads; ++t) {
+            pool.submit([&, t]() {
+                run_block(t);
+                std::lock_guard<std::mutex> lock(done_mutex);
+                if (--remaining == 0) {
+                    done.notify_one();
+                }
+            });
+        }
+        run_block(0);
+        {
+            std::unique_lock<std::mutex> lock(done_mutex);
+            done.wait(lock, [&]() { return remaining == 0; });
+        }
+        if (first_exception) {
+            std::rethrow_exception(first_exception);
+        }
+    }
+} // namespace pareto
+
+#endif // PARETO_PARALLEL_H
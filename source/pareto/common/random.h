@@ -0,0 +1,117 @@
+#ifndef PARETO_RANDOM_H
+#define PARETO_RANDOM_H
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace pareto {
+    /// \brief Counter-based random number generator
+    /// The n-th number of a stream is a hash of the key of the stream
+    /// and n, so generators are cheap to create and copy (two words),
+    /// discard is O(1), and split(i) derives independent streams that
+    /// threads can use without sharing any state. Parallel algorithms
+    /// split the generator by task, not by thread, so the same seed gives
+    /// the same results for any number of threads.
+    ///
+    /// The hash is the SplitMix64 finalizer, which is good enough for
+    /// Monte-Carlo estimates and random pruning. This class models
+    /// UniformRandomBitGenerator, so it works with the distributions
+    /// in <random>.
+    class counter_generator {
+      public:
+        using result_type = uint64_t;
+
+        /// \brief Seed used by default-constructed generators
+        static constexpr result_type default_seed = 0x5eed5eed5eed5eedULL;
+
+        /// \brief Create a generator with the default seed
+        counter_generator() noexcept : counter_generator(default_seed) {}
+
+        /// \brief Create a generator with a seed
+        explicit counter_generator(result_type s) noexcept { seed(s); }
+
+        /// \brief Restart the generator with a seed
+        void seed(result_type s) noexcept {
+            key_ = mix(s);
+            counter_ = 0;
+        }
+
+        /// \brief Next number in the stream
+        result_type operator()() noexcept {
+            return mix(key_ + golden_gamma * ++counter_);
+        }
+
+        /// \brief Skip the next n numbers in the stream
+        void discard(unsigned long long n) noexcept { counter_ += n; }
+
+        /// \brief Independent stream for task i
+        /// The stream does not depend on the position of this generator,
+        /// only on its seed and i.
+        [[nodiscard]] counter_generator split(uint64_t i) const noexcept {
+            counter_generator g;
+            g.key_ = mix(key_ ^ mix(i + golden_gamma));
+            g.counter_ = 0;
+            return g;
+        }
+
+        static constexpr result_type min() noexcept { return 0; }
+
+        static constexpr result_type max() noexcept {
+            return std::numeric_limits<result_type>::max();
+        }
+
+        bool operator==(const counter_generator &rhs) const noexcept {
+            return key_ == rhs.key_ && counter_ == rhs.counter_;
+        }
+
+        bool operator!=(const counter_generator &rhs) const noexcept {
+            return !(*this == rhs);
+        }
+
+      private:
+        static constexpr result_type golden_gamma = 0x9e3779b97f4a7c15ULL;
+
+        static constexpr result_type mix(result_type z) noexcept {
+            z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27U)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31U);
+        }
+
+        result_type key_{0};
+        result_type counter_{0};
+    };
+
+    /// \brief Index of the next stream a container splits from its generator
+    /// Const randomized algorithms cannot advance the generator of the
+    /// container, so each call takes the stream generator.split(next())
+    /// instead. Concurrent calls take different streams. Copies start
+    /// from the same index, so a copy of a container gives the same
+    /// sequence of results as the original.
+    class stream_counter {
+      public:
+        stream_counter() noexcept = default;
+
+        stream_counter(const stream_counter &rhs) noexcept
+            : next_(rhs.next_.load(std::memory_order_relaxed)) {}
+
+        stream_counter &operator=(const stream_counter &rhs) noexcept {
+            next_.store(rhs.next_.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+            return *this;
+        }
+
+        /// \brief Take the index of a new stream
+        uint64_t next() noexcept {
+            return next_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /// \brief Start again from the first stream
+        void reset() noexcept { next_.store(0, std::memory_order_relaxed); }
+
+      private:
+        std::atomic<uint64_t> next_{0};
+    };
+} // namespace pareto
+
+#endif // PARETO_RANDOM_H
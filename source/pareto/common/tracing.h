@@ -0,0 +1,364 @@
+#ifndef PARETO_TRACING_H
+#define PARETO_TRACING_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+
+/// Tracing hooks for the latency of individual operations
+/// Work counters tell us how much work an operation did. Tracing hooks
+/// tell us how long it took. If the library is built with
+/// BUILD_PARETO_WITH_TRACING, fronts and archives call the begin and end
+/// callbacks of the installed hooks around their main operations.
+/// Otherwise, the hooks are never called and the compiler removes them.
+///
+/// We can install our own hooks to forward these events to a profiler,
+/// or install the built-in latency_recorder to get latency percentiles:
+///
+///     pareto::latency_recorder recorder;
+///     pareto::set_trace_hooks(&recorder);
+///     // ... use the fronts ...
+///     pareto::set_trace_hooks(nullptr);
+///     std::cout << recorder << std::endl;
+namespace pareto {
+#ifdef BUILD_PARETO_WITH_TRACING
+    constexpr bool tracing_enabled = true;
+#else
+    constexpr bool tracing_enabled = false;
+#endif
+
+    /// \brief Operations reported to the tracing hooks
+    enum class traced_operation : uint8_t {
+        insert,
+        erase,
+        dominates,
+        find_nearest,
+        hypervolume,
+        resize
+    };
+
+    /// \brief Number of traced operations
+    constexpr size_t number_of_traced_operations = 6;
+
+    /// \brief Name of a traced operation
+    inline const char *to_string(traced_operation op) noexcept {
+        constexpr std::array<const char *, number_of_traced_operations>
+            names = {"insert",       "erase",       "dominates",
+                     "find_nearest", "hypervolume", "resize"};
+        return names[static_cast<size_t>(op)];
+    }
+
+    /// \brief Callbacks called around traced operations
+    /// The callbacks might be called concurrently from many threads
+    /// and they should not throw.
+    class trace_hooks {
+      public:
+        virtual ~trace_hooks() = default;
+
+        /// \brief Called before an operation starts
+        /// \param op Operation
+        /// \param n Size of the container when the operation started
+        virtual void begin(traced_operation op, size_t n) {
+            (void) op;
+            (void) n;
+        }
+
+        /// \brief Called after an operation ends
+        /// \param op Operation
+        /// \param n Size of the container when the operation started
+        /// \param elapsed Time since the begin callback returned
+        virtual void end(traced_operation op, size_t n,
+                         std::chrono::nanoseconds elapsed) {
+            (void) op;
+            (void) n;
+            (void) elapsed;
+        }
+    };
+
+    namespace detail {
+        inline std::atomic<trace_hooks *> &installed_trace_hooks() noexcept {
+            static std::atomic<trace_hooks *> hooks{nullptr};
+            return hooks;
+        }
+    } // namespace detail
+
+    /// \brief Install the tracing hooks for all threads
+    /// The hooks should outlive all traced operations. Pass nullptr
+    /// to stop tracing.
+    /// \return The hooks installed before
+    inline trace_hooks *set_trace_hooks(trace_hooks *hooks) noexcept {
+        return detail::installed_trace_hooks().exchange(hooks);
+    }
+
+    /// \brief Currently installed tracing hooks or nullptr
+    inline trace_hooks *get_trace_hooks() noexcept {
+        return detail::installed_trace_hooks().load(std::memory_order_acquire);
+    }
+
+    namespace detail {
+        /// \brief Number of traced operations running in this thread
+        /// Operations call other public operations (insert calls
+        /// dominates and erase, and archives call the operations of
+        /// their fronts), and only the outer one is reported.
+        inline size_t &tracing_depth() noexcept {
+            thread_local size_t depth = 0;
+            return depth;
+        }
+    } // namespace detail
+
+    /// \brief Report an operation to the tracing hooks while in scope
+    /// Operations nested in another traced operation of the same
+    /// thread are part of the outer operation and are not reported.
+    class trace_scope {
+      public:
+        trace_scope([[maybe_unused]] traced_operation op,
+                    [[maybe_unused]] size_t n) noexcept {
+            if constexpr (tracing_enabled) {
+                if (detail::tracing_depth()++ != 0) {
+                    return;
+                }
+                hooks_ = get_trace_hooks();
+                if (hooks_ != nullptr) {
+                    op_ = op;
+                    n_ = n;
+                    hooks_->begin(op_, n_);
+                    start_ = std::chrono::steady_clock::now();
+                }
+            }
+        }
+
+        /// \brief Do not report the operations in scope
+        /// This is for helpers that call public operations but are
+        /// not operations themselves.
+        trace_scope() noexcept {
+            if constexpr (tracing_enabled) {
+                ++detail::tracing_depth();
+            }
+        }
+
+        ~trace_scope() {
+            if constexpr (tracing_enabled) {
+                if (hooks_ != nullptr) {
+                    hooks_->end(op_, n_,
+                                std::chrono::steady_clock::now() - start_);
+                }
+                --detail::tracing_depth();
+            }
+        }
+
+        trace_scope(const trace_scope &) = delete;
+        trace_scope &operator=(const trace_scope &) = delete;
+
+      private:
+        trace_hooks *hooks_{nullptr};
+        traced_operation op_{traced_operation::insert};
+        size_t n_{0};
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /// \brief Histogram of latencies with bounded relative error
+    /// Like HDR histograms, the buckets are linear inside each power of
+    /// two and exponential across powers of two. With 32 sub-buckets per
+    /// power of two, any value is reported with less than 3.2% error.
+    /// Values can be recorded concurrently.
+    class latency_histogram {
+      public:
+        /// \brief log2 of the number of sub-buckets per power of two
+        static constexpr size_t sub_bucket_bits = 5;
+        static constexpr size_t sub_buckets = size_t(1) << sub_bucket_bits;
+        /// \brief Values below this threshold have their own buckets
+        static constexpr uint64_t linear_limit = uint64_t(2) * sub_buckets;
+        static constexpr size_t number_of_buckets =
+            2 * sub_buckets + (64 - sub_bucket_bits - 1) * sub_buckets;
+
+      public:
+        latency_histogram() noexcept { reset(); }
+
+        latency_histogram(const latency_histogram &) = delete;
+        latency_histogram &operator=(const latency_histogram &) = delete;
+
+      public /* Modifiers */:
+        /// \brief Record a value (usually in nanoseconds)
+        void record(uint64_t v) noexcept {
+            counts_[bucket_index(v)].fetch_add(1, std::memory_order_relaxed);
+            count_.fetch_add(1, std::memory_order_relaxed);
+            sum_.fetch_add(v, std::memory_order_relaxed);
+            uint64_t prev = max_.load(std::memory_order_relaxed);
+            while (prev < v && !max_.compare_exchange_weak(
+                                   prev, v, std::memory_order_relaxed)) {
+            }
+            prev = min_.load(std::memory_order_relaxed);
+            while (v < prev && !min_.compare_exchange_weak(
+                                   prev, v, std::memory_order_relaxed)) {
+            }
+        }
+
+        /// \brief Remove all values
+        void reset() noexcept {
+            for (auto &c : counts_) {
+                c.store(0, std::memory_order_relaxed);
+            }
+            count_.store(0, std::memory_order_relaxed);
+            sum_.store(0, std::memory_order_relaxed);
+            max_.store(0, std::memory_order_relaxed);
+            min_.store(std::numeric_limits<uint64_t>::max(),
+                       std::memory_order_relaxed);
+        }
+
+      public /* Statistics */:
+        /// \brief Number of recorded values
+        [[nodiscard]] uint64_t count() const noexcept {
+            return count_.load(std::memory_order_relaxed);
+        }
+
+        /// \brief Smallest recorded value (0 if empty)
+        [[nodiscard]] uint64_t min() const noexcept {
+            return count() == 0 ? 0 : min_.load(std::memory_order_relaxed);
+        }
+
+        /// \brief Largest recorded value
+        [[nodiscard]] uint64_t max() const noexcept {
+            return max_.load(std::memory_order_relaxed);
+        }
+
+        /// \brief Average of the recorded values
+        [[nodiscard]] double mean() const noexcept {
+            const uint64_t n = count();
+            return n == 0 ? 0. : static_cast<double>(sum_.load()) / n;
+        }
+
+        /// \brief Value at a given percentile
+        /// As in HDR histograms, this is the highest value equivalent to
+        /// the bucket where the percentile is.
+        /// \param p Percentile in [0, 100]
+        [[nodiscard]] uint64_t percentile(double p) const noexcept {
+            const uint64_t n = count();
+            if (n == 0) {
+                return 0;
+            }
+            p = std::max(0., std::min(p, 100.));
+            auto rank = static_cast<uint64_t>(p / 100. * n + 0.5);
+            rank = std::max(rank, uint64_t(1));
+            uint64_t acc = 0;
+            for (size_t i = 0; i < number_of_buckets; ++i) {
+                acc += counts_[i].load(std::memory_order_relaxed);
+                if (acc >= rank) {
+                    return std::min(highest_equivalent_value(i), max());
+                }
+            }
+            return max();
+        }
+
+      public /* Buckets */:
+        /// \brief Bucket of a value
+        static size_t bucket_index(uint64_t v) noexcept {
+            if (v < linear_limit) {
+                return static_cast<size_t>(v);
+            }
+            const size_t e = floor_log2(v);
+            const size_t shift = e - sub_bucket_bits;
+            const auto mantissa =
+                static_cast<size_t>((v >> shift) & (sub_buckets - 1));
+            return linear_limit + (e - sub_bucket_bits - 1) * sub_buckets +
+                   mantissa;
+        }
+
+        /// \brief Smallest value in a bucket
+        static uint64_t lowest_equivalent_value(size_t i) noexcept {
+            if (i < linear_limit) {
+                return i;
+            }
+            const size_t e = (i - linear_limit) / sub_buckets +
+                             sub_bucket_bits + 1;
+            const size_t mantissa = (i - linear_limit) % sub_buckets;
+            return (uint64_t(sub_buckets) + mantissa) << (e - sub_bucket_bits);
+        }
+
+        /// \brief Largest value in a bucket
+        static uint64_t highest_equivalent_value(size_t i) noexcept {
+            if (i < linear_limit) {
+                return i;
+            }
+            const size_t e = (i - linear_limit) / sub_buckets +
+                             sub_bucket_bits + 1;
+            return lowest_equivalent_value(i) +
+                   ((uint64_t(1) << (e - sub_bucket_bits)) - 1);
+        }
+
+      private:
+        static size_t floor_log2(uint64_t v) noexcept {
+            size_t r = 0;
+            for (size_t s = 32; s > 0; s /= 2) {
+                if (v >> s) {
+                    v >>= s;
+                    r += s;
+                }
+            }
+            return r;
+        }
+
+        std::array<std::atomic<uint64_t>, number_of_buckets> counts_;
+        std::atomic<uint64_t> count_;
+        std::atomic<uint64_t> sum_;
+        std::atomic<uint64_t> max_;
+        std::atomic<uint64_t> min_;
+    };
+
+    /// \brief Tracing hooks that keep a latency histogram per operation
+    class latency_recorder : public trace_hooks {
+      public:
+        void end(traced_operation op, size_t,
+                 std::chrono::nanoseconds elapsed) override {
+            histograms_[static_cast<size_t>(op)].record(
+                static_cast<uint64_t>(std::max(elapsed.count(),
+                                               decltype(elapsed.count()){0})));
+        }
+
+        /// \brief Latencies of an operation in nanoseconds
+        const latency_histogram &histogram(traced_operation op) const {
+            return histograms_[static_cast<size_t>(op)];
+        }
+
+        /// \brief Remove all recorded latencies
+        void reset() noexcept {
+            for (auto &h : histograms_) {
+                h.reset();
+            }
+        }
+
+        /// \brief Print p50, p99, p999, and max latency per operation
+        friend std::ostream &operator<<(std::ostream &os,
+                                        const latency_recorder &r) {
+            os << std::left << std::setw(14) << "operation" << std::right
+               << std::setw(12) << "count" << std::setw(12) << "p50 (ns)"
+               << std::setw(12) << "p99 (ns)" << std::setw(12) << "p999 (ns)"
+               << std::setw(12) << "max (ns)";
+            for (size_t i = 0; i < number_of_traced_operations; ++i) {
+                const latency_histogram &h = r.histograms_[i];
+                if (h.count() == 0) {
+                    continue;
+                }
+                os << '\n'
+                   << std::left << std::setw(14)
+                   << to_string(static_cast<traced_operation>(i))
+                   << std::right << std::setw(12) << h.count()
+                   << std::setw(12) << h.percentile(50.) << std::setw(12)
+                   << h.percentile(99.) << std::setw(12) << h.percentile(99.9)
+                   << std::setw(12) << h.max();
+            }
+            return os;
+        }
+
+      private:
+        std::array<latency_histogram, number_of_traced_operations>
+            histograms_;
+    };
+} // namespace pareto
+
+#endif // PARETO_TRACING_H
@@ -0,0 +1,204 @@
+#ifndef PARETO_WORK_STATS_H
+#define PARETO_WORK_STATS_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <ostream>
+
+/// Work counters for queries and mutations
+/// When a query is slow, these counters tell us whether it visited
+/// 10 nodes or 10,000. The counters only exist if the library is
+/// built with BUILD_PARETO_WITH_STATS. Otherwise, all counting
+/// functions are empty and the compiler removes them.
+///
+/// The counters are thread-local, so they count the work of the
+/// calling thread only:
+///
+///     pareto::reset_work_stats();
+///     auto it = pf.find_nearest(p, 10);
+///     std::cout << pareto::get_work_stats() << std::endl;
+namespace pareto {
+#ifdef BUILD_PARETO_WITH_STATS
+    constexpr bool work_stats_enabled = true;
+#else
+    constexpr bool work_stats_enabled = false;
+#endif
+
+    /// \brief Counters of the work done by containers and adaptors
+    struct work_stats {
+        /// \brief Number of predicate types
+        /// The types are in the same order as in predicate_variant:
+        /// intersects, disjoint, within, nearest, and satisfies.
+        static constexpr size_t number_of_predicate_types = 5;
+
+        /// \brief Nodes (or pages) whose elements or children were tested
+        size_t nodes_visited{0};
+
+        /// \brief Predicates evaluated against a bounding box
+        size_t bounding_box_tests{0};
+
+        /// \brief Predicates evaluated, by predicate type
+        std::array<size_t, number_of_predicate_types> predicates_evaluated{};
+
+        /// \brief Point-point dominance tests
+        size_t dominance_tests{0};
+
+        /// \brief Nodes and elements pushed to k-nearest heaps
+        size_t heap_pushes{0};
+
+        /// \brief Nodes and elements popped from k-nearest heaps
+        size_t heap_pops{0};
+
+        /// \brief Nodes split because they overflowed
+        size_t node_splits{0};
+
+        /// \brief Nodes dissolved because they underflowed
+        size_t node_merges{0};
+
+        /// \brief Elements removed and inserted again to rebalance a tree
+        size_t reinsertions{0};
+
+        /// \brief Calls to archive::try_insert, including cascades
+        size_t cascade_steps{0};
+
+        /// \brief Deepest cascade of try_insert into the next fronts
+        size_t max_cascade_depth{0};
+
+        /// \brief Nodes (or pages) allocated
+        size_t allocations{0};
+
+        /// \brief Nodes (or pages) deallocated
+        size_t deallocations{0};
+
+        /// \brief Total number of predicates evaluated
+        [[nodiscard]] size_t total_predicates_evaluated() const noexcept {
+            return std::accumulate(predicates_evaluated.begin(),
+                                   predicates_evaluated.end(), size_t{0});
+        }
+
+        /// \brief Set all counters to zero
+        void reset() noexcept { *this = work_stats(); }
+
+        /// \brief Accumulate the counters of another thread
+        work_stats &operator+=(const work_stats &rhs) noexcept {
+            nodes_visited += rhs.nodes_visited;
+            bounding_box_tests += rhs.bounding_box_tests;
+            for (size_t i = 0; i < number_of_predicate_types; ++i) {
+                predicates_evaluated[i] += rhs.predicates_evaluated[i];
+            }
+            dominance_tests += rhs.dominance_tests;
+            heap_pushes += rhs.heap_pushes;
+            heap_pops += rhs.heap_pops;
+            node_splits += rhs.node_splits;
+            node_merges += rhs.node_merges;
+            reinsertions += rhs.reinsertions;
+            cascade_steps += rhs.cascade_steps;
+            max_cascade_depth = std::max(max_cascade_depth,
+                                         rhs.max_cascade_depth);
+            allocations += rhs.allocations;
+            deallocations += rhs.deallocations;
+            return *this;
+        }
+
+        /// \brief Print all counters
+        friend std::ostream &operator<<(std::ostream &os,
+                                        const work_stats &s) {
+            os << "nodes visited: " << s.nodes_visited
+               << "\nbounding box tests: " << s.bounding_box_tests
+               << "\npredicates evaluated: " << s.total_predicates_evaluated()
+               << " (intersects: " << s.predicates_evaluated[0]
+               << ", disjoint: " << s.predicates_evaluated[1]
+               << ", within: " << s.predicates_evaluated[2]
+               << ", nearest: " << s.predicates_evaluated[3]
+               << ", satisfies: " << s.predicates_evaluated[4] << ")"
+               << "\ndominance tests: " << s.dominance_tests
+               << "\nheap pushes: " << s.heap_pushes
+               << "\nheap pops: " << s.heap_pops
+               << "\nnode splits: " << s.node_splits
+               << "\nnode merges: " << s.node_merges
+               << "\nreinsertions: " << s.reinsertions
+               << "\ncascade steps: " << s.cascade_steps
+               << "\nmax cascade depth: " << s.max_cascade_depth
+               << "\nallocations: " << s.allocations
+               << "\ndeallocations: " << s.deallocations;
+            return os;
+        }
+    };
+
+    namespace detail {
+        inline work_stats &thread_work_stats() noexcept {
+            thread_local work_stats stats;
+            return stats;
+        }
+
+        inline size_t &thread_cascade_depth() noexcept {
+            thread_local size_t depth{0};
+            return depth;
+        }
+    } // namespace detail
+
+    /// \brief Work counters of the calling thread
+    /// All counters are zero if the library is built without
+    /// BUILD_PARETO_WITH_STATS.
+    inline work_stats get_work_stats() noexcept {
+        if constexpr (work_stats_enabled) {
+            return detail::thread_work_stats();
+        } else {
+            return work_stats();
+        }
+    }
+
+    /// \brief Reset the work counters of the calling thread
+    inline void reset_work_stats() noexcept {
+        if constexpr (work_stats_enabled) {
+            detail::thread_work_stats().reset();
+        }
+    }
+
+    /// \brief Add n to a work counter
+    inline void count_work([[maybe_unused]] size_t work_stats::*counter,
+                           [[maybe_unused]] size_t n = 1) noexcept {
+        if constexpr (work_stats_enabled) {
+            detail::thread_work_stats().*counter += n;
+        }
+    }
+
+    /// \brief Count a predicate evaluation
+    /// \param type Index of the predicate in predicate_variant
+    /// \param is_box_test Whether the predicate was tested against a box
+    inline void count_predicate([[maybe_unused]] size_t type,
+                                [[maybe_unused]] bool is_box_test) noexcept {
+        if constexpr (work_stats_enabled) {
+            work_stats &s = detail::thread_work_stats();
+            ++s.predicates_evaluated[type];
+            s.bounding_box_tests += is_box_test;
+        }
+    }
+
+    /// \brief Count one level of an insertion cascade while in scope
+    class cascade_counter {
+      public:
+        cascade_counter() noexcept {
+            if constexpr (work_stats_enabled) {
+                size_t &depth = detail::thread_cascade_depth();
+                ++depth;
+                work_stats &s = detail::thread_work_stats();
+                ++s.cascade_steps;
+                s.max_cascade_depth = std::max(s.max_cascade_depth, depth);
+            }
+        }
+
+        ~cascade_counter() {
+            if constexpr (work_stats_enabled) {
+                --detail::thread_cascade_depth();
+            }
+        }
+
+        cascade_counter(const cascade_counter &) = delete;
+        cascade_counter &operator=(const cascade_counter &) = delete;
+    };
+} // namespace pareto
+
+#endif // PARETO_WORK_STATS_H
@@ -0,0 +1,2229 @@
+#ifndef PARETO_DISK_TREE_H
+#define PARETO_DISK_TREE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <pareto/point.h>
+#include <pareto/query/predicates.h>
+#include <pareto/query/query_box.h>
+
+namespace pareto {
+    /// \brief Options for disk trees
+    struct disk_tree_options {
+        /// \brief Directory for the page files
+        /// If empty, the page files are created in the system temporary
+        /// directory. Page files are removed with their containers.
+        std::string directory;
+
+        /// \brief Size of a page in bytes
+        /// Each page stores as many elements or child entries as fit in
+        /// this size. Pages have room for at least two of them.
+        size_t page_size{4096};
+
+        /// \brief Maximum number of pages in the buffer pool
+        /// Pages referenced by iterators or by an operation in progress
+        /// cannot be evicted, so the pool can temporarily grow beyond
+        /// this size.
+        size_t buffer_pool_pages{256};
+    };
+
+    /// \brief Options of disk trees constructed without options
+    /// Fronts and archives construct their containers internally, so
+    /// the options of these trees are part of the tree type. Trees
+    /// constructed with options use their own options instead.
+    /// \tparam PageSize Size of a page in bytes
+    /// \tparam BufferPoolPages Maximum number of pages in the buffer pool
+    template <size_t PageSize = 4096, size_t BufferPoolPages = 256>
+    struct disk_tree_defaults {
+        static disk_tree_options options() {
+            disk_tree_options o;
+            o.page_size = PageSize;
+            o.buffer_pool_pages = BufferPoolPages;
+            return o;
+        }
+    };
+
+    /// \class disk_tree
+    /// Disk-backed spatial container for fronts larger than the memory.
+    ///
+    /// This is an R-tree whose nodes are fixed-size pages in a page file.
+    /// Leaf pages store elements and internal pages store the bounding
+    /// box, position, and size of their child pages. Only the bounding
+    /// box of the root page is kept in memory, and only the pages in a
+    /// bounded LRU buffer pool are kept in memory. With 4KB pages, an
+    /// internal page has more than 50 children in 3 dimensions, so
+    /// finding a page takes O(log n / log b) page reads for pages with
+    /// b entries, and the upper levels usually stay in the pool.
+    ///
+    /// New elements go to the child whose bounding box needs the least
+    /// enlargement, and pages that overflow are split along the longest
+    /// dimension of their bounding box. Pages that become empty are
+    /// removed from their parents, and bounding boxes are kept tight, so
+    /// the minimum and maximum values come from the root box.
+    ///
+    /// Bulk loading packs the elements into leaf pages with the
+    /// sort-tile-recursive algorithm and packs the pages into the upper
+    /// levels. Inserting a range in a container that is not empty packs
+    /// the range into new leaf pages and inserts these pages as
+    /// subtrees, so large batches can be streamed into the container.
+    ///
+    /// The iterators keep the path from the root to their leaf page and
+    /// pin the leaf page, so iterating the container streams the pages
+    /// through the buffer pool.
+    ///
+    /// Even const queries modify the buffer pool, so the pool has its
+    /// own lock. Many threads can run const queries and iterate the
+    /// container at the same time, as with any other container, but
+    /// they take turns to read pages that are not in the pool.
+    ///
+    /// \note Pages are stored as raw bytes, so the number of dimensions
+    /// needs to be set at compile time and the mapped type needs to be
+    /// trivially copyable.
+    ///
+    /// \tparam K Number/key type
+    /// \tparam M Number of dimensions
+    /// \tparam T Element/mapped type
+    /// \tparam C Comparison function type in one dimension
+    /// \tparam A Allocator type for the pages in the buffer pool
+    /// \tparam Defaults Options of trees constructed without options
+    template <class K, size_t M, class T, typename C = std::less<K>,
+              class A = std::allocator<std::pair<const point<K, M>, T>>,
+              class Defaults = disk_tree_defaults<>>
+    class disk_tree {
+        static_assert(M != 0, "disk_tree needs compile-time dimensions");
+        static_assert(std::is_trivially_copyable_v<K> &&
+                          std::is_trivially_copyable_v<T>,
+                      "disk_tree stores elements as raw bytes");
+
+      private /* Internal types */:
+        using unprotected_point_type = point<K, M>;
+        using protected_point_type = const point<K, M>;
+        using unprotected_mapped_type = T;
+        using unprotected_key_type = unprotected_point_type;
+        using protected_key_type = protected_point_type;
+        using unprotected_value_type =
+            element_pair_t<unprotected_key_type, unprotected_mapped_type>;
+        using protected_value_type =
+            element_pair_t<protected_key_type, unprotected_mapped_type>;
+        using protected_allocator_type = typename std::allocator_traits<
+            A>::template rebind_alloc<protected_value_type>;
+        /// Pages keep the protected pairs we return to the user, so that
+        /// iterators never reinterpret elements as another type
+        using page_elements_type =
+            std::vector<protected_value_type, protected_allocator_type>;
+        using point_type = unprotected_point_type;
+
+      public /* Forward declarations */:
+        template <bool is_const> class iterator_impl;
+
+      public /* Container Concept */:
+        using value_type = protected_value_type;
+        using reference = value_type &;
+        using const_reference = value_type const &;
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+        using pointer = value_type *;
+        using const_pointer = const value_type *;
+        using difference_type = std::ptrdiff_t;
+        using size_type = size_t;
+
+      public /* ReversibleContainer Concept */:
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      public /* AssociativeContainer Concept */:
+        using key_type = unprotected_point_type;
+        using mapped_type = T;
+        using key_compare =
+            std::function<bool(const key_type &, const key_type &)>;
+        using value_compare =
+            std::function<bool(const value_type &, const value_type &)>;
+
+      public /* AllocatorAwareContainer Concept */:
+        using allocator_type = A;
+
+      public /* SpatialContainer Concept */:
+        static constexpr size_t number_of_compile_dimensions = M;
+        using dimension_type = K;
+        using dimension_compare = C;
+        using box_type =
+            query_box<dimension_type, number_of_compile_dimensions>;
+        using predicate_list_type =
+            predicate_list<dimension_type, number_of_compile_dimensions, T>;
+
+      private /* Pages */:
+        /// \brief Reference to a page in its parent page
+        /// The root entry is the only entry kept in memory.
+        struct page_entry {
+            /// Bounding box of the page elements
+            box_type bounds;
+            /// Position of the page in the page file
+            size_t slot{0};
+            /// Number of elements (leaf) or entries (internal) in the page
+            size_t size{0};
+        };
+
+        /// \brief A page in the buffer pool
+        struct frame {
+            /// Position of the page in the page file
+            size_t slot;
+            /// Whether the page stores elements or child entries
+            bool is_leaf;
+            /// Whether the page needs to be written back
+            bool dirty;
+            /// Elements in a leaf page
+            page_elements_type elements;
+            /// Child entries in an internal page
+            std::vector<page_entry> entries;
+        };
+
+        using frame_ptr = std::shared_ptr<frame>;
+
+        /// \brief Position in an internal page on the path to a leaf
+        struct path_level {
+            /// Position of the internal page in the page file
+            size_t slot;
+            /// Number of entries in the internal page
+            size_t size;
+            /// Entry we followed to the next level
+            size_t index;
+        };
+
+        using path_type = std::vector<path_level>;
+
+        /// \brief Page file and buffer pool
+        /// This is created on demand, so empty containers do not
+        /// create files. Each function holds the lock of the pool, so
+        /// const queries in different threads can share the pool. Pages
+        /// are pinned by holding a frame_ptr, and a pinned page is never
+        /// evicted, so threads read the pages they hold without the lock.
+        class page_store {
+          public:
+            page_store(const disk_tree_options &options,
+                       const protected_allocator_type &alloc)
+                : alloc_(alloc) {
+                page_bytes_ = page_bytes(options);
+                leaf_capacity_ = page_bytes_ / record_size;
+                internal_capacity_ = page_bytes_ / entry_record_size;
+                pool_capacity_ = std::max(options.buffer_pool_pages, size_t{1});
+                std::filesystem::path directory =
+                    options.directory.empty()
+                        ? std::filesystem::temp_directory_path()
+                        : std::filesystem::path(options.directory);
+                std::random_device rd;
+                path_ = directory / ("pareto_disk_tree_" +
+                                     std::to_string(rd()) + "_" +
+                                     std::to_string(rd()) + ".pages");
+                file_.open(path_, std::ios::in | std::ios::out |
+                                      std::ios::binary | std::ios::trunc);
+                if (!file_.is_open()) {
+                    throw std::runtime_error(
+                        "disk_tree: cannot create page file " +
+                        path_.string());
+                }
+                buffer_.resize(page_bytes_);
+            }
+
+            page_store(const page_store &) = delete;
+
+            page_store &operator=(const page_store &) = delete;
+
+            ~page_store() {
+                file_.close();
+                std::error_code ec;
+                std::filesystem::remove(path_, ec);
+            }
+
+            /// \brief Bytes of a page in the page file
+            static size_t page_bytes(const disk_tree_options &options) {
+                return std::max(options.page_size,
+                                2 * std::max(record_size, entry_record_size));
+            }
+
+            [[nodiscard]] size_t leaf_capacity() const {
+                return leaf_capacity_;
+            }
+
+            [[nodiscard]] size_t internal_capacity() const {
+                return internal_capacity_;
+            }
+
+            [[nodiscard]] size_t pool_capacity() const {
+                return pool_capacity_;
+            }
+
+            [[nodiscard]] size_t pool_size() const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return frames_.size();
+            }
+
+            [[nodiscard]] size_t pages_in_use() const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return n_slots_ - free_slots_.size();
+            }
+
+            [[nodiscard]] size_t reads() const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return reads_;
+            }
+
+            [[nodiscard]] size_t writes() const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return writes_;
+            }
+
+            /// \brief Get page from the pool or from the file
+            frame_ptr acquire(size_t slot, size_t size, bool is_leaf) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = frames_.find(slot);
+                if (it != frames_.end()) {
+                    lru_.splice(lru_.begin(), lru_, it->second);
+                    return *it->second;
+                }
+                make_room();
+                frame_ptr f = std::make_shared<frame>(
+                    frame{slot, is_leaf, false, page_elements_type(alloc_), {}});
+                read(*f, size);
+                lru_.push_front(f);
+                frames_.emplace(slot, lru_.begin());
+                return f;
+            }
+
+            /// \brief Create an empty page
+            frame_ptr create(bool is_leaf) {
+                count_work(&work_stats::allocations);
+                std::lock_guard<std::mutex> lock(mutex_);
+                size_t slot;
+                if (!free_slots_.empty()) {
+                    slot = free_slots_.back();
+                    free_slots_.pop_back();
+                } else {
+                    slot = n_slots_++;
+                }
+                make_room();
+                frame_ptr f = std::make_shared<frame>(
+                    frame{slot, is_leaf, true, page_elements_type(alloc_), {}});
+                if (is_leaf) {
+                    f->elements.reserve(leaf_capacity_ + 1);
+                } else {
+                    f->entries.reserve(internal_capacity_ + 1);
+                }
+                lru_.push_front(f);
+                frames_.emplace(slot, lru_.begin());
+                return f;
+            }
+
+            /// \brief Discard a page
+            void release(size_t slot) {
+                count_work(&work_stats::deallocations);
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = frames_.find(slot);
+                if (it != frames_.end()) {
+                    lru_.erase(it->second);
+                    frames_.erase(it);
+                }
+                free_slots_.emplace_back(slot);
+            }
+
+            /// \brief Discard all pages
+            void release_all() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                lru_.clear();
+                frames_.clear();
+                free_slots_.clear();
+                n_slots_ = 0;
+            }
+
+            /// \brief Write all modified pages to the file
+            void flush() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (frame_ptr &f : lru_) {
+                    if (f->dirty) {
+                        write(*f);
+                    }
+                }
+                file_.flush();
+            }
+
+          private:
+            /// \brief Evict the least recently used unpinned pages
+            /// A page is pinned while an iterator or an operation holds it.
+            /// The caller holds the lock, so no thread can pin a page
+            /// nobody holds while we check it.
+            void make_room() {
+                auto it = lru_.end();
+                while (frames_.size() >= pool_capacity_ && it != lru_.begin()) {
+                    --it;
+                    if (it->use_count() == 1) {
+                        if ((*it)->dirty) {
+                            write(**it);
+                        }
+                        frames_.erase((*it)->slot);
+                        it = lru_.erase(it);
+                    }
+                }
+            }
+
+            void read(frame &f, size_t size) {
+                const size_t bytes =
+                    size * (f.is_leaf ? record_size : entry_record_size);
+                file_.seekg(offset(f.slot));
+                file_.read(buffer_.data(), static_cast<std::streamsize>(bytes));
+                if (!file_) {
+                    throw std::runtime_error("disk_tree: cannot read page");
+                }
+                const char *src = buffer_.data();
+                if (f.is_leaf) {
+                    f.elements.reserve(leaf_capacity_ + 1);
+                    for (size_t j = 0; j < size; ++j) {
+                        point_type p;
+                        src = read_point(p, src);
+                        mapped_type v{};
+                        if constexpr (!std::is_empty_v<T>) {
+                            std::memcpy(&v, src, sizeof(T));
+                            src += sizeof(T);
+                        }
+                        f.elements.emplace_back(p, v);
+                    }
+                } else {
+                    f.entries.reserve(internal_capacity_ + 1);
+                    for (size_t j = 0; j < size; ++j) {
+                        point_type lb;
+                        point_type ub;
+                        src = read_point(lb, src);
+                        src = read_point(ub, src);
+                        std::uint64_t child[2];
+                        std::memcpy(child, src, sizeof(child));
+                        src += sizeof(child);
+                        f.entries.emplace_back(
+                            page_entry{box_type(lb, ub),
+                                       static_cast<size_t>(child[0]),
+                                       static_cast<size_t>(child[1])});
+                    }
+                }
+                ++reads_;
+            }
+
+            void write(frame &f) {
+                char *dst = buffer_.data();
+                if (f.is_leaf) {
+                    for (const value_type &v : f.elements) {
+                        dst = write_point(v.first, dst);
+                        if constexpr (!std::is_empty_v<T>) {
+                            std::memcpy(dst, &v.second, sizeof(T));
+                            dst += sizeof(T);
+                        }
+                    }
+                } else {
+                    for (const page_entry &e : f.entries) {
+                        dst = write_point(e.bounds.min(), dst);
+                        dst = write_point(e.bounds.max(), dst);
+                        const std::uint64_t child[2] = {
+                            static_cast<std::uint64_t>(e.slot),
+                            static_cast<std::uint64_t>(e.size)};
+                        std::memcpy(dst, child, sizeof(child));
+                        dst += sizeof(child);
+                    }
+                }
+                file_.seekp(offset(f.slot));
+                file_.write(buffer_.data(), dst - buffer_.data());
+                if (!file_) {
+                    throw std::runtime_error("disk_tree: cannot write page");
+                }
+                f.dirty = false;
+                ++writes_;
+            }
+
+            static const char *read_point(point_type &p, const char *src) {
+                for (size_t i = 0; i < M; ++i) {
+                    std::memcpy(&p[i], src, sizeof(K));
+                    src += sizeof(K);
+                }
+                return src;
+            }
+
+            static char *write_point(const point_type &p, char *dst) {
+                for (size_t i = 0; i < M; ++i) {
+                    std::memcpy(dst, &p[i], sizeof(K));
+                    dst += sizeof(K);
+                }
+                return dst;
+            }
+
+            [[nodiscard]] std::streamoff offset(size_t slot) const {
+                return static_cast<std::streamoff>(slot) *
+                       static_cast<std::streamoff>(page_bytes_);
+            }
+
+          public:
+            /// \brief Bytes of an element in the page file
+            /// Empty mapped types, as in key-only fronts, take no space.
+            static constexpr size_t record_size =
+                M * sizeof(K) + (std::is_empty_v<T> ? 0 : sizeof(T));
+
+            /// \brief Bytes of a child entry in the page file
+            static constexpr size_t entry_record_size =
+                2 * M * sizeof(K) + 2 * sizeof(std::uint64_t);
+
+          private:
+            /// Guards the pool, the page file and the counters
+            mutable std::mutex mutex_;
+            std::filesystem::path path_;
+            std::fstream file_;
+            std::vector<char> buffer_;
+            protected_allocator_type alloc_;
+            size_t page_bytes_;
+            size_t leaf_capacity_;
+            size_t internal_capacity_;
+            size_t pool_capacity_;
+            std::list<frame_ptr> lru_;
+            std::unordered_map<size_t, typename std::list<frame_ptr>::iterator>
+                frames_;
+            std::vector<size_t> free_slots_;
+            size_t n_slots_{0};
+            size_t reads_{0};
+            size_t writes_{0};
+        };
+
+      public /* Iterators */:
+        /// \brief Disk tree iterator
+        /// This iterator keeps the path from the root to the current leaf
+        /// page and pins the leaf page in the buffer pool while it points
+        /// to it. Subtrees whose bounding boxes cannot match the query
+        /// are skipped without being read, and the elements that do not
+        /// match the query predicate are skipped in the pages we read.
+        template <bool is_const> class iterator_impl {
+          private /* Internal Types */:
+            template <class TYPE, class CONST_TYPE>
+            using const_toggle =
+                std::conditional_t<!is_const, TYPE, CONST_TYPE>;
+
+            template <class U>
+            using maybe_add_const = const_toggle<U, std::add_const_t<U>>;
+
+            using query_function = std::function<bool(const value_type &)>;
+            using page_function = std::function<bool(const box_type &)>;
+
+          public /* LegacyIterator Types */:
+            using value_type = maybe_add_const<disk_tree::value_type>;
+            using reference = const_toggle<disk_tree::reference,
+                                           disk_tree::const_reference>;
+            using difference_type = disk_tree::difference_type;
+            using pointer =
+                const_toggle<disk_tree::pointer, disk_tree::const_pointer>;
+            using iterator_category = std::bidirectional_iterator_tag;
+
+          public /* LegacyIterator Constructors */:
+            /// \brief Copy constructor
+            template <bool rhs_is_const,
+                      class = std::enable_if_t<is_const || !rhs_is_const>>
+            // NOLINTNEXTLINE(google-explicit-constructor)
+            iterator_impl(const iterator_impl<rhs_is_const> &rhs)
+                : tree_(rhs.tree_), path_(rhs.path_), frame_(rhs.frame_),
+                  slot_(rhs.slot_), query_function_(rhs.query_function_),
+                  page_function_(rhs.page_function_) {}
+
+            /// \brief Copy assignment
+            template <bool rhs_is_const,
+                      class = std::enable_if_t<is_const || !rhs_is_const>>
+            iterator_impl &operator=(const iterator_impl<rhs_is_const> &rhs) {
+                tree_ = rhs.tree_;
+                path_ = rhs.path_;
+                frame_ = rhs.frame_;
+                slot_ = rhs.slot_;
+                query_function_ = rhs.query_function_;
+                page_function_ = rhs.page_function_;
+                return *this;
+            }
+
+            /// \brief Destructor
+            ~iterator_impl() = default;
+
+          public /* LegacyForwardIterator Constructors */:
+            /// \brief Default constructor
+            iterator_impl() = default;
+
+          public /* ContainerConcept Constructors */:
+            /// \brief Convert to const iterator
+            // NOLINTNEXTLINE(google-explicit-constructor)
+            operator iterator_impl<true>() const {
+                return iterator_impl<true>(*this);
+            }
+
+          public /* SpatialContainer Concept Constructors */:
+            /// \brief Move constructor
+            template <bool rhs_is_const,
+                      class = std::enable_if_t<is_const || !rhs_is_const>>
+            // NOLINTNEXTLINE(google-explicit-constructor)
+            iterator_impl(iterator_impl<rhs_is_const> &&rhs)
+                : tree_(rhs.tree_), path_(std::move(rhs.path_)),
+                  frame_(std::move(rhs.frame_)), slot_(rhs.slot_),
+                  query_function_(std::move(rhs.query_function_)),
+                  page_function_(std::move(rhs.page_function_)) {}
+
+            /// \brief Move assignment
+            template <bool rhs_is_const,
+                      class = std::enable_if_t<is_const || !rhs_is_const>>
+            iterator_impl &operator=(iterator_impl<rhs_is_const> &&rhs) {
+                tree_ = rhs.tree_;
+                path_ = std::move(rhs.path_);
+                frame_ = std::move(rhs.frame_);
+                slot_ = rhs.slot_;
+                query_function_ = std::move(rhs.query_function_);
+                page_function_ = std::move(rhs.page_function_);
+                return *this;
+            }
+
+          public /* Internal Constructors / Used by Container */:
+            /// \brief Past-the-end iterator
+            explicit iterator_impl(const disk_tree *tree) : tree_(tree) {}
+
+            /// \brief Iterator to first element that passes the query
+            iterator_impl(const disk_tree *tree, query_function fn,
+                          page_function page_fn)
+                : tree_(tree), query_function_(std::move(fn)),
+                  page_function_(std::move(page_fn)) {
+                seek_first();
+                maybe_advance_predicate();
+            }
+
+          public /* LegacyIterator */:
+            /// \brief Dereference iterator
+            reference operator*() const { return *operator->(); }
+
+            iterator_impl &operator++() {
+                advance();
+                maybe_advance_predicate();
+                return *this;
+            }
+
+          public /* LegacyInputIterator */:
+            pointer operator->() const {
+                if constexpr (!is_const) {
+                    // the user might change the mapped value
+                    frame_->dirty = true;
+                }
+                return &frame_->elements[slot_];
+            }
+
+          public /* LegacyForwardIterator */:
+            /// \brief Equality operator
+            template <bool rhs_is_const>
+            bool operator==(const iterator_impl<rhs_is_const> &rhs) const {
+                if (is_end() || rhs.is_end()) {
+                    return is_end() == rhs.is_end();
+                }
+                return frame_->slot == rhs.frame_->slot && slot_ == rhs.slot_;
+            }
+
+            /// \brief Inequality operator
+            template <bool rhs_is_const>
+            bool operator!=(const iterator_impl<rhs_is_const> &rhs) const {
+                return !(*this == rhs);
+            }
+
+            /// \brief Increment iterator
+            iterator_impl operator++(int) { // NOLINT(cert-dcl21-cpp):
+                auto tmp = *this;
+                operator++();
+                return tmp;
+            }
+
+          public /* LegacyBidirectionalIterator */:
+            /// \brief Decrement iterator
+            iterator_impl &operator--() {
+                retreat();
+                while (query_function_ && !query_function_(**this)) {
+                    retreat();
+                }
+                return *this;
+            }
+
+            /// \brief Decrement iterator
+            iterator_impl operator--(int) { // NOLINT(cert-dcl21-cpp)
+                auto tmp = *this;
+                operator--();
+                return tmp;
+            }
+
+          private /* Internal Functions */:
+            [[nodiscard]] bool is_end() const { return frame_ == nullptr; }
+
+            void set_end() {
+                path_.clear();
+                frame_.reset();
+                slot_ = 0;
+            }
+
+            [[nodiscard]] bool passes(const box_type &b) const {
+                return !page_function_ || page_function_(b);
+            }
+
+            /// \brief Pin the leaf page an entry refers to
+            void enter_leaf(const page_entry &e, size_t slot) {
+                frame_ = tree_->load(e, true);
+                slot_ = slot;
+            }
+
+            /// \brief Move to the first element of the first matching leaf
+            void seek_first() {
+                if (tree_->empty() || !passes(tree_->root_.bounds)) {
+                    set_end();
+                    return;
+                }
+                if (tree_->height_ == 0) {
+                    enter_leaf(tree_->root_, 0);
+                    return;
+                }
+                path_.push_back(
+                    path_level{tree_->root_.slot, tree_->root_.size, 0});
+                seek_forward();
+            }
+
+            /// \brief Move to the first matching leaf at or after the
+            /// entry of the deepest level in the path
+            void seek_forward() {
+                while (!path_.empty()) {
+                    path_level &top = path_.back();
+                    frame_ptr f = tree_->load(top.slot, top.size, false);
+                    while (top.index < top.size &&
+                           !passes(f->entries[top.index].bounds)) {
+                        ++top.index;
+                    }
+                    if (top.index == top.size) {
+                        path_.pop_back();
+                        if (!path_.empty()) {
+                            ++path_.back().index;
+                        }
+                        continue;
+                    }
+                    const page_entry e = f->entries[top.index];
+                    if (path_.size() == tree_->height_) {
+                        enter_leaf(e, 0);
+                        return;
+                    }
+                    path_.push_back(path_level{e.slot, e.size, 0});
+                }
+                set_end();
+            }
+
+            /// \brief Move to the last matching leaf before the entry of
+            /// the deepest level in the path
+            void seek_backward() {
+                while (!path_.empty()) {
+                    path_level &top = path_.back();
+                    frame_ptr f = tree_->load(top.slot, top.size, false);
+                    size_t i = top.index;
+                    while (i > 0 && !passes(f->entries[i - 1].bounds)) {
+                        --i;
+                    }
+                    if (i == 0) {
+                        path_.pop_back();
+                        continue;
+                    }
+                    top.index = i - 1;
+                    const page_entry e = f->entries[top.index];
+                    if (path_.size() == tree_->height_) {
+                        enter_leaf(e, e.size - 1);
+                        return;
+                    }
+                    path_.push_back(path_level{e.slot, e.size, e.size});
+                }
+                set_end();
+            }
+
+            /// \brief Move to the next element
+            void advance() {
+                ++slot_;
+                if (slot_ < frame_->elements.size()) {
+                    return;
+                }
+                frame_.reset();
+                if (path_.empty()) {
+                    set_end();
+                    return;
+                }
+                ++path_.back().index;
+                seek_forward();
+            }
+
+            /// \brief Move to the previous element
+            void retreat() {
+                if (!is_end() && slot_ > 0) {
+                    --slot_;
+                    return;
+                }
+                if (is_end()) {
+                    // the last element comes before the end
+                    const page_entry &root = tree_->root_;
+                    if (tree_->empty() || !passes(root.bounds)) {
+                        return;
+                    }
+                    if (tree_->height_ == 0) {
+                        enter_leaf(root, root.size - 1);
+                        return;
+                    }
+                    path_.push_back(path_level{root.slot, root.size, root.size});
+                }
+                frame_.reset();
+                seek_backward();
+            }
+
+            /// \brief Skip elements that do not match the query
+            void maybe_advance_predicate() {
+                if (query_function_) {
+                    while (!is_end() && !query_function_(**this)) {
+                        advance();
+                    }
+                }
+            }
+
+          private:
+            /// \brief Container we are iterating
+            const disk_tree *tree_{nullptr};
+
+            /// \brief Internal pages from the root to the current leaf
+            path_type path_;
+
+            /// \brief Current leaf page pinned in the buffer pool
+            frame_ptr frame_;
+
+            /// \brief Position of the current element in the leaf page
+            size_t slot_{0};
+
+            /// \brief Query function, in case the iterator has a predicate
+            query_function query_function_;
+
+            /// \brief Page function, in case the iterator skips pages
+            page_function page_function_;
+
+          public:
+            /// Let the disk tree access the spatial private constructors
+            friend disk_tree;
+            template <bool> friend class iterator_impl;
+        };
+
+      public /* Constructors: Container + AllocatorAwareContainer */:
+        /// \brief Create an empty container with the default options
+        explicit disk_tree(const allocator_type &alloc = allocator_type())
+            : options_(Defaults::options()), alloc_(alloc) {}
+
+        /// \brief Create an empty container
+        explicit disk_tree(const disk_tree_options &options,
+                           const allocator_type &alloc = allocator_type())
+            : options_(options), alloc_(alloc) {}
+
+        /// \brief Copy constructor
+        /// The copy gets its own page file.
+        disk_tree(const disk_tree &rhs)
+            : options_(rhs.options_), alloc_(rhs.alloc_), comp_(rhs.comp_) {
+            copy_pages(rhs);
+        }
+
+        /// \brief Copy constructor data but use another allocator
+        disk_tree(const disk_tree &rhs, const allocator_type &alloc)
+            : options_(rhs.options_), alloc_(alloc), comp_(rhs.comp_) {
+            copy_pages(rhs);
+        }
+
+        /// \brief Move constructor
+        /// The page file moves to the new container.
+        disk_tree(disk_tree &&rhs) noexcept
+            : options_(std::move(rhs.options_)), alloc_(rhs.alloc_),
+              comp_(std::move(rhs.comp_)), root_(rhs.root_),
+              height_(rhs.height_), store_(std::move(rhs.store_)),
+              size_(rhs.size_) {
+            rhs.reset_root();
+        }
+
+        /// \brief Move constructor data but use new allocator
+        disk_tree(disk_tree &&rhs, const allocator_type &alloc) noexcept
+            : disk_tree(std::move(rhs)) {
+            alloc_ = alloc;
+        }
+
+        /// \brief Destructor
+        ~disk_tree() = default;
+
+      public /* Constructors: AssociativeContainer + AllocatorAwareContainer */:
+        /// \brief Create container with custom comparison function
+        explicit disk_tree(const C &comp,
+                           const allocator_type &alloc = allocator_type())
+            : options_(Defaults::options()), alloc_(alloc), comp_(comp) {}
+
+        /// \brief Construct with iterators + comparison
+        /// The elements are bulk loaded into the pages.
+        template <class InputIt>
+        disk_tree(InputIt first, InputIt last, const C &comp = C(),
+                  const allocator_type &alloc = allocator_type())
+            : options_(Defaults::options()), alloc_(alloc), comp_(comp) {
+            insert(first, last);
+        }
+
+        /// \brief Construct with list + comparison
+        disk_tree(std::initializer_list<value_type> il, const C &comp = C(),
+                  const allocator_type &alloc = allocator_type())
+            : disk_tree(il.begin(), il.end(), comp, alloc) {}
+
+        /// \brief Construct with iterators
+        template <class InputIt>
+        disk_tree(InputIt first, InputIt last, const allocator_type &alloc)
+            : disk_tree(first, last, C(), alloc) {}
+
+        /// \brief Construct with list
+        disk_tree(std::initializer_list<value_type> il,
+                  const allocator_type &alloc)
+            : disk_tree(il.begin(), il.end(), C(), alloc) {}
+
+        /// \brief Construct with iterators and options
+        template <class InputIt>
+        disk_tree(InputIt first, InputIt last,
+                  const disk_tree_options &options,
+                  const allocator_type &alloc = allocator_type())
+            : options_(options), alloc_(alloc) {
+            insert(first, last);
+        }
+
+      public /* Assignment: Container + AllocatorAwareContainer */:
+        /// \brief Copy assignment
+        /// The container gets the options of rhs, because its pages
+        /// have the sizes of these options.
+        disk_tree &operator=(const disk_tree &rhs) {
+            if (&rhs == this) {
+                return *this;
+            }
+            clear();
+            store_.reset();
+            options_ = rhs.options_;
+            comp_ = rhs.comp_;
+            copy_pages(rhs);
+            return *this;
+        };
+
+        /// \brief Move assignment
+        disk_tree &operator=(disk_tree &&rhs) noexcept {
+            if (&rhs == this) {
+                return *this;
+            }
+            options_ = std::move(rhs.options_);
+            comp_ = std::move(rhs.comp_);
+            root_ = rhs.root_;
+            height_ = rhs.height_;
+            store_ = std::move(rhs.store_);
+            size_ = rhs.size_;
+            rhs.reset_root();
+            return *this;
+        }
+
+      public /* Assignment: AssociativeContainer */:
+        /// \brief Initializer list assignment
+        disk_tree &operator=(std::initializer_list<value_type> il) {
+            clear();
+            insert(il.begin(), il.end());
+            return *this;
+        }
+
+      public /* Non-Modifying Functions: AllocatorAwareContainer */:
+        /// \brief Obtains a copy of the allocator
+        allocator_type get_allocator() const noexcept { return alloc_; }
+
+      public /* Element Access / Map Concept */:
+        /// \brief Get reference to element at a given position, and throw error
+        /// if it does not exist
+        mapped_type &at(const key_type &k) {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                throw std::out_of_range("disk_tree::at: key not found");
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and throw error
+        /// if it does not exist
+        const mapped_type &at(const key_type &k) const {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                throw std::out_of_range("disk_tree::at: key not found");
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and create one
+        /// if it does not exits
+        mapped_type &operator[](const key_type &k) {
+            auto it = find(k);
+            if (it != end()) {
+                return it->second;
+            } else {
+                auto it_new = insert(std::make_pair(k, mapped_type()));
+                return it_new->second;
+            }
+        }
+
+        /// \brief Get reference to element at a given position, and create one
+        /// if it does not exits
+        template <typename... Targs>
+        mapped_type &operator()(const dimension_type &x1, const Targs &...xs) {
+            constexpr size_t m = sizeof...(Targs) + 1;
+            static_assert(number_of_compile_dimensions == m);
+            point_type p(m);
+            copy_pack(p.begin(), x1, xs...);
+            return operator[](p);
+        }
+
+      public /* Non-Modifying Functions: Container Concept */:
+        /// \brief Get iterator to first element
+        const_iterator begin() const noexcept {
+            return const_iterator(this, nullptr, nullptr);
+        }
+
+        /// \brief Get iterator to past-the-end element
+        const_iterator end() const noexcept { return const_iterator(this); }
+
+        /// \brief Get iterator to first element
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        /// \brief Get iterator to past-the-end element
+        const_iterator cend() const noexcept { return end(); }
+
+        /// \brief Get iterator to first element
+        iterator begin() noexcept { return iterator(this, nullptr, nullptr); }
+
+        /// \brief Get iterator to past-the-end element
+        iterator end() noexcept { return iterator(this); }
+
+      public /* Non-Modifying Functions: ReversibleContainer Concept */:
+        /// \brief Get iterator to first element in reverse
+        const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        }
+
+        /// \brief Get iterator to last element in reverse
+        const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        /// \brief Get iterator to first element in reverse
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+        /// \brief Get iterator to last element in reverse
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+        /// \brief Get iterator to first element in reverse
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        /// \brief Get iterator to past-the-end element in reverse
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+      public /* Non-Modifying Functions / Capacity / Container Concept */:
+        /// \brief True if container is empty
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+        /// \brief Get container size
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+
+        /// \brief Get container max size
+        [[nodiscard]] size_t max_size() const noexcept {
+            return std::numeric_limits<size_t>::max();
+        }
+
+      public /* Non-Modifying Functions / Capacity / Spatial Concept */:
+        /// \brief Get container dimensions
+        [[nodiscard]] size_t dimensions() const noexcept { return M; }
+
+        /// \brief Get maximum value in a given dimension
+        /// The page bounds are tight, so this only reads the root box.
+        dimension_type max_value(size_t dimension) const {
+            if (empty()) {
+                return std::numeric_limits<dimension_type>::min();
+            }
+            return root_.bounds.max()[dimension];
+        }
+
+        /// \brief Get minimum value in a given dimension
+        dimension_type min_value(size_t dimension) const {
+            if (empty()) {
+                return std::numeric_limits<dimension_type>::min();
+            }
+            return root_.bounds.min()[dimension];
+        }
+
+      public /* Non-Modifying Functions / Disk */:
+        /// \brief Number of elements in a leaf page
+        [[nodiscard]] size_t page_capacity() const {
+            return page_store::page_bytes(options_) / page_store::record_size;
+        }
+
+        /// \brief Number of children of an internal page
+        [[nodiscard]] size_t internal_page_capacity() const {
+            return page_store::page_bytes(options_) /
+                   page_store::entry_record_size;
+        }
+
+        /// \brief Number of levels of internal pages above the leaf pages
+        [[nodiscard]] size_t height() const noexcept { return height_; }
+
+        /// \brief Number of leaf and internal pages in the container
+        [[nodiscard]] size_t number_of_pages() const noexcept {
+            return store_ ? store_->pages_in_use() : 0;
+        }
+
+        /// \brief Number of pages in the buffer pool
+        [[nodiscard]] size_t buffer_pool_size() const noexcept {
+            return store_ ? store_->pool_size() : 0;
+        }
+
+        /// \brief Number of pages read from the page file
+        [[nodiscard]] size_t page_reads() const noexcept {
+            return store_ ? store_->reads() : 0;
+        }
+
+        /// \brief Number of pages written to the page file
+        [[nodiscard]] size_t page_writes() const noexcept {
+            return store_ ? store_->writes() : 0;
+        }
+
+        /// \brief Options of the container
+        [[nodiscard]] const disk_tree_options &options() const noexcept {
+            return options_;
+        }
+
+        /// \brief Write the modified pages in the buffer pool to the file
+        void flush() {
+            if (store_) {
+                store_->flush();
+            }
+        }
+
+      public /* Modifying Functions: Container + AllocatorAwareContainer */:
+        /// \brief Swap the content of two objects
+        void swap(disk_tree &other) noexcept {
+            std::swap(options_, other.options_);
+            std::swap(comp_, other.comp_);
+            std::swap(root_, other.root_);
+            std::swap(height_, other.height_);
+            store_.swap(other.store_);
+            std::swap(size_, other.size_);
+        }
+
+      public /* Modifiers: Multimap Concept */:
+        /// \brief Clear the container
+        /// The page file is kept for the next elements.
+        void clear() noexcept {
+            reset_root();
+            if (store_) {
+                store_->release_all();
+            }
+        }
+
+        /// \brief Insert element pair
+        /// The element goes down the children whose bounding boxes need
+        /// the least enlargement. Full pages are split in two.
+        iterator insert(const value_type &v) { return insert_element(v); }
+
+        /// \brief Insert element pair
+        iterator insert(value_type &&v) { return insert_element(std::move(v)); }
+
+        template <class P> iterator insert(P &&v) {
+            static_assert(std::is_constructible_v<value_type, P &&>);
+            return emplace(std::forward<P>(v));
+        }
+
+        /// \brief Insert element with a hint
+        iterator insert(iterator, const value_type &v) { return insert(v); }
+
+        iterator insert(const_iterator, const value_type &v) {
+            return insert(v);
+        }
+
+        iterator insert(const_iterator, value_type &&v) {
+            return insert(std::move(v));
+        }
+
+        template <class P> iterator insert(const_iterator hint, P &&v) {
+            static_assert(std::is_constructible_v<value_type, P &&>);
+            return emplace_hint(hint, std::forward<P>(v));
+        }
+
+        /// \brief Insert list of elements
+        /// Batches with at least a page of elements are packed into new
+        /// pages with the sort-tile-recursive algorithm.
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            std::vector<unprotected_value_type> batch;
+            for (; first != last; ++first) {
+                batch.emplace_back(first->first, first->second);
+            }
+            if (batch.size() < page_capacity()) {
+                for (unprotected_value_type &v : batch) {
+                    insert_element(value_type(v.first, std::move(v.second)));
+                }
+            } else {
+                bulk_insert(batch);
+            }
+        }
+
+        /// \brief Insert list of elements
+        void insert(std::initializer_list<value_type> init) {
+            insert(init.begin(), init.end());
+        }
+
+        template <class... Args> iterator emplace(Args &&...args) {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+
+        template <class... Args>
+        iterator emplace_hint(const_iterator, Args &&...args) {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+
+        /// \brief Erase element
+        /// The bounding boxes on the path to the element are tightened,
+        /// and the pages that become empty are removed from their parents.
+        iterator erase(const_iterator position) {
+            if (position == end()) {
+                return end();
+            }
+
+            // remember the element after the erased one
+            const_iterator next(this);
+            next.path_ = position.path_;
+            next.frame_ = position.frame_;
+            next.slot_ = position.slot_;
+            next.advance();
+            const bool next_is_end = next.is_end();
+            size_t next_leaf = 0;
+            size_t next_index = 0;
+            key_type next_key;
+            if (!next_is_end) {
+                next_leaf = next.frame_->slot;
+                next_index = next.slot_;
+                next_key = next->first;
+            }
+            next.set_end();
+
+            // remove the element from its leaf
+            frame_ptr leaf = position.frame_;
+            const size_t erased_index = position.slot_;
+            page_elements_type rest(leaf->elements.get_allocator());
+            rest.reserve(page_capacity() + 1);
+            for (size_t i = 0; i < leaf->elements.size(); ++i) {
+                if (i != erased_index) {
+                    rest.emplace_back(std::move(leaf->elements[i]));
+                }
+            }
+            leaf->elements.swap(rest);
+            leaf->dirty = true;
+            --size_;
+
+            // update the entries on the path to the leaf
+            size_t child_slot = leaf->slot;
+            size_t child_size = leaf->elements.size();
+            box_type child_bounds =
+                child_size != 0 ? bounds_of(leaf->elements) : box_type();
+            const path_type &path = position.path_;
+            for (auto level = path.rbegin(); level != path.rend(); ++level) {
+                frame_ptr f = load(level->slot, level->size, false);
+                auto entry = f->entries.begin() +
+                             static_cast<difference_type>(level->index);
+                if (child_size == 0) {
+                    store_->release(child_slot);
+                    f->entries.erase(entry);
+                } else {
+                    entry->bounds = child_bounds;
+                    entry->size = child_size;
+                }
+                f->dirty = true;
+                child_slot = f->slot;
+                child_size = f->entries.size();
+                if (child_size != 0) {
+                    child_bounds = bounds_of_entries(f->entries);
+                }
+            }
+            if (child_size == 0) {
+                store_->release(child_slot);
+                reset_root();
+                return end();
+            }
+            root_.bounds = child_bounds;
+            root_.size = child_size;
+            collapse_root();
+
+            if (next_is_end) {
+                return end();
+            }
+            if (next_leaf == leaf->slot) {
+                next_index = erased_index;
+            }
+            return iterator_to<iterator>(next_leaf, next_index, next_key);
+        }
+
+        iterator erase(iterator position) {
+            return erase(const_iterator(position));
+        }
+
+        /// \brief Remove range of iterators from the container
+        iterator erase(const_iterator first, const_iterator last) {
+            // get copy of all elements in the query
+            std::vector<value_type> v(first, last);
+            iterator next = end();
+            // remove using these copies as reference
+            for (const value_type &x : v) {
+                auto it = find_intersection(x.first, x.first,
+                                            [&x](const value_type &a) {
+                                                return mapped_type_custom_equality_operator(
+                                                    a.second, x.second);
+                                            });
+                if (it != end()) {
+                    next = erase(it);
+                }
+            }
+            return next;
+        }
+
+        /// \brief Erase element by value
+        size_t erase(const key_type &k) {
+            // k might be a reference to the element
+            // we are about to delete
+            key_type k_copy(k);
+            iterator it = find(k_copy);
+            size_type s = 0;
+            while (it != end()) {
+                erase(it);
+                ++s;
+                it = find(k_copy);
+            }
+            return s;
+        }
+
+        /// \brief Splices nodes from another container
+        void merge(disk_tree &source) noexcept {
+            insert(source.begin(), source.end());
+            source.clear();
+        }
+
+      public /* Lookup / Multimap Concept */:
+        /// \brief Returns the number of elements with key that compares
+        /// equivalent to the specified argument.
+        size_type count(const key_type &k) const {
+            return static_cast<size_type>(
+                std::distance(find_intersection(k), end()));
+        }
+
+        /// \brief Returns the number of elements with key that compares
+        /// equivalent to the specified argument.
+        template <class L> size_type count(const L &k) const {
+            return count(key_type(k));
+        }
+
+        /// \brief Find point
+        iterator find(const key_type &p) {
+            return iterator(
+                this, [p](const value_type &v) { return v.first == p; },
+                [p](const box_type &b) { return b.contains(p); });
+        }
+
+        /// \brief Find point
+        const_iterator find(const key_type &p) const {
+            return const_iterator(
+                this, [p](const value_type &v) { return v.first == p; },
+                [p](const box_type &b) { return b.contains(p); });
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> iterator find(const L &x) {
+            return find(key_type(x));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> const_iterator find(const L &x) const {
+            return find(key_type(x));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        bool contains(const key_type &k) const { return find(k) != end(); }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> bool contains(const L &x) const {
+            return find(x) != end();
+        }
+
+      public /* Modifiers: Lookup / Spatial Concept */:
+        /// \brief Get iterator to first element that passes the list of
+        /// predicates
+        const_iterator find(const predicate_list_type &ps) const noexcept {
+            return const_iterator(
+                this,
+                [ps](const value_type &v) { return ps.pass_predicate(v); },
+                [ps](const box_type &b) {
+                    return ps.might_pass_predicate(b);
+                });
+        }
+
+        /// \brief Get iterator to first element that passes the list of
+        /// predicates
+        iterator find(const predicate_list_type &ps) noexcept {
+            return iterator(
+                this,
+                [ps](const value_type &v) { return ps.pass_predicate(v); },
+                [ps](const box_type &b) {
+                    return ps.might_pass_predicate(b);
+                });
+        }
+
+        /// \brief Find intersection between points and query box
+        iterator find_intersection(const point_type &k) {
+            return find_intersection(k, k);
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator find_intersection(const point_type &k) const {
+            return find_intersection(k, k);
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator find_intersection(const point_type &lb,
+                                         const point_type &ub) const {
+            return find_intersection(lb, ub, nullptr);
+        }
+
+        /// \brief Find intersection between points and query box
+        iterator find_intersection(const point_type &lb, const point_type &ub) {
+            return find_intersection(lb, ub, nullptr);
+        }
+
+        template <class PREDICATE_TYPE>
+        const_iterator find_intersection(const point_type &lb,
+                                         const point_type &ub,
+                                         PREDICATE_TYPE fn) const {
+            return query<const_iterator>(
+                intersects<dimension_type, number_of_compile_dimensions>(lb,
+                                                                         ub),
+                fn);
+        }
+
+        template <class PREDICATE_TYPE>
+        iterator find_intersection(const point_type &lb, const point_type &ub,
+                                   PREDICATE_TYPE fn) {
+            return query<iterator>(
+                intersects<dimension_type, number_of_compile_dimensions>(lb,
+                                                                         ub),
+                fn);
+        }
+
+        /// \brief Find points within a query box
+        const_iterator find_within(const point_type &lb,
+                                   const point_type &ub) const {
+            return query<const_iterator>(
+                within<dimension_type, number_of_compile_dimensions>(lb, ub),
+                nullptr);
+        }
+
+        /// \brief Find points within a query box
+        iterator find_within(const point_type &lb, const point_type &ub) {
+            return query<iterator>(
+                within<dimension_type, number_of_compile_dimensions>(lb, ub),
+                nullptr);
+        }
+
+        /// \brief Find points outside a query box
+        const_iterator find_disjoint(const point_type &lb,
+                                     const point_type &ub) const {
+            return find_disjoint(lb, ub, nullptr);
+        }
+
+        /// \brief Find points outside a query box
+        iterator find_disjoint(const point_type &lb, const point_type &ub) {
+            return find_disjoint(lb, ub, nullptr);
+        }
+
+        /// \brief Find points outside a query box
+        template <class PREDICATE_TYPE>
+        const_iterator find_disjoint(const point_type &lb, const point_type &ub,
+                                     PREDICATE_TYPE fn) const {
+            return query<const_iterator>(
+                disjoint<dimension_type, number_of_compile_dimensions>(lb, ub),
+                fn);
+        }
+
+        /// \brief Find points outside a query box
+        template <class PREDICATE_TYPE>
+        iterator find_disjoint(const point_type &lb, const point_type &ub,
+                               PREDICATE_TYPE fn) {
+            return query<iterator>(
+                disjoint<dimension_type, number_of_compile_dimensions>(lb, ub),
+                fn);
+        }
+
+        /// \brief Find points closest to a reference point
+        const_iterator find_nearest(const point_type &p) const {
+            return find_nearest(p, 1);
+        }
+
+        /// \brief Find points closest to a reference point
+        iterator find_nearest(const point_type &p) {
+            return find_nearest(p, 1);
+        }
+
+        /// \brief Find k nearest points
+        const_iterator find_nearest(const point_type &p, size_t k) const {
+            return find_nearest(p, k, nullptr);
+        }
+
+        /// \brief Find k nearest points
+        iterator find_nearest(const point_type &p, size_t k) {
+            return find_nearest(p, k, nullptr);
+        }
+
+        template <class PREDICATE_TYPE>
+        const_iterator find_nearest(const point_type &p, size_t k,
+                                    PREDICATE_TYPE fn) const {
+            return nearest<const_iterator>(box_type(p, p), k, fn);
+        }
+
+        template <class PREDICATE_TYPE>
+        iterator find_nearest(const point_type &p, size_t k,
+                              PREDICATE_TYPE fn) {
+            return nearest<iterator>(box_type(p, p), k, fn);
+        }
+
+        /// \brief Find points closest to a reference box
+        const_iterator find_nearest(const box_type &b, size_t k = 1) const {
+            return nearest<const_iterator>(b, k, nullptr);
+        }
+
+        /// \brief Find points closest to a reference box
+        iterator find_nearest(const box_type &b, size_t k = 1) {
+            return nearest<iterator>(b, k, nullptr);
+        }
+
+        template <class PREDICATE_TYPE>
+        const_iterator find_nearest(const box_type &b, size_t k,
+                                    PREDICATE_TYPE fn) const {
+            return nearest<const_iterator>(b, k, fn);
+        }
+
+        template <class PREDICATE_TYPE>
+        iterator find_nearest(const box_type &b, size_t k, PREDICATE_TYPE fn) {
+            return nearest<iterator>(b, k, fn);
+        }
+
+        /// \brief Get iterator to element with maximum value in a given
+        /// dimension
+        /// Only the pages on the path to the element are read.
+        iterator max_element(size_t dimension) {
+            return extreme_element<iterator>(dimension, true);
+        }
+
+        /// \brief Get iterator to element with maximum value in a given
+        /// dimension
+        const_iterator max_element(size_t dimension) const {
+            return extreme_element<const_iterator>(dimension, true);
+        }
+
+        /// \brief Get iterator to element with minimum value in a given
+        /// dimension
+        iterator min_element(size_t dimension) {
+            return extreme_element<iterator>(dimension, false);
+        }
+
+        /// \brief Get iterator to element with minimum value in a given
+        /// dimension
+        const_iterator min_element(size_t dimension) const {
+            return extreme_element<const_iterator>(dimension, false);
+        }
+
+      public /* Observers: AssociativeContainer */:
+        /// \brief Returns the function object that compares keys
+        key_compare key_comp() const noexcept {
+            return [this](const key_type &a, const key_type &b) {
+                return std::lexicographical_compare(a.begin(), a.end(),
+                                                    b.begin(), b.end(), comp_);
+            };
+        }
+
+        /// \brief Returns the function object that compares values
+        value_compare value_comp() const noexcept {
+            return [this](const value_type &a, const value_type &b) {
+                return std::lexicographical_compare(
+                    a.first.begin(), a.first.end(), b.first.begin(),
+                    b.first.end(), comp_);
+            };
+        }
+
+        /// \brief Returns the function object that compares numbers
+        /// This is the comparison operator for a single dimension
+        dimension_compare dimension_comp() const noexcept { return comp_; }
+
+      private /* Pages */:
+        /// \brief Page store, created on demand
+        page_store &store() {
+            if (!store_) {
+                store_ = std::make_unique<page_store>(
+                    options_, protected_allocator_type(alloc_));
+            }
+            return *store_;
+        }
+
+        /// \brief Get a page from the buffer pool
+        frame_ptr load(size_t slot, size_t size, bool is_leaf) const {
+            count_work(&work_stats::nodes_visited);
+            return store_->acquire(slot, size, is_leaf);
+        }
+
+        /// \brief Get the page an entry refers to from the buffer pool
+        frame_ptr load(const page_entry &e, bool is_leaf) const {
+            return load(e.slot, e.size, is_leaf);
+        }
+
+        /// \brief Forget all pages without releasing them
+        void reset_root() noexcept {
+            root_ = page_entry{};
+            height_ = 0;
+            size_ = 0;
+        }
+
+        /// \brief Bounding box of a list of elements
+        template <class Elements>
+        static box_type bounds_of(const Elements &elements) {
+            box_type b(elements.front().first, elements.front().first);
+            for (const auto &v : elements) {
+                b.stretch(v.first);
+            }
+            return b;
+        }
+
+        /// \brief Bounding box of a list of child entries
+        static box_type bounds_of_entries(const std::vector<page_entry> &entries) {
+            box_type b = entries.front().bounds;
+            for (const page_entry &e : entries) {
+                b.stretch(e.bounds);
+            }
+            return b;
+        }
+
+        /// \brief Longest dimension of a box
+        static size_t longest_dimension(const box_type &b) {
+            size_t axis = 0;
+            for (size_t i = 1; i < M; ++i) {
+                if (b.max()[i] - b.min()[i] > b.max()[axis] - b.min()[axis]) {
+                    axis = i;
+                }
+            }
+            return axis;
+        }
+
+        /// \brief Child whose bounding box needs the least enlargement
+        /// Pages are often flat on a front, so ties in volume
+        /// enlargement are broken by margin enlargement.
+        static size_t choose_subtree(const std::vector<page_entry> &entries,
+                                     const box_type &b) {
+            size_t best = 0;
+            double best_enlargement = std::numeric_limits<double>::max();
+            double best_margin = std::numeric_limits<double>::max();
+            for (size_t i = 0; i < entries.size(); ++i) {
+                const box_type &e = entries[i].bounds;
+                if (e.contains(b)) {
+                    return i;
+                }
+                const box_type c = e.combine(b);
+                const double enlargement = static_cast<double>(c.volume()) -
+                                           static_cast<double>(e.volume());
+                const double margin = static_cast<double>(c.edge_deltas()) -
+                                      static_cast<double>(e.edge_deltas());
+                if (enlargement < best_enlargement ||
+                    (enlargement == best_enlargement && margin < best_margin)) {
+                    best = i;
+                    best_enlargement = enlargement;
+                    best_margin = margin;
+                }
+            }
+            return best;
+        }
+
+        /// \brief Where an element was placed
+        struct placement {
+            size_t slot;
+            size_t index;
+        };
+
+        /// \brief Insert element and return an iterator to it
+        iterator insert_element(value_type v) {
+            const key_type k = v.first;
+            placement placed{0, 0};
+            if (empty()) {
+                frame_ptr f = store().create(true);
+                f->elements.emplace_back(std::move(v));
+                root_ = page_entry{box_type(k, k), f->slot, 1};
+                height_ = 0;
+                size_ = 1;
+                return iterator_to<iterator>(f->slot, 0, k);
+            }
+            std::optional<page_entry> sibling =
+                insert_value(root_, height_, std::move(v), placed);
+            if (sibling) {
+                grow_root(*sibling);
+            }
+            ++size_;
+            return iterator_to<iterator>(placed.slot, placed.index, k);
+        }
+
+        /// \brief Insert element in the subtree of a page
+        /// \param node Entry of the page, updated with its new size and box
+        /// \param level Level of the page (0 for leaf pages)
+        /// \return Entry of the new page if the page was split
+        std::optional<page_entry> insert_value(page_entry &node, size_t level,
+                                               value_type &&v,
+                                               placement &placed) {
+            const key_type k = v.first;
+            if (level == 0) {
+                frame_ptr f = load(node, true);
+                f->elements.emplace_back(std::move(v));
+                f->dirty = true;
+                node.bounds.stretch(k);
+                node.size = f->elements.size();
+                placed = placement{f->slot, node.size - 1};
+                if (node.size <= store_->leaf_capacity()) {
+                    return std::nullopt;
+                }
+                return split_leaf(node, f, placed);
+            }
+            frame_ptr f = load(node, false);
+            const size_t i = choose_subtree(f->entries, box_type(k, k));
+            std::optional<page_entry> sibling =
+                insert_value(f->entries[i], level - 1, std::move(v), placed);
+            if (sibling) {
+                f->entries.emplace_back(*sibling);
+            }
+            f->dirty = true;
+            node.bounds.stretch(k);
+            node.size = f->entries.size();
+            if (node.size <= store_->internal_capacity()) {
+                return std::nullopt;
+            }
+            return split_internal(node, f);
+        }
+
+        /// \brief Insert a subtree in the pages of a level
+        /// \param node Entry of the page, updated with its new size and box
+        /// \param level Level of the page
+        /// \param e Entry of the subtree
+        /// \param target_level Level of the pages that get the entry
+        /// \return Entry of the new page if the page was split
+        std::optional<page_entry> insert_entry(page_entry &node, size_t level,
+                                               const page_entry &e,
+                                               size_t target_level) {
+            frame_ptr f = load(node, false);
+            if (level == target_level) {
+                f->entries.emplace_back(e);
+            } else {
+                const size_t i = choose_subtree(f->entries, e.bounds);
+                std::optional<page_entry> sibling =
+                    insert_entry(f->entries[i], level - 1, e, target_level);
+                if (sibling) {
+                    f->entries.emplace_back(*sibling);
+                }
+            }
+            f->dirty = true;
+            node.bounds.stretch(e.bounds);
+            node.size = f->entries.size();
+            if (node.size <= store_->internal_capacity()) {
+                return std::nullopt;
+            }
+            return split_internal(node, f);
+        }
+
+        /// \brief Add a level above the root with the root and its new
+        /// sibling
+        void grow_root(const page_entry &sibling) {
+            frame_ptr f = store_->create(false);
+            f->entries.emplace_back(root_);
+            f->entries.emplace_back(sibling);
+            root_ = page_entry{bounds_of_entries(f->entries), f->slot, 2};
+            ++height_;
+        }
+
+        /// \brief Remove root pages with a single child
+        void collapse_root() {
+            while (height_ > 0 && root_.size == 1) {
+                frame_ptr f = load(root_, false);
+                const page_entry child = f->entries.front();
+                store_->release(root_.slot);
+                root_ = child;
+                --height_;
+            }
+        }
+
+        /// \brief Split an overflowing leaf page along its longest
+        /// dimension
+        /// \return Entry of the new page
+        page_entry split_leaf(page_entry &node, frame_ptr &f,
+                              placement &placed) {
+            count_work(&work_stats::node_splits);
+            const size_t axis = longest_dimension(node.bounds);
+            const size_t n = f->elements.size();
+            std::vector<size_t> order(n);
+            std::iota(order.begin(), order.end(), size_t{0});
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t c) {
+                return f->elements[a].first[axis] < f->elements[c].first[axis];
+            });
+            page_elements_type old_elements(f->elements.get_allocator());
+            old_elements.swap(f->elements);
+            f->elements.reserve(store_->leaf_capacity() + 1);
+            frame_ptr g = store_->create(true);
+            const size_t half = n / 2;
+            const size_t placed_index = placed.index;
+            for (size_t i = 0; i < n; ++i) {
+                frame &target = i < half ? *f : *g;
+                if (order[i] == placed_index) {
+                    placed = placement{target.slot, target.elements.size()};
+                }
+                target.elements.emplace_back(std::move(old_elements[order[i]]));
+            }
+            node.bounds = bounds_of(f->elements);
+            node.size = f->elements.size();
+            return page_entry{bounds_of(g->elements), g->slot,
+                              g->elements.size()};
+        }
+
+        /// \brief Split an overflowing internal page along its longest
+        /// dimension
+        /// \return Entry of the new page
+        page_entry split_internal(page_entry &node, frame_ptr &f) {
+            count_work(&work_stats::node_splits);
+            const size_t axis = longest_dimension(node.bounds);
+            std::sort(f->entries.begin(), f->entries.end(),
+                      [axis](const page_entry &a, const page_entry &b) {
+                          return a.bounds.min()[axis] + a.bounds.max()[axis] <
+                                 b.bounds.min()[axis] + b.bounds.max()[axis];
+                      });
+            frame_ptr g = store_->create(false);
+            const auto half =
+                static_cast<difference_type>(f->entries.size() / 2);
+            g->entries.assign(f->entries.begin() + half, f->entries.end());
+            f->entries.erase(f->entries.begin() + half, f->entries.end());
+            f->dirty = true;
+            node.bounds = bounds_of_entries(f->entries);
+            node.size = f->entries.size();
+            return page_entry{bounds_of_entries(g->entries), g->slot,
+                              g->entries.size()};
+        }
+
+        /// \brief Insert a batch of elements
+        /// The batch is packed into leaf pages. An empty container gets
+        /// the upper levels packed from these pages. Otherwise, the pages
+        /// are inserted as subtrees in the level above the leaf pages.
+        void bulk_insert(std::vector<unprotected_value_type> &batch) {
+            std::vector<page_entry> leaves;
+            pack_leaves(batch.begin(), batch.end(), 0, leaves);
+            if (empty()) {
+                build_upper_levels(std::move(leaves));
+                size_ = batch.size();
+                return;
+            }
+            if (height_ == 0) {
+                frame_ptr f = store_->create(false);
+                f->entries.emplace_back(root_);
+                root_ = page_entry{root_.bounds, f->slot, 1};
+                height_ = 1;
+            }
+            for (const page_entry &leaf : leaves) {
+                std::optional<page_entry> sibling =
+                    insert_entry(root_, height_, leaf, 1);
+                if (sibling) {
+                    grow_root(*sibling);
+                }
+            }
+            size_ += batch.size();
+        }
+
+        /// \brief Pack elements into new leaf pages with sort-tile-recursive
+        /// The elements are sorted by one dimension and cut into slabs,
+        /// and each slab is packed by the next dimensions.
+        template <class RandomIt>
+        void pack_leaves(RandomIt first, RandomIt last, size_t dimension,
+                         std::vector<page_entry> &leaves) {
+            const size_t n = static_cast<size_t>(std::distance(first, last));
+            if (n == 0) {
+                return;
+            }
+            const size_t capacity = store().leaf_capacity();
+            std::sort(first, last, [dimension](const auto &a, const auto &b) {
+                return a.first[dimension] < b.first[dimension];
+            });
+            const bool is_last_dimension = dimension + 1 == M;
+            if (n <= capacity || is_last_dimension) {
+                for (RandomIt it = first; it != last;) {
+                    const size_t page_size = std::min(
+                        capacity, static_cast<size_t>(std::distance(it, last)));
+                    frame_ptr f = store_->create(true);
+                    for (size_t i = 0; i < page_size; ++i, ++it) {
+                        f->elements.emplace_back(it->first,
+                                                 std::move(it->second));
+                    }
+                    leaves.push_back(page_entry{bounds_of(f->elements), f->slot,
+                                                f->elements.size()});
+                }
+                return;
+            }
+            const double n_pages = std::ceil(static_cast<double>(n) /
+                                             static_cast<double>(capacity));
+            const double n_slabs = std::ceil(std::pow(
+                n_pages, 1. / static_cast<double>(M - dimension)));
+            const size_t slab_size =
+                capacity * static_cast<size_t>(std::ceil(n_pages / n_slabs));
+            for (RandomIt it = first; it != last;) {
+                const size_t s = std::min(
+                    slab_size, static_cast<size_t>(std::distance(it, last)));
+                pack_leaves(it, it + static_cast<difference_type>(s),
+                            dimension + 1, leaves);
+                it += static_cast<difference_type>(s);
+            }
+        }
+
+        /// \brief Pack the entries of a level into the levels above it
+        /// The sort-tile-recursive order of the leaf pages keeps
+        /// neighbouring pages together, so consecutive entries share
+        /// their parents.
+        void build_upper_levels(std::vector<page_entry> entries) {
+            height_ = 0;
+            const size_t capacity = store_->internal_capacity();
+            while (entries.size() > 1) {
+                std::vector<page_entry> parents;
+                for (size_t i = 0; i < entries.size(); i += capacity) {
+                    const size_t last = std::min(i + capacity, entries.size());
+                    frame_ptr f = store_->create(false);
+                    f->entries.assign(
+                        entries.begin() + static_cast<difference_type>(i),
+                        entries.begin() + static_cast<difference_type>(last));
+                    parents.push_back(page_entry{bounds_of_entries(f->entries),
+                                                 f->slot, f->entries.size()});
+                }
+                entries.swap(parents);
+                ++height_;
+            }
+            root_ = entries.front();
+        }
+
+        /// \brief Copy all pages from another container
+        void copy_pages(const disk_tree &rhs) {
+            if (rhs.empty()) {
+                reset_root();
+                return;
+            }
+            root_ = copy_page(rhs, rhs.root_, rhs.height_);
+            height_ = rhs.height_;
+            size_ = rhs.size_;
+        }
+
+        /// \brief Copy a page and its subtree from another container
+        page_entry copy_page(const disk_tree &rhs, const page_entry &e,
+                             size_t level) {
+            if (level == 0) {
+                frame_ptr source = rhs.load(e, true);
+                frame_ptr f = store().create(true);
+                for (const value_type &v : source->elements) {
+                    f->elements.emplace_back(v);
+                }
+                return page_entry{e.bounds, f->slot, e.size};
+            }
+            frame_ptr source = rhs.load(e, false);
+            std::vector<page_entry> children;
+            children.reserve(source->entries.size());
+            for (const page_entry &child : source->entries) {
+                children.emplace_back(copy_page(rhs, child, level - 1));
+            }
+            frame_ptr f = store().create(false);
+            f->entries = std::move(children);
+            return page_entry{e.bounds, f->slot, e.size};
+        }
+
+        /// \brief Iterator to an element in a leaf page
+        /// The path to the leaf is found by descending into the pages
+        /// whose bounding boxes contain the key of the element.
+        template <class Iterator>
+        Iterator iterator_to(size_t leaf_slot, size_t index,
+                             const key_type &k) const {
+            Iterator it(this);
+            if (height_ == 0) {
+                it.enter_leaf(root_, index);
+                return it;
+            }
+            it.path_.push_back(path_level{root_.slot, root_.size, 0});
+            if (find_leaf_path(it.path_, leaf_slot, k)) {
+                const path_level &last = it.path_.back();
+                frame_ptr f = load(last.slot, last.size, false);
+                it.enter_leaf(f->entries[last.index], index);
+            } else {
+                it.set_end();
+            }
+            return it;
+        }
+
+        /// \brief Complete the path to a leaf page with a given key
+        bool find_leaf_path(path_type &path, size_t leaf_slot,
+                            const key_type &k) const {
+            const path_level top = path.back();
+            frame_ptr f = load(top.slot, top.size, false);
+            const bool children_are_leaves = path.size() == height_;
+            for (size_t i = 0; i < f->entries.size(); ++i) {
+                const page_entry &e = f->entries[i];
+                if (!e.bounds.contains(k)) {
+                    continue;
+                }
+                path.back().index = i;
+                if (children_are_leaves) {
+                    if (e.slot == leaf_slot) {
+                        return true;
+                    }
+                    continue;
+                }
+                path.push_back(path_level{e.slot, e.size, 0});
+                if (find_leaf_path(path, leaf_slot, k)) {
+                    return true;
+                }
+                path.pop_back();
+            }
+            return false;
+        }
+
+        /// \brief Iterator to the elements that pass a predicate
+        /// The predicate is also used to skip subtrees.
+        template <class Iterator, class PREDICATE, class PREDICATE_TYPE>
+        Iterator query(const PREDICATE &p, PREDICATE_TYPE fn) const {
+            std::function<bool(const value_type &)> query_fn;
+            if constexpr (std::is_same_v<PREDICATE_TYPE, std::nullptr_t>) {
+                query_fn = [p](const value_type &v) {
+                    return p.pass_predicate(v.first);
+                };
+            } else {
+                query_fn = [p, fn](const value_type &v) {
+                    return p.pass_predicate(v.first) && fn(v);
+                };
+            }
+            return Iterator(this, std::move(query_fn), [p](const box_type &b) {
+                return p.might_pass_predicate(b);
+            });
+        }
+
+        /// \brief Lower bound for the distance between two boxes
+        static double box_distance(const box_type &a, const box_type &b) {
+            double dist = 0.;
+            for (size_t i = 0; i < M; ++i) {
+                double d = 0.;
+                if (a.max()[i] < b.min()[i]) {
+                    d = static_cast<double>(b.min()[i] - a.max()[i]);
+                } else if (b.max()[i] < a.min()[i]) {
+                    d = static_cast<double>(a.min()[i] - b.max()[i]);
+                }
+                dist += d * d;
+            }
+            return std::sqrt(dist);
+        }
+
+        /// \brief Iterator to the k elements closest to a box
+        /// This is a best-first search: pages are read in order of
+        /// distance until the next page is farther than the k-th closest
+        /// element found so far.
+        template <class Iterator, class PREDICATE_TYPE>
+        Iterator nearest(const box_type &b, size_t k, PREDICATE_TYPE fn) const {
+            if (k == 0 || empty()) {
+                return Iterator(this);
+            }
+            // min-heap of pages by distance
+            using page_candidate = std::tuple<double, size_t, page_entry>;
+            auto page_greater = [](const page_candidate &x,
+                                   const page_candidate &y) {
+                return std::get<0>(x) > std::get<0>(y);
+            };
+            std::priority_queue<page_candidate, std::vector<page_candidate>,
+                                decltype(page_greater)>
+                pages(page_greater);
+            pages.emplace(box_distance(root_.bounds, b), height_, root_);
+            // max-heap of the k closest elements found so far
+            std::priority_queue<std::pair<double, key_type>,
+                                std::vector<std::pair<double, key_type>>,
+                                std::function<bool(
+                                    const std::pair<double, key_type> &,
+                                    const std::pair<double, key_type> &)>>
+                closest([](const auto &x, const auto &y) {
+                    return x.first < y.first;
+                });
+            while (!pages.empty()) {
+                const auto [page_distance, level, e] = pages.top();
+                pages.pop();
+                if (closest.size() == k && page_distance > closest.top().first) {
+                    break;
+                }
+                if (level != 0) {
+                    frame_ptr f = load(e, false);
+                    for (const page_entry &child : f->entries) {
+                        const double d = box_distance(child.bounds, b);
+                        if (closest.size() < k || d <= closest.top().first) {
+                            pages.emplace(d, level - 1, child);
+                        }
+                    }
+                    continue;
+                }
+                frame_ptr f = load(e, true);
+                for (const value_type &v : f->elements) {
+                    if constexpr (!std::is_same_v<PREDICATE_TYPE,
+                                                  std::nullptr_t>) {
+                        if (!fn(v)) {
+                            continue;
+                        }
+                    }
+                    const double d = box_distance(box_type(v.first, v.first), b);
+                    if (closest.size() < k) {
+                        count_work(&work_stats::heap_pushes);
+                        closest.emplace(d, v.first);
+                    } else if (d < closest.top().first) {
+                        count_work(&work_stats::heap_pops);
+                        closest.pop();
+                        count_work(&work_stats::heap_pushes);
+                        closest.emplace(d, v.first);
+                    }
+                }
+            }
+            if (closest.empty()) {
+                return Iterator(this);
+            }
+            const double max_distance = closest.top().first;
+            std::vector<key_type> nearest_set;
+            nearest_set.reserve(closest.size());
+            while (!closest.empty()) {
+                nearest_set.emplace_back(closest.top().second);
+                count_work(&work_stats::heap_pops);
+                closest.pop();
+            }
+            return Iterator(
+                this,
+                [nearest_set, fn](const value_type &v) {
+                    if constexpr (!std::is_same_v<PREDICATE_TYPE,
+                                                  std::nullptr_t>) {
+                        if (!fn(v)) {
+                            return false;
+                        }
+                    }
+                    return std::find(nearest_set.begin(), nearest_set.end(),
+                                     v.first) != nearest_set.end();
+                },
+                [b, max_distance](const box_type &page_box) {
+                    return box_distance(page_box, b) <= max_distance;
+                });
+        }
+
+        /// \brief Iterator to the element with the extreme value in a
+        /// dimension
+        /// The bounding boxes are tight, so the child with the extreme
+        /// bound contains the extreme element.
+        template <class Iterator>
+        Iterator extreme_element(size_t dimension, bool maximum) const {
+            if (empty()) {
+                return Iterator(this);
+            }
+            auto is_better = [dimension, maximum](const box_type &a,
+                                                  const box_type &b) {
+                return maximum ? a.max()[dimension] > b.max()[dimension]
+                               : a.min()[dimension] < b.min()[dimension];
+            };
+            Iterator it(this);
+            page_entry e = root_;
+            for (size_t level = height_; level > 0; --level) {
+                frame_ptr f = load(e, false);
+                size_t best = 0;
+                for (size_t i = 1; i < f->entries.size(); ++i) {
+                    if (is_better(f->entries[i].bounds,
+                                  f->entries[best].bounds)) {
+                        best = i;
+                    }
+                }
+                it.path_.push_back(path_level{e.slot, e.size, best});
+                e = f->entries[best];
+            }
+            frame_ptr f = load(e, true);
+            auto cmp = [dimension](const value_type &a, const value_type &b) {
+                return a.first[dimension] < b.first[dimension];
+            };
+            auto el = maximum ? std::max_element(f->elements.begin(),
+                                                 f->elements.end(), cmp)
+                              : std::min_element(f->elements.begin(),
+                                                 f->elements.end(), cmp);
+            it.enter_leaf(e, static_cast<size_t>(el - f->elements.begin()));
+            return it;
+        }
+
+      private:
+        /// \brief Options used to create the page file
+        disk_tree_options options_;
+
+        /// \brief Allocator for the pages in the buffer pool
+        allocator_type alloc_;
+
+        dimension_compare comp_{dimension_compare()};
+
+        /// \brief Entry of the root page
+        /// This is the only entry that is always in memory.
+        page_entry root_;
+
+        /// \brief Number of levels of internal pages
+        size_t height_{0};
+
+        /// \brief Page file and buffer pool
+        std::unique_ptr<page_store> store_;
+
+        /// \brief Number of elements
+        size_t size_{0};
+    };
+
+    /* Non-Modifying Functions / Comparison / Container Concept */
+    /// \brief Equality operator
+    /// \warning This operator tells us if the trees are equal
+    /// and not if they contain the same elements.
+    template <class K, size_t M, class T, class C, class A, class D>
+    bool operator==(const disk_tree<K, M, T, C, A, D> &lhs,
+                    const disk_tree<K, M, T, C, A, D> &rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        return std::equal(
+            lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+            [](const typename disk_tree<K, M, T, C, A, D>::value_type &a,
+               const typename disk_tree<K, M, T, C, A, D>::value_type &b) {
+                return a.first == b.first &&
+                       mapped_type_custom_equality_operator(a.second, b.second);
+            });
+    }
+
+    /// \brief Inequality operator
+    template <class K, size_t M, class T, class C, class A, class D>
+    bool operator!=(const disk_tree<K, M, T, C, A, D> &lhs,
+                    const disk_tree<K, M, T, C, A, D> &rhs) {
+        return !(lhs == rhs);
+    }
+
+} // namespace pareto
+
+#endif // PARETO_DISK_TREE_H
@@ -1,6 +1,8 @@
 #ifndef PARETO_FRONTS_PARETO_FRONT_RTREE_H
 #define PARETO_FRONTS_PARETO_FRONT_RTREE_H
 
+#include <algorithm>
+#include <cmath>
 #include <initializer_list>
 #include <map>
 #include <memory>
@@ -9,12 +11,17 @@
 #include <ostream>
 #include <random>
 #include <thread>
+#include <unordered_map>
 
+#include <pareto/change_log.h>
+#include <pareto/operation_trace.h>
 #include <pareto/common/common.h>
 #include <pareto/common/hypervolume.h>
 #include <pareto/common/keywords.h>
 #include <pareto/common/metaprogramming.h>
+#include <pareto/common/parallel.h>
 #include <pareto/common/promote_to_floating_point.h>
+#include <pareto/common/random.h>
 
 #include <pareto/spatial_map.h>
 
@@ -28,6 +35,10 @@ namespace pareto {
     /// we finally deprecate boost_tree.
     template <typename K, size_t M, typename T, class Container> class archive;
 
+    /// Transactions access the front data directly to log and undo
+    /// modifications.
+    template <class Adapter> class transaction;
+
     /// \class Pareto Front
     /// The fronts have their dimension set at compile time
     /// If we set the dimension to 0, then it's defined at runtime
@@ -115,11 +126,15 @@ namespace pareto {
         /// on the allocator of the container being copied.
         /// \param rhs
         front(const front &rhs)
-            : data_(rhs.data_), is_minimization_(rhs.is_minimization_){};
+            : data_(rhs.data_), is_minimization_(rhs.is_minimization_),
+              generator_(rhs.generator_),
+              hypervolume_streams_(rhs.hypervolume_streams_){};
 
         /// \brief Copy constructor data but use another allocator
         front(const front &rhs, const allocator_type &alloc)
-            : data_(rhs.data_, alloc), is_minimization_(rhs.is_minimization_){};
+            : data_(rhs.data_, alloc), is_minimization_(rhs.is_minimization_),
+              generator_(rhs.generator_),
+              hypervolume_streams_(rhs.hypervolume_streams_){};
 
         /// \brief Move constructor
         /// Move constructors obtain their instances of allocators
@@ -127,12 +142,16 @@ namespace pareto {
         /// the old container
         front(front &&rhs) noexcept
             : data_(std::move(rhs.data_)),
-              is_minimization_(std::move(rhs.is_minimization_)) {}
+              is_minimization_(std::move(rhs.is_minimization_)),
+              generator_(rhs.generator_),
+              hypervolume_streams_(rhs.hypervolume_streams_) {}
 
         /// \brief Move constructor data but use new allocator
         front(front &&rhs, const allocator_type &alloc) noexcept
             : data_(std::move(rhs.data_), alloc),
-              is_minimization_(std::move(rhs.is_minimization_)) {}
+              is_minimization_(std::move(rhs.is_minimization_)),
+              generator_(rhs.generator_),
+              hypervolume_streams_(rhs.hypervolume_streams_) {}
 
         /// \brief Destructor
         ~front() = default;
@@ -352,6 +371,26 @@ namespace pareto {
         front(std::initializer_list<bool> il_dir, const allocator_type &alloc)
             : front({}, il_dir, alloc) {}
 
+      public /* Constructors: Adopt a container */:
+        /// \brief Adopt a container whose elements are already a front
+        /// The container is moved into the front without inserting its
+        /// elements one by one, so its elements cannot dominate each
+        /// other. Read-only containers, such as views of external memory,
+        /// can only be used through the const functions of the front.
+        explicit front(container_type &&data) : data_(std::move(data)) {
+            initialize_directions();
+            adopt_dimensions();
+        }
+
+        /// \brief Adopt a container whose elements are already a front
+        template <class DirectionIt>
+        front(container_type &&data, DirectionIt first_dir,
+              DirectionIt last_dir)
+            : data_(std::move(data)) {
+            initialize_directions(first_dir, last_dir);
+            adopt_dimensions();
+        }
+
       public /* Non-Modifying Functions: AllocatorAwareContainer */:
         /// \brief Obtains a copy of the allocator
         /// The accessor get_allocator() obtains a copy of
@@ -377,6 +416,10 @@ namespace pareto {
             }
             data_ = rhs.data_;
             is_minimization_ = rhs.is_minimization_;
+            generator_ = rhs.generator_;
+            hypervolume_streams_ = rhs.hypervolume_streams_;
+            log_reset();
+            record_reset();
             return *this;
         };
 
@@ -397,13 +440,17 @@ namespace pareto {
             }
             data_ = std::move(rhs.data_);
             is_minimization_ = std::move(rhs.is_minimization_);
+            generator_ = rhs.generator_;
+            hypervolume_streams_ = rhs.hypervolume_streams_;
+            log_reset();
+            record_reset();
             return *this;
         }
 
       public /* Assignment: AssociativeContainer */:
         /// \brief Initializer list assignment
         front &operator=(std::initializer_list<value_type> il) noexcept {
-            data_.clear();
+            clear();
             insert(il.begin(), il.end());
             return *this;
         }
@@ -424,11 +471,16 @@ namespace pareto {
         /// \brief Get reference to element at a given position, and throw error
         /// if it does not exist
         const mapped_type &at(const key_type &k) const {
-            auto it = find(k);
-            if (it != end()) {
-                return it->second;
+            if constexpr (is_view_container_v<container_type>) {
+                // the iterators of views own the element they point to
+                return data_.at(k);
             } else {
-                throw std::out_of_range("front::at: key not found");
+                auto it = find(k);
+                if (it != end()) {
+                    return it->second;
+                } else {
+                    throw std::out_of_range("front::at: key not found");
+                }
             }
         }
 
@@ -679,6 +731,8 @@ namespace pareto {
         /// \see
         /// http://www.cs.nott.ac.uk/~pszjds/research/files/dls_emo2009_1.pdf
         bool dominates(const point_type &p) const {
+            trace_scope trace(traced_operation::dominates, size());
+            recording_scope record(operation_trace_, trace_opcode::dominates, p);
             // trivial case: front is empty
             if (empty()) {
                 return false;
@@ -900,6 +954,9 @@ namespace pareto {
         /// \param reference_point Reference point
         /// \return Hypervolume of this front
         dimension_type hypervolume(point_type reference_point) const {
+            trace_scope trace(traced_operation::hypervolume, size());
+            recording_scope record(operation_trace_, trace_opcode::hypervolume,
+                                   reference_point);
             // reshape points
             std::vector<double> data;
             data.reserve(size() * dimensions());
@@ -939,37 +996,25 @@ namespace pareto {
 
         /// \brief Get hypervolume with monte-carlo simulation
         /// This function uses monte-carlo simulation as getting the
-        /// exact indicator is too costly.
+        /// exact indicator is too costly. Each call draws new samples
+        /// from the generator of this front (see seed), so repeated
+        /// calls give independent estimates, and the same seed gives
+        /// the same sequence of estimates for any number of threads.
         /// \param reference_point Reference for the hyper-volume
         /// \param sample_size Number of samples for the simulation
+        /// \param max_threads Maximum number of threads sampling points.
+        ///        The queries of the container should be safe to run
+        ///        concurrently for more than one thread.
         /// \return Hypervolume of the pareto front
         dimension_type hypervolume(size_t sample_size,
-                                   const point_type &reference_point) const {
-            double hv_upper_limit = 1;
-            auto m = ideal();
-            for (size_t i = 0; i < m.dimensions(); ++i) {
-                hv_upper_limit *= abs(reference_point[i] - m[i]);
-            }
-
-            size_t max_monte_carlo_iter = sample_size;
-            size_t hit = 0;
-            size_t miss = 0;
-            for (size_t i = 0; i < max_monte_carlo_iter; ++i) {
-                point_type rand(dimensions());
-                for (size_t j = 0; j < dimensions(); ++j) {
-                    std::uniform_real_distribution<
-                        promote_to_floating_point<dimension_type>>
-                        d(m[j], reference_point[j]);
-                    rand[j] = d(generator());
-                }
-                if (dominates(rand)) {
-                    hit++;
-                } else {
-                    miss++;
-                }
-            }
-
-            return hv_upper_limit * hit / static_cast<double>(hit + miss);
+                                   const point_type &reference_point,
+                                   size_t max_threads = 1) const {
+            trace_scope trace(traced_operation::hypervolume, size());
+            recording_scope record(operation_trace_, trace_opcode::hypervolume,
+                                   reference_point, sample_size);
+            return monte_carlo_hypervolume(
+                sample_size, reference_point,
+                generator_.split(hypervolume_streams_.next()), max_threads);
         }
 
         /// \brief Coverage indicator
@@ -1332,6 +1377,109 @@ namespace pareto {
             return static_cast<double>(conflict(a, b)) / denominator;
         }
 
+      public /* Level of detail */:
+        /// \brief Representative subset of the front for plotting
+        /// Plotting every element of a huge front is slow and does not
+        /// change the picture, because most elements fall on the same
+        /// pixels. We divide the bounding box of the front into a grid
+        /// and keep, for each non-empty cell, the elements with the lowest
+        /// and highest value in each dimension.
+        /// With two dimensions, the grid has resolution x resolution
+        /// cells, and the extremes of a cell are its first and last
+        /// elements along the staircase. The staircase is exact up to one
+        /// cell and at most 4 * resolution elements remain.
+        /// With more dimensions, the grid is coarser so that the front
+        /// surface crosses about resolution cells.
+        /// \param resolution Number of cells along each axis of a 2-d
+        ///        plot, such as the plot width in pixels
+        /// \return The representative elements, or a copy of the front if
+        ///         it has no more than resolution elements
+        front decimate(size_t resolution) const {
+            const size_t m = dimensions();
+            if (resolution == 0 || size() <= resolution || m < 2) {
+                return *this;
+            }
+            // cells per axis, such that cell ids fit in a size_t
+            auto cells_per_axis = m == 2 ? resolution
+                                         : static_cast<size_t>(std::pow(
+                                               static_cast<double>(resolution),
+                                               1. / static_cast<double>(m - 1)));
+            const auto max_cells_per_axis = static_cast<size_t>(std::pow(
+                2., std::floor(63. / static_cast<double>(m))));
+            cells_per_axis =
+                std::clamp(cells_per_axis, size_t(1), max_cells_per_axis);
+            std::vector<double> lower(m);
+            std::vector<double> width(m);
+            for (size_t i = 0; i < m; ++i) {
+                lower[i] = static_cast<double>(min_value(i));
+                width[i] = static_cast<double>(max_value(i)) - lower[i];
+            }
+            auto cell_of = [&](const key_type &k) {
+                size_t id = 0;
+                for (size_t i = 0; i < m; ++i) {
+                    size_t c = 0;
+                    if (width[i] > 0.) {
+                        c = std::min(
+                            static_cast<size_t>(
+                                (static_cast<double>(k[i]) - lower[i]) /
+                                width[i] * static_cast<double>(cells_per_axis)),
+                            cells_per_axis - 1);
+                    }
+                    id = id * cells_per_axis + c;
+                }
+                return id;
+            };
+
+            // First pass: the extremes of each cell. The iterators of some
+            // containers materialize their elements, so we store values
+            // rather than pointers to the elements.
+            std::unordered_map<size_t, size_t> cell_index;
+            std::vector<dimension_type> extremes;
+            for (const auto &[k, v] : data_) {
+                auto [it, inserted] =
+                    cell_index.emplace(cell_of(k), extremes.size());
+                if (inserted) {
+                    for (size_t i = 0; i < m; ++i) {
+                        extremes.emplace_back(k[i]);
+                        extremes.emplace_back(k[i]);
+                    }
+                } else {
+                    dimension_type *e = extremes.data() + it->second;
+                    for (size_t i = 0; i < m; ++i) {
+                        e[2 * i] = std::min(e[2 * i], k[i]);
+                        e[2 * i + 1] = std::max(e[2 * i + 1], k[i]);
+                    }
+                }
+            }
+
+            // Second pass: keep one element for each extreme
+            std::vector<uint8_t> taken(extremes.size(), 0);
+            std::vector<value_type> kept;
+            for (const auto &e : data_) {
+                const size_t offset = cell_index.find(cell_of(e.first))->second;
+                bool keep = false;
+                for (size_t i = 0; i < 2 * m; ++i) {
+                    if (!taken[offset + i] &&
+                        e.first[i / 2] == extremes[offset + i]) {
+                        taken[offset + i] = 1;
+                        keep = true;
+                    }
+                }
+                if (keep) {
+                    kept.emplace_back(e);
+                }
+            }
+
+            container_type loaded(kept.begin(), kept.end(),
+                                  data_.dimension_comp(),
+                                  data_.get_allocator());
+            front result(data_.get_allocator());
+            result.is_minimization_ = is_minimization_;
+            result.maybe_adjust_dimensions(loaded.dimensions());
+            result.data_ = std::move(loaded);
+            return result;
+        }
+
       public /* Modifying Functions: Container + AllocatorAwareContainer */:
         /// \brief Swap the content of two objects
         /// Swap will replace the allocator only if
@@ -1349,11 +1497,23 @@ namespace pareto {
         void swap(front &other) noexcept {
             other.data_.swap(data_);
             std::swap(is_minimization_, other.is_minimization_);
+            std::swap(generator_, other.generator_);
+            std::swap(hypervolume_streams_, other.hypervolume_streams_);
+            log_reset();
+            other.log_reset();
+            record_reset();
+            other.record_reset();
         }
 
       public /* Modifiers: Multimap Concept */:
         /// \brief Clear the front
-        void clear() noexcept { data_.clear(); }
+        /// This is not noexcept because the change log and the operation
+        /// trace might throw while recording the clear.
+        void clear() {
+            recording_scope record(operation_trace_, trace_opcode::clear);
+            data_.clear();
+            log_change(change_type::clear);
+        }
 
         /// \brief Insert element pair
         /// Insertion removes any point dominated by the point
@@ -1362,10 +1522,15 @@ namespace pareto {
         /// \return Iterator to the new element
         /// \return True if insertion happened successfully
         std::pair<iterator, bool> insert(const value_type &v) {
+            trace_scope trace(traced_operation::insert, size());
+            recording_scope record(operation_trace_, trace_opcode::insert,
+                                   v.first);
             maybe_adjust_dimensions(v);
             if (!dominates(v.first)) {
                 clear_dominated(v.first);
-                return {data_.insert(v), true};
+                iterator it = data_.insert(v);
+                log_change(change_type::insert, it->first);
+                return {it, true};
             }
             return {end(), false};
         }
@@ -1375,18 +1540,38 @@ namespace pareto {
         /// \return Iterator to the new element
         /// \return True if insertion happened successfully
         std::pair<iterator, bool> insert(value_type &&v) {
+            trace_scope trace(traced_operation::insert, size());
+            recording_scope record(operation_trace_, trace_opcode::insert,
+                                   v.first);
             maybe_adjust_dimensions(v);
             if (!dominates(v.first)) {
                 clear_dominated(v.first);
                 auto p = std::move(v);
-                return {data_.insert(p), true};
+                iterator it = data_.insert(p);
+                log_change(change_type::insert, it->first);
+                return {it, true};
             }
             return {end(), false};
         }
 
         template <class P> std::pair<iterator, bool> insert(P &&v) {
-            static_assert(std::is_constructible_v<value_type, P &&>);
-            return emplace(std::forward<P>(v));
+            if constexpr (is_key_only_v<mapped_type> &&
+                          std::is_convertible_v<P &&, key_type>) {
+                return insert(value_type(std::forward<P>(v), mapped_type()));
+            } else {
+                static_assert(std::is_constructible_v<value_type, P &&>);
+                return emplace(std::forward<P>(v));
+            }
+        }
+
+        /// \brief Insert a key in a container that only stores keys
+        /// \param k Point
+        /// \return Iterator to the new element
+        /// \return True if insertion happened successfully
+        template <class U = mapped_type,
+                  std::enable_if_t<is_key_only_v<U>, int> = 0>
+        std::pair<iterator, bool> insert(const key_type &k) {
+            return insert(value_type(k, mapped_type()));
         }
 
         /// \brief Insert element with a hint
@@ -1430,6 +1615,44 @@ namespace pareto {
             return s;
         }
 
+        /// \brief Bulk load a list of elements into the front
+        /// Inserting elements one by one queries and updates the index
+        /// for each element. This loads the whole range with the bulk
+        /// constructor of the container instead, and then uses the new
+        /// index to find and erase the dominated elements at once.
+        /// If the front is not empty, the loaded elements are merged
+        /// into the front.
+        /// This is the fastest way to load large ranges that are not
+        /// fronts yet, such as columns imported from other tools.
+        /// \param first Iterator to first element
+        /// \param last Iterator to last element
+        /// \param filter_dominated Whether elements in the range might
+        ///        dominate each other. Set this to false only if the range
+        ///        is known to be non-dominated, such as a reference front.
+        /// \return Number of elements in the range that were inserted
+        template <class InputIterator>
+        size_type bulk_insert(InputIterator first, InputIterator last,
+                              bool filter_dominated = true) {
+            container_type loaded(first, last, data_.dimension_comp(),
+                                  data_.get_allocator());
+            if (loaded.empty()) {
+                return 0;
+            }
+            record_each(trace_opcode::insert, loaded.begin(), loaded.end());
+            recording_scope record(operation_trace_);
+            front source(data_.get_allocator());
+            source.is_minimization_ = is_minimization_;
+            source.maybe_adjust_dimensions(loaded.dimensions());
+            source.data_ = std::move(loaded);
+            if (filter_dominated) {
+                source.erase_dominated_elements();
+            }
+            const size_type n = source.size();
+            std::vector<value_type> rejected;
+            merge_and_split(source, true, &rejected);
+            return n - rejected.size();
+        }
+
         /// \brief Insert list of elements in the front
         /// It's always more efficient to insert lots of elements
         ///     at once.
@@ -1464,35 +1687,180 @@ namespace pareto {
         /// \brief Erase element pointed by iterator from the front
         /// \warning The modification of the rtree may invalidate the iterators.
         iterator erase(const_iterator position) {
+            trace_scope trace(traced_operation::erase, size());
+            recording_scope record(operation_trace_, trace_opcode::erase_one,
+                                   position->first);
             auto it = find(position->first);
+            if (change_log_ != nullptr && it != end()) {
+                log_change(change_type::erase, it->first);
+            }
             return data_.erase(it);
         }
 
         /// \brief Erase element pointed by iterator from the front
         /// \warning The modification of the rtree may invalidate the iterators.
         iterator erase(iterator position) {
+            trace_scope trace(traced_operation::erase, size());
+            recording_scope record(operation_trace_, trace_opcode::erase_one,
+                                   position->first);
             auto it = find(position->first);
+            if (change_log_ != nullptr && it != end()) {
+                log_change(change_type::erase, it->first);
+            }
             return data_.erase(it);
         }
 
         /// \brief Remove range of iterators from the front
         iterator erase(const_iterator first, const_iterator last) {
+            trace_scope trace(traced_operation::erase, size());
+            record_each(trace_opcode::erase_one, first, last);
+            log_changes(change_type::erase, first, last);
             return data_.erase(first, last);
         }
 
         /// \brief Erase element from the front
         /// \param v Point
-        size_type erase(const key_type &point) { return data_.erase(point); }
+        size_type erase(const key_type &point) {
+            trace_scope trace(traced_operation::erase, size());
+            recording_scope record(operation_trace_, trace_opcode::erase,
+                                   point);
+            if (change_log_ != nullptr) {
+                log_changes(change_type::erase, find_intersection(point), end());
+            }
+            return data_.erase(point);
+        }
 
         /// \brief Splices nodes from another container
-        void merge(front &source) noexcept {
-            insert(source.begin(), source.end());
+        /// The elements of source are copied into this front, which
+        /// keeps only the non-dominated elements of both fronts.
+        /// \see merge(front&&)
+        void merge(front &source) {
+            if (&source != this) {
+                record_each(trace_opcode::insert, source.begin(), source.end());
+            }
+            recording_scope record(operation_trace_);
+            merge_and_split(source, false);
+        }
+
+        /// \brief Merge another front into this front
+        /// Inserting the elements of another front one by one ignores
+        /// the spatial index of the source front. Merging uses both
+        /// indexes instead:
+        /// * our index finds the elements behind the source ideal
+        ///   point, and only these are tested against the source index
+        /// * source elements behind our ideal point are tested against
+        ///   our index, and the others survive without any query
+        /// Because both fronts are non-dominated sets, the losers on
+        /// each side can be determined before changing any of them.
+        /// Our losers are then erased in bulk, and the source survivors
+        /// are inserted without any further dominance checks. If the
+        /// survivors outnumber the elements we keep, the container is
+        /// rebuilt with its bulk constructor instead.
+        void merge(front &&source) {
+            if (&source != this) {
+                record_each(trace_opcode::insert, source.begin(), source.end());
+            }
+            recording_scope record(operation_trace_);
+            merge_and_split(source, true);
+            source.clear();
+        }
+
+      public /* Change log */:
+        /// \brief Record all modifications in a change log
+        /// Copies and moves of the front are not attached to the log.
+        /// \param log Change log or nullptr to stop recording
+        void set_change_log(change_log<key_type> *log) noexcept {
+            change_log_ = log;
+        }
+
+        /// \brief Change log recording the modifications, if any
+        change_log<key_type> *get_change_log() const noexcept {
+            return change_log_;
+        }
+
+      public /* Operation trace */:
+        /// \brief Record all operations in a trace
+        /// The current elements are recorded first, as a clear followed
+        /// by their insertion, so that replaying the trace starts from
+        /// the same front. Copies and moves of the front are not
+        /// attached to the trace. Queries with a box are not recorded.
+        /// \param writer Trace writer or nullptr to stop recording
+        void set_operation_trace(operation_trace_writer *writer) {
+            operation_trace_ = writer;
+            record_reset();
+        }
+
+        /// \brief Trace writer recording the operations, if any
+        operation_trace_writer *get_operation_trace() const noexcept {
+            return operation_trace_;
+        }
+
+      public /* Random numbers */:
+        /// \brief Seed the generator of randomized algorithms
+        /// Each front owns a generator, which copies of the front copy.
+        /// Without a seed, the generator starts from
+        /// counter_generator::default_seed. Seeding also restarts the
+        /// sequence of hypervolume estimates.
+        void seed(uint64_t s) noexcept {
+            generator_.seed(s);
+            hypervolume_streams_.reset();
+        }
+
+        /// \brief Generator of randomized algorithms
+        const counter_generator &generator() const noexcept {
+            return generator_;
+        }
+
+      public /* What-if / Pareto Concept */:
+        /// \brief Changes an insertion would cause
+        struct insert_preview {
+            /// True if the element would be inserted
+            bool inserted{false};
+            /// Front rank of the element: 0 if it would be inserted
+            /// and 1 if it's dominated by the front
+            size_t rank{0};
+            /// Elements the new element would dominate and remove
+            std::vector<value_type> evicted;
+            /// Hypervolume the front would gain
+            /// Only calculated if a reference point is provided
+            dimension_type hypervolume_delta{0};
+        };
+
+        /// \brief Find out what inserting a point would change
+        /// The front is not modified.
+        insert_preview preview_insert(const key_type &k) const {
+            insert_preview r;
+            if (dominates(k)) {
+                r.rank = 1;
+                return r;
+            }
+            r.inserted = true;
+            if (!empty()) {
+                std::copy(find_dominated(k), end(),
+                          std::back_inserter(r.evicted));
+            }
+            return r;
+        }
+
+        /// \brief Find out what inserting a point would change
+        /// \param reference_point Reference for the hypervolume delta
+        insert_preview preview_insert(const key_type &k,
+                                      const point_type &reference_point) const {
+            insert_preview r = preview_insert(k);
+            if (r.inserted) {
+                r.hypervolume_delta =
+                    hypervolume_contribution(k, reference_point);
+            }
+            return r;
         }
 
       public /* Lookup / Multimap Concept */:
         /// \brief Returns the number of elements with key that compares
         /// equivalent to the specified argument.
         size_type count(const key_type &k) const {
+            if (has_hash_index()) {
+                return data_.count(k);
+            }
             iterator it = (const_cast<front *>(this))->find_intersection(k);
             iterator end = (const_cast<front *>(this))->end();
             return static_cast<size_type>(std::distance(it, end));
@@ -1501,8 +1869,7 @@ namespace pareto {
         /// \brief Returns the number of elements with key that compares
         /// equivalent to the specified argument.
         template <class L> size_type count(const L &k) const {
-            iterator it = find_intersection(key_type{k}, key_type{k});
-            return static_cast<size_type>(std::distance(it, end()));
+            return count(key_type{k});
         }
 
         /// \brief Find element by point
@@ -1527,6 +1894,34 @@ namespace pareto {
             return find(x) != end();
         }
 
+      public /* Lookup / Hash index */:
+        /// \brief Keep a hash index for exact lookups
+        /// find, count, contains, at, and the "p is already in the front"
+        /// check of dominance queries then take O(1) expected time.
+        /// Only containers with one element per node support the index.
+        /// \see kd_tree::enable_hash_index
+        template <class C = container_type,
+                  std::enable_if_t<supports_hash_index_v<C>, int> = 0>
+        void enable_hash_index() {
+            data_.enable_hash_index();
+        }
+
+        /// \brief Drop the hash index
+        template <class C = container_type,
+                  std::enable_if_t<supports_hash_index_v<C>, int> = 0>
+        void disable_hash_index() noexcept {
+            data_.disable_hash_index();
+        }
+
+        /// \brief Whether exact lookups go through a hash index
+        [[nodiscard]] bool has_hash_index() const noexcept {
+            if constexpr (supports_hash_index_v<container_type>) {
+                return data_.has_hash_index();
+            } else {
+                return false;
+            }
+        }
+
       public /* Modifiers: Lookup / Spatial Concept */:
         /// \brief Get iterator to first element that passes a list of
         /// predicates
@@ -1585,43 +1980,65 @@ namespace pareto {
 
         /// \brief Find nearest point
         const_iterator find_nearest(const point_type &p) const {
+            trace_scope trace(traced_operation::find_nearest, size());
+            recording_scope record(operation_trace_,
+                                   trace_opcode::find_nearest, p);
             return data_.find_nearest(p);
         }
 
         /// \brief Find nearest point
         iterator find_nearest(const point_type &p) {
+            trace_scope trace(traced_operation::find_nearest, size());
+            recording_scope record(operation_trace_,
+                                   trace_opcode::find_nearest, p);
             return data_.find_nearest(p);
         }
 
         /// \brief Find k nearest points
         const_iterator find_nearest(const point_type &p, size_t k) const {
+            trace_scope trace(traced_operation::find_nearest, size());
+            recording_scope record(operation_trace_,
+                                   trace_opcode::find_nearest, p, k);
             return data_.find_nearest(p, k);
         }
 
         /// \brief Find k nearest points
         iterator find_nearest(const point_type &p, size_t k) {
+            trace_scope trace(traced_operation::find_nearest, size());
+            recording_scope record(operation_trace_,
+                                   trace_opcode::find_nearest, p, k);
             return data_.find_nearest(p, k);
         }
 
         /// \brief Find k nearest points
         const_iterator find_nearest(std::initializer_list<dimension_type> p,
                                     size_t k) const {
+            trace_scope trace(traced_operation::find_nearest, size());
+            recording_scope record(operation_trace_,
+                                   trace_opcode::find_nearest, point_type(p),
+                                   k);
             return data_.find_nearest(point_type(p), k);
         }
 
         /// \brief Find k nearest points
         iterator find_nearest(std::initializer_list<dimension_type> p,
                               size_t k) {
+            trace_scope trace(traced_operation::find_nearest, size());
+            recording_scope record(operation_trace_,
+                                   trace_opcode::find_nearest, point_type(p),
+                                   k);
             return data_.find_nearest(point_type(p), k);
         }
 
         /// \brief Find k nearest points
         const_iterator find_nearest(const box_type &b, size_t k) const {
+            trace_scope trace(traced_operation::find_nearest, size());
             return data_.find_nearest(b, k);
         }
 
         /// \brief Find k nearest points
         iterator find_nearest(const box_type &b, size_t k) {
+            trace_scope trace(traced_operation::find_nearest, size());
             return data_.find_nearest(b, k);
         }
 
@@ -1827,6 +2244,19 @@ namespace pareto {
             return true;
         }
       private /* functions */:
+        /// \brief Replace the container with a rebuilt one
+        /// The hash index is a setting of this front, so the new
+        /// container gets an index if the old one had it.
+        void replace_data(container_type &&data) {
+            const bool had_hash_index = has_hash_index();
+            data_ = std::move(data);
+            if constexpr (supports_hash_index_v<container_type>) {
+                if (had_hash_index) {
+                    data_.enable_hash_index();
+                }
+            }
+        }
+
         /// \brief Clear solutions are dominated by p
         /// Pareto-optimal front is the set F consisting of
         /// all non-dominated solutions x in the whole
@@ -1840,6 +2270,268 @@ namespace pareto {
             }
         }
 
+        /// \brief Erase the elements dominated by other elements
+        /// This restores the front invariant after bulk loading
+        /// elements that might dominate each other. Any element in the
+        /// box between the ideal point and p other than p dominates p.
+        void erase_dominated_elements() {
+            const point_type ideal_point = ideal();
+            std::vector<key_type> losers;
+            for (const value_type &v : data_) {
+                const key_type &p = v.first;
+                auto it = data_.find_intersection(
+                    ideal_point, p,
+                    [&p](const value_type &q) { return q.first != p; });
+                if (it != data_.end()) {
+                    losers.emplace_back(p);
+                }
+            }
+            for (const key_type &k : losers) {
+                data_.erase(k);
+            }
+        }
+
+        /// \brief Record a change if there is a change log
+        void log_change(change_type type, const key_type &k = key_type{}) {
+            if (change_log_ != nullptr) {
+                change_log_->record(type, k);
+            }
+        }
+
+        /// \brief Record a change for each element in a range
+        template <class Iterator>
+        void log_changes(change_type type, Iterator first, Iterator last) {
+            if (change_log_ != nullptr) {
+                for (; first != last; ++first) {
+                    change_log_->record(type, first->first);
+                }
+            }
+        }
+
+        /// \brief Record that all elements were replaced
+        /// Assignments and swaps are recorded as a clear followed by
+        /// the insertion of each element.
+        void log_reset() {
+            if (change_log_ != nullptr) {
+                change_log_->record(change_type::clear);
+                log_changes(change_type::insert, begin(), end());
+            }
+        }
+
+        /// \brief Record an operation for each element in a range
+        /// Range operations are recorded element by element.
+        template <class Iterator>
+        void record_each(trace_opcode op, Iterator first, Iterator last) const {
+            if (operation_trace_ != nullptr && !recording_scope::nested()) {
+                for (; first != last; ++first) {
+                    operation_trace_->record(op, first->first);
+                }
+            }
+        }
+
+        /// \brief Record the current elements in the operation trace
+        /// Assignments and swaps are recorded as in the change log.
+        void record_reset() const {
+            if (operation_trace_ != nullptr && !recording_scope::nested()) {
+                operation_trace_->record(trace_opcode::clear);
+                record_each(trace_opcode::insert, begin(), end());
+            }
+        }
+
+        /// \brief Hypervolume a non-dominated point adds to the front
+        /// The point adds the volume of the box between it and the
+        /// reference point, minus the part of this box the front
+        /// already dominates. This part is the hypervolume of the front
+        /// clipped to the box. An element dominates part of the box iff
+        /// it is better than the reference point in all objectives,
+        /// even if it is better than p in some of them, so we only clip
+        /// the elements between the ideal point and the reference point.
+        dimension_type
+        hypervolume_contribution(const point_type &p,
+                                 const point_type &reference_point) const {
+            dimension_type box_volume = 1;
+            for (size_t i = 0; i < p.dimensions(); ++i) {
+                const bool p_is_better =
+                    is_minimization(i) ? p[i] < reference_point[i]
+                                       : p[i] > reference_point[i];
+                if (!p_is_better) {
+                    return 0;
+                }
+                box_volume *= std::abs(reference_point[i] - p[i]);
+            }
+            front clipped({}, is_minimization_.begin(), is_minimization_.end(),
+                          dimension_comp(), get_allocator());
+            if (empty()) {
+                return box_volume;
+            }
+            for (auto it = find_intersection(ideal(), reference_point);
+                 it != end(); ++it) {
+                point_type c = it->first;
+                bool overlaps = true;
+                for (size_t i = 0; i < p.dimensions() && overlaps; ++i) {
+                    if (is_minimization(i)) {
+                        c[i] = std::max(c[i], p[i]);
+                        overlaps = c[i] < reference_point[i];
+                    } else {
+                        c[i] = std::min(c[i], p[i]);
+                        overlaps = c[i] > reference_point[i];
+                    }
+                }
+                if (overlaps) {
+                    clipped.insert(value_type(c, it->second));
+                }
+            }
+            if (clipped.empty()) {
+                return box_volume;
+            }
+            return box_volume - clipped.hypervolume(reference_point);
+        }
+
+        /// \brief Insert an element and log what it removes
+        /// Elements dominated by v and elements with the same key are
+        /// logged because undoing the insertion erases the key.
+        /// \see transaction
+        /// \return True if the element was inserted
+        bool insert_and_log(const value_type &v,
+                            std::vector<value_type> &removed) {
+            maybe_adjust_dimensions(v);
+            if (dominates(v.first)) {
+                return false;
+            }
+            if (!empty()) {
+                auto dominated_it = find_dominated(v.first);
+                std::copy(dominated_it, end(), std::back_inserter(removed));
+                erase(dominated_it, end());
+                std::copy(find_intersection(v.first), end(),
+                          std::back_inserter(removed));
+            }
+            data_.insert(v);
+            log_change(change_type::insert, v.first);
+            return true;
+        }
+
+        /// \brief Erase all elements with key k and log them
+        /// \see transaction
+        size_type erase_and_log(const key_type &k,
+                                std::vector<value_type> &removed) {
+            std::copy(find_intersection(k), end(),
+                      std::back_inserter(removed));
+            return erase(k);
+        }
+
+        /// \brief Undo an operation logged by a transaction
+        /// The removed elements were non-dominated before the
+        /// operation, so they go back without any dominance checks.
+        void undo(const std::optional<key_type> &key,
+                  std::vector<value_type> &removed) {
+            if (key) {
+                erase(*key);
+            }
+            for (value_type &v : removed) {
+                log_change(change_type::insert, v.first);
+                data_.insert(std::move(v));
+            }
+        }
+
+        /// \brief Merge source into this front and report the losers
+        /// \param source Front whose non-dominated elements we keep
+        /// \param move_values Move mapped values out of source
+        /// \param rejected Receives source elements dominated by this front
+        /// \param evicted Receives our elements dominated by source
+        /// \see merge(front&&)
+        void merge_and_split(front &source, bool move_values,
+                             std::vector<value_type> *rejected = nullptr,
+                             std::vector<value_type> *evicted = nullptr) {
+            if (source.empty() || &source == this) {
+                return;
+            }
+
+            // fronts with other directions have another dominance relation
+            maybe_adjust_dimensions(*source.begin());
+            const bool same_directions = std::equal(
+                is_minimization_.begin(), is_minimization_.end(),
+                source.is_minimization_.begin(),
+                source.is_minimization_.end());
+            if (!same_directions) {
+                for (const value_type &v : source) {
+                    if (!insert(v).second && rejected != nullptr) {
+                        rejected->emplace_back(v);
+                    }
+                }
+                return;
+            }
+
+            // trivial case: nothing to compare to
+            if (empty()) {
+                if (move_values) {
+                    replace_data(std::move(source.data_));
+                } else {
+                    replace_data(container_type(source.data_));
+                }
+                log_changes(change_type::insert, begin(), end());
+                return;
+            }
+
+            // our elements dominated by source elements
+            // only elements behind the source ideal point can be dominated
+            const point_type source_ideal = source.ideal();
+            std::vector<key_type> losers;
+            for (auto it = find_intersection(source_ideal, worst());
+                 it != end(); ++it) {
+                const bool is_candidate =
+                    source_ideal.dominates(it->first, is_minimization_);
+                if (is_candidate && source.dominates(it->first)) {
+                    losers.emplace_back(it->first);
+                    if (evicted != nullptr) {
+                        evicted->emplace_back(*it);
+                    }
+                }
+            }
+
+            // source elements not dominated by our elements
+            // this has to happen before we erase anything
+            const point_type target_ideal = ideal();
+            std::vector<value_type> survivors;
+            survivors.reserve(source.size());
+            for (auto &v : source) {
+                const bool is_candidate =
+                    target_ideal.dominates(v.first, is_minimization_);
+                std::vector<value_type> *destination =
+                    is_candidate && dominates(v.first) ? rejected : &survivors;
+                if (destination != nullptr) {
+                    if (move_values) {
+                        destination->emplace_back(v.first,
+                                                  std::move(v.second));
+                    } else {
+                        destination->emplace_back(v);
+                    }
+                }
+            }
+
+            // bulk erase our losers
+            for (const key_type &k : losers) {
+                log_change(change_type::erase, k);
+                data_.erase(k);
+            }
+
+            // bulk load the survivors
+            // they are not dominated by any element we kept
+            log_changes(change_type::insert, survivors.begin(),
+                        survivors.end());
+            if (survivors.size() > data_.size()) {
+                for (const value_type &v : data_) {
+                    survivors.emplace_back(v);
+                }
+                replace_data(container_type(survivors.begin(), survivors.end(),
+                                            data_.dimension_comp(),
+                                            data_.get_allocator()));
+            } else {
+                for (value_type &v : survivors) {
+                    data_.insert(std::move(v));
+                }
+            }
+        }
+
         double distance(const point_type &p1, const point_type &p2) const {
 #ifdef BUILD_BOOST_TREE
             if constexpr (number_of_compile_dimensions > 0) {
@@ -1877,14 +2569,69 @@ namespace pareto {
 #endif
         }
 
-        static std::mt19937 &generator() {
-            static std::mt19937 g(static_cast<unsigned int>(
-                static_cast<unsigned int>(std::random_device()()) |
-                static_cast<unsigned int>(
-                    std::chrono::high_resolution_clock::now()
-                        .time_since_epoch()
-                        .count())));
-            return g;
+        /// \brief Monte-carlo hypervolume with the samples of a generator
+        /// Samples are drawn in blocks of fixed size and block i uses the
+        /// stream g.split(i), so the estimate does not depend on how the
+        /// blocks are distributed between threads.
+        dimension_type
+        monte_carlo_hypervolume(size_t sample_size,
+                                const point_type &reference_point,
+                                const counter_generator &g,
+                                size_t max_threads) const {
+            if (empty() || sample_size == 0) {
+                return dimension_type{0};
+            }
+            double hv_upper_limit = 1;
+            const point_type m = ideal();
+            for (size_t i = 0; i < m.dimensions(); ++i) {
+                hv_upper_limit *= std::abs(reference_point[i] - m[i]);
+            }
+
+            constexpr size_t block_size = 1024;
+            const size_t n_blocks = (sample_size + block_size - 1) / block_size;
+            std::vector<size_t> hits(n_blocks, 0);
+            parallel_for(
+                n_blocks,
+                [&](size_t block) {
+                    counter_generator block_generator = g.split(block);
+                    const size_t first = block * block_size;
+                    const size_t last =
+                        std::min(first + block_size, sample_size);
+                    point_type rand(dimensions());
+                    // neighbouring blocks share the cache lines of hits
+                    size_t block_hits = 0;
+                    for (size_t i = first; i < last; ++i) {
+                        for (size_t j = 0; j < dimensions(); ++j) {
+                            std::uniform_real_distribution<
+                                promote_to_floating_point<dimension_type>>
+                                d(m[j], reference_point[j]);
+                            rand[j] = d(block_generator);
+                        }
+                        block_hits += dominates_without_tracing(rand, m);
+                    }
+                    hits[block] = block_hits;
+                },
+                max_threads);
+
+            size_t hit = 0;
+            for (size_t h : hits) {
+                hit += h;
+            }
+            return hv_upper_limit * hit / static_cast<double>(sample_size);
+        }
+
+        /// \brief Check if the front dominates p given its ideal point
+        /// This is dominates(p) without the trace hooks and recording,
+        /// so that worker threads do not touch them.
+        bool dominates_without_tracing(const point_type &p,
+                                       const point_type &ideal_point) const {
+            if (!ideal_point.dominates(p, is_minimization_)) {
+                return false;
+            }
+            if (data_.find(p) != data_.end()) {
+                return false;
+            }
+            return data_.find_intersection(ideal_point, p) != data_.end();
         }
 
         /// If the dimension is being set at runtime, this sets the
@@ -1900,6 +2647,18 @@ namespace pareto {
             }
         }
 
+        /// \brief Set the runtime dimension of an adopted container
+        void adopt_dimensions() {
+            if constexpr (number_of_compile_dimensions == 0) {
+                if (!data_.empty() && is_minimization_.size() == 1) {
+                    maybe_resize(is_minimization_, data_.dimensions());
+                    std::fill(is_minimization_.begin() + 1,
+                              is_minimization_.end(),
+                              *is_minimization_.begin());
+                }
+            }
+        }
+
         /// If the dimension is being set at runtime, this sets the
         /// dimension in case we don't already know it.
         inline void maybe_adjust_dimensions([[maybe_unused]] size_t s) {
@@ -1982,9 +2741,23 @@ namespace pareto {
         /// We use uint8_t instead of bool to avoid the array specialization
         directions_type is_minimization_;
 
+        /// \brief Log recording the modifications (optional)
+        change_log<key_type> *change_log_{nullptr};
+
+        /// \brief Trace recording the operations (optional)
+        operation_trace_writer *operation_trace_{nullptr};
+
+        /// \brief Generator of randomized algorithms
+        counter_generator generator_;
+
+        /// \brief Index of the next hypervolume sample stream
+        mutable stream_counter hypervolume_streams_;
+
       public:
         /// We won't need this when we finally deprecate boost tree
         template <class, size_t, class, class> friend class archive;
+
+        template <class> friend class transaction;
     };
 
     /// \brief Relational operator < for fronts and fronts
@@ -2156,6 +2929,15 @@ namespace pareto {
         return !(lhs == rhs);
     }
 
+    /// \brief Pareto front that only stores keys
+    /// The elements have no mapped values, so keys can be inserted
+    /// directly. All dominance, query and indicator functions work as
+    /// in a front with mapped values. The elements are key_only_pair
+    /// objects, which take as much memory as their keys.
+    template <class K, size_t M,
+              class Container = spatial_map<K, M, no_value>>
+    using front_set = front<K, M, no_value, Container>;
+
 } // namespace pareto
 
 #endif // PARETO_FRONTS_PARETO_FRONT_RTREE_H
@@ -37,9 +37,9 @@ namespace pareto {
         using unprotected_key_type = unprotected_point_type;
         using protected_key_type = protected_point_type;
         using unprotected_value_type =
-            std::pair<unprotected_key_type, unprotected_mapped_type>;
+            element_pair_t<unprotected_key_type, unprotected_mapped_type>;
         using protected_value_type =
-            std::pair<protected_key_type, unprotected_mapped_type>;
+            element_pair_t<protected_key_type, unprotected_mapped_type>;
         using unprotected_allocator_type = typename std::allocator_traits<
             A>::template rebind_alloc<unprotected_value_type>;
         using unprotected_vector_type =
@@ -212,10 +212,9 @@ namespace pareto {
             /// The user cannot change the key because it would mess
             /// the data structure. But the user CAN change the key.
             reference operator*() const {
-                const std::pair<key_type, mapped_type> &p =
-                    query_it_.operator*();
-                auto *p2 = (std::pair<const key_type, mapped_type> *)&p;
-                std::pair<const key_type, mapped_type> &p3 = *p2;
+                const unprotected_value_type &p = query_it_.operator*();
+                auto *p2 = (protected_value_type *)&p;
+                protected_value_type &p3 = *p2;
                 return p3;
             }
 
@@ -227,9 +226,8 @@ namespace pareto {
 
           public /* LegacyInputIterator */:
             pointer operator->() const {
-                const std::pair<key_type, mapped_type> &p =
-                    query_it_.operator*();
-                auto *p2 = (std::pair<const key_type, mapped_type> *)&p;
+                const unprotected_value_type &p = query_it_.operator*();
+                auto *p2 = (protected_value_type *)&p;
                 return p2;
             }
 
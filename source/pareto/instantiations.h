@@ -0,0 +1,57 @@
+#ifndef PARETO_INSTANTIATIONS_H
+#define PARETO_INSTANTIATIONS_H
+
+#include <cstdint>
+#include <pareto/archive.h>
+#include <pareto/front.h>
+#include <pareto/implicit_tree.h>
+#include <pareto/kd_tree.h>
+#include <pareto/quad_tree.h>
+#include <pareto/r_star_tree.h>
+#include <pareto/r_tree.h>
+
+/// Explicit instantiations of common fronts and archives
+/// Every translation unit that uses a front or archive instantiates the
+/// front, the archive, and their container again. With the CMake option
+/// BUILD_PARETO_INSTANTIATIONS, the pareto_instantiations library
+/// compiles the combinations in PARETO_INSTANTIATION_KEYS,
+/// PARETO_INSTANTIATION_DIMENSIONS, PARETO_INSTANTIATION_MAPPED_TYPES,
+/// and PARETO_INSTANTIATION_CONTAINERS once. Translation units of
+/// targets that link to pareto_instantiations should include this
+/// header instead of front.h or archive.h:
+///
+///     #include <pareto/instantiations.h>
+///     pareto::front<double, 3, uint64_t> pf; // not instantiated here
+///
+/// The header declares these combinations as extern templates, so the
+/// compiler skips their instantiation. Without the library, this header
+/// only includes the containers, and the fronts are instantiated as
+/// usual.
+///
+/// Large functions of extern templates are not inlined into the client,
+/// so enable link-time optimization for hot paths.
+
+/// \brief Declare (EXTERN = extern) or define (EXTERN empty) the
+/// instantiations of a front and an archive with a container
+#define PARETO_INSTANTIATE(EXTERN, K, M, T, CONTAINER)                         \
+    EXTERN template class pareto::CONTAINER<K, M, T>;                          \
+    EXTERN template class pareto::CONTAINER<K, M, T>::iterator_impl<false>;    \
+    EXTERN template class pareto::CONTAINER<K, M, T>::iterator_impl<true>;     \
+    EXTERN template class pareto::front<K, M, T, pareto::CONTAINER<K, M, T>>;  \
+    EXTERN template class pareto::archive<K, M, T,                             \
+                                          pareto::CONTAINER<K, M, T>>;         \
+    EXTERN template class pareto::archive<                                     \
+        K, M, T, pareto::CONTAINER<K, M, T>>::iterator_impl<false>;            \
+    EXTERN template class pareto::archive<                                     \
+        K, M, T, pareto::CONTAINER<K, M, T>>::iterator_impl<true>;
+
+#ifdef PARETO_WITH_INSTANTIATIONS
+// Generated by CMake with one PARETO_INSTANTIATION(K, M, T, CONTAINER)
+// for each combination in the library
+#define PARETO_INSTANTIATION(K, M, T, CONTAINER)                               \
+    PARETO_INSTANTIATE(extern, K, M, T, CONTAINER)
+#include <pareto/instantiation_list.h>
+#undef PARETO_INSTANTIATION
+#endif
+
+#endif // PARETO_INSTANTIATIONS_H
@@ -14,12 +14,14 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <queue>
 #include <sstream>
 #include <tuple>
 #include <vector>
 
 #include <pareto/common/default_allocator.h>
+#include <pareto/common/hash_index.h>
 #include <pareto/point.h>
 #include <pareto/query/predicates.h>
 #include <pareto/query/query_box.h>
@@ -49,9 +51,9 @@ namespace pareto {
         using unprotected_key_type = unprotected_point_type;
         using protected_key_type = protected_point_type;
         using unprotected_value_type =
-            std::pair<unprotected_key_type, unprotected_mapped_type>;
+            element_pair_t<unprotected_key_type, unprotected_mapped_type>;
         using protected_value_type =
-            std::pair<protected_key_type, unprotected_mapped_type>;
+            element_pair_t<protected_key_type, unprotected_mapped_type>;
         using unprotected_allocator_type = typename std::allocator_traits<
             A>::template rebind_alloc<unprotected_value_type>;
         using unprotected_vector_type =
@@ -498,6 +500,7 @@ namespace pareto {
                 nearest_queue_.emplace_back(
                     current_node_, true,
                     nearest_predicate->distance(current_node_->value_.first));
+                count_work(&work_stats::heap_pushes);
                 std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
                                queue_comp);
                 // left child
@@ -505,6 +508,7 @@ namespace pareto {
                     nearest_queue_.emplace_back(
                         current_node_->l_child, false,
                         nearest_predicate->distance(current_node_->bounds_));
+                    count_work(&work_stats::heap_pushes);
                     std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
                                    queue_comp);
                 }
@@ -513,6 +517,7 @@ namespace pareto {
                     nearest_queue_.emplace_back(
                         current_node_->r_child, false,
                         nearest_predicate->distance(current_node_->bounds_));
+                    count_work(&work_stats::heap_pushes);
                     std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
                                    queue_comp);
                 }
@@ -558,6 +563,7 @@ namespace pareto {
                     auto [element_node, is_value, distance] =
                         nearest_queue_.front();
                     auto &element = element_node->value_;
+                    count_work(&work_stats::heap_pops);
                     std::pop_heap(nearest_queue_.begin(), nearest_queue_.end(),
                                   queue_comp);
                     nearest_queue_.pop_back();
@@ -594,6 +600,7 @@ namespace pareto {
                             }
                         }
                     } else {
+                        count_work(&work_stats::nodes_visited);
                         // 11. else if Element is a leaf node then
                         // 15. else: Element is a non-leaf node
                         // These two conditions have blocks enqueuing all child
@@ -607,6 +614,7 @@ namespace pareto {
                             element_node, true,
                             nearest_predicate->distance(
                                 element_node->value_.first));
+                        count_work(&work_stats::heap_pushes);
                         std::push_heap(nearest_queue_.begin(),
                                        nearest_queue_.end(), queue_comp);
                         // 13. Enqueue(Queue, [Object], Dist(QueryObject, Rect))
@@ -617,6 +625,7 @@ namespace pareto {
                                 element_node->l_child, false,
                                 nearest_predicate->distance(
                                     element_node->l_child->bounds_));
+                            count_work(&work_stats::heap_pushes);
                             std::push_heap(nearest_queue_.begin(),
                                            nearest_queue_.end(), queue_comp);
                         }
@@ -626,6 +635,7 @@ namespace pareto {
                                 element_node->r_child, false,
                                 nearest_predicate->distance(
                                     element_node->r_child->bounds_));
+                            count_work(&work_stats::heap_pushes);
                             std::push_heap(nearest_queue_.begin(),
                                            nearest_queue_.end(), queue_comp);
                         }
@@ -687,6 +697,7 @@ namespace pareto {
                     // return if first time
                     // if we haven't checked the current node yet
                     if (first_time_in_this_branch) {
+                        count_work(&work_stats::nodes_visited);
                         if (predicates_.pass_predicate(current_node_->value_)) {
                             // found a valid value in current node
                             // point to it (already does) and return
@@ -744,6 +755,7 @@ namespace pareto {
                 while (!is_begin()) {
                     // return if first time
                     if (first_time_in_this_branch) {
+                        count_work(&work_stats::nodes_visited);
                         if (predicates_.pass_predicate(current_node_->value_)) {
                             // found a valid value in current node
                             // point to it (already does) and return
@@ -983,6 +995,9 @@ namespace pareto {
             } else {
                 root_ = nullptr;
             }
+            if (rhs.has_hash_index()) {
+                enable_hash_index();
+            }
         }
 
         /// \brief Copy constructor data but use another allocator
@@ -997,6 +1012,9 @@ namespace pareto {
             } else {
                 root_ = nullptr;
             }
+            if (rhs.has_hash_index()) {
+                enable_hash_index();
+            }
         }
 
         /// \brief Move constructor
@@ -1004,10 +1022,12 @@ namespace pareto {
         /// by move-constructing from the allocator belonging to
         /// the old container
         kd_tree(kd_tree &&rhs) noexcept
-            : root_(std::move(rhs.root_)), size_(rhs.size_),
+            : container_with_pool(std::move(rhs)),
+              root_(std::move(rhs.root_)), size_(rhs.size_),
               dimensions_(rhs.dimensions_), alloc_(std::move(rhs.alloc_)),
-              comp_(rhs.comp_) {
+              comp_(rhs.comp_), index_(std::move(rhs.index_)) {
             rhs.root_ = nullptr;
+            rhs.index_.reset();
         }
 
         /// \brief Move constructor data but use new allocator
@@ -1016,8 +1036,9 @@ namespace pareto {
               dimensions_(rhs.dimensions_),
               alloc_(std::allocator_traits<node_allocator_type>::
                          select_on_container_copy_construction(alloc)),
-              comp_(rhs.comp_) {
+              comp_(rhs.comp_), index_(std::move(rhs.index_)) {
             rhs.root_ = nullptr;
+            rhs.index_.reset();
         }
 
         /// \brief Destructor
@@ -1112,6 +1133,10 @@ namespace pareto {
             } else {
                 root_ = nullptr;
             }
+            index_.reset();
+            if (rhs.has_hash_index()) {
+                enable_hash_index();
+            }
             return *this;
         };
 
@@ -1141,10 +1166,12 @@ namespace pareto {
             if constexpr (should_move) {
                 alloc_ = std::move(rhs.alloc_);
                 root_ = rhs.root_;
+                index_ = std::move(rhs.index_);
             } else {
                 const bool same_memory_resources = alloc_ == rhs.alloc_;
                 if (same_memory_resources) {
                     root_ = rhs.root_;
+                    index_ = std::move(rhs.index_);
                 } else {
                     if (rhs.root_ != nullptr) {
                         root_ = allocate_kdtree_node();
@@ -1152,8 +1179,14 @@ namespace pareto {
                     } else {
                         root_ = nullptr;
                     }
+                    index_.reset();
+                    if (rhs.has_hash_index()) {
+                        enable_hash_index();
+                    }
                 }
             }
+            rhs.root_ = nullptr;
+            rhs.index_.reset();
             return *this;
         }
 
@@ -1341,6 +1374,7 @@ namespace pareto {
             std::swap(size_, rhs.size_);
             std::swap(dimensions_, rhs.dimensions_);
             std::swap(comp_, rhs.comp_);
+            std::swap(index_, rhs.index_);
             const bool should_swap = std::allocator_traits<
                 allocator_type>::propagate_on_container_swap::value;
             if constexpr (should_swap) {
@@ -1355,6 +1389,9 @@ namespace pareto {
             remove_all_records();
             root_ = nullptr;
             size_ = 0;
+            if (index_) {
+                index_->clear();
+            }
         }
 
         /// \brief Insert entry
@@ -1464,6 +1501,14 @@ namespace pareto {
 
         /// \brief Erase elements with given key
         size_type erase(const key_type &k) {
+            if (index_) {
+                size_type s = 0;
+                while (kdtree_node *node = index_->find(k)) {
+                    erase_impl(node);
+                    ++s;
+                }
+                return s;
+            }
             iterator first = find_intersection(k);
             iterator last = end();
             auto s = static_cast<size_type>(std::distance(first, last));
@@ -1485,6 +1530,9 @@ namespace pareto {
         /// \brief Returns the number of elements with key that compares
         /// equivalent to the specified argument.
         size_type count(const key_type &k) const {
+            if (index_) {
+                return index_->count(k);
+            }
             iterator it = (const_cast<kd_tree *>(this))->find_intersection(k);
             iterator end = (const_cast<kd_tree *>(this))->end();
             return static_cast<size_type>(std::distance(it, end));
@@ -1493,12 +1541,14 @@ namespace pareto {
         /// \brief Returns the number of elements with key that compares
         /// equivalent to the specified argument.
         template <class L> size_type count(const L &k) const {
-            iterator it = find_intersection(key_type{k});
-            return static_cast<size_type>(std::distance(it, end()));
+            return count(key_type{k});
         }
 
         /// \brief Finds an element with key equivalent to key
         iterator find(const key_type &k) {
+            if (index_) {
+                return iterator(this, index_->find(k));
+            }
             iterator it = find_intersection(k, k);
             it.predicates_.clear();
             return it;
@@ -1506,6 +1556,9 @@ namespace pareto {
 
         /// \brief Finds an element with key equivalent to key
         const_iterator find(const key_type &k) const {
+            if (index_) {
+                return const_iterator(this, index_->find(k));
+            }
             const_iterator it = find_intersection(k, k);
             it.predicates_.clear();
             return it;
@@ -1513,16 +1566,12 @@ namespace pareto {
 
         /// \brief Finds an element with key equivalent to key
         template <class L> iterator find(const L &x) {
-            iterator it = find_intersection(key_type{x}, key_type{x});
-            it.predicates_.clear();
-            return it;
+            return find(key_type{x});
         }
 
         /// \brief Finds an element with key equivalent to key
         template <class L> const_iterator find(const L &x) const {
-            const_iterator it = find_intersection(key_type{x}, key_type{x});
-            it.predicates_.clear();
-            return it;
+            return find(key_type{x});
         }
 
         /// \brief Finds an element with key equivalent to key
@@ -1533,6 +1582,30 @@ namespace pareto {
             return find(x) != end();
         }
 
+      public /* Hash index */:
+        /// \brief Keep a hash index for exact lookups
+        /// With the index, find, count, contains and erase by key take
+        /// O(1) expected time instead of a box query. The index costs
+        /// one hash node per element and a hash on each insertion.
+        void enable_hash_index() {
+            if (index_) {
+                return;
+            }
+            index_.emplace();
+            index_->reserve(size_);
+            if (root_ != nullptr) {
+                index_recursive(root_);
+            }
+        }
+
+        /// \brief Drop the hash index
+        void disable_hash_index() noexcept { index_.reset(); }
+
+        /// \brief Whether exact lookups go through the hash index
+        [[nodiscard]] bool has_hash_index() const noexcept {
+            return index_.has_value();
+        }
+
       public /* Modifiers: Lookup / Spatial Concept */:
         /// \brief Get iterator to first element with the predicates
         const_iterator find(const predicate_list_type &ps) const noexcept {
@@ -1763,6 +1836,11 @@ namespace pareto {
                 return 0;
             }
 
+            // the recursive call finds its value was already moved
+            if (index_) {
+                index_->erase(node_to_remove->value_.first, node_to_remove);
+            }
+
             if (node_to_remove->is_internal_node()) {
                 kdtree_node *min_cd = nullptr;
                 // use min(cd) from right subtree:
@@ -1779,6 +1857,10 @@ namespace pareto {
                                               node_to_remove->split_dimension_);
                     node_to_remove->value_ = min_cd->value_;
                 }
+                if (index_) {
+                    index_->relocate(min_cd->value_.first, min_cd,
+                                     node_to_remove);
+                }
                 // erase_impl min_cd recursively
                 return erase_impl(min_cd);
             } else {
@@ -1895,6 +1977,9 @@ namespace pareto {
             /// If root node is empty, put the value there
             if (root_node == nullptr) {
                 root_node = allocate_kdtree_node(nullptr, v, 0);
+                if (index_) {
+                    index_->insert(v.first, root_node);
+                }
                 ++size_;
                 return root_node;
             }
@@ -1932,6 +2017,9 @@ namespace pareto {
                 current->bounds_.stretch(v.first);
             }
 
+            if (index_) {
+                index_->insert(v.first, new_node);
+            }
             ++size_;
             return new_node;
         }
@@ -2055,6 +2143,17 @@ namespace pareto {
             }
         }
 
+        /// \brief Add a subtree to the hash index
+        void index_recursive(kdtree_node *node) {
+            index_->insert(node->value_.first, node);
+            if (node->l_child != nullptr) {
+                index_recursive(node->l_child);
+            }
+            if (node->r_child != nullptr) {
+                index_recursive(node->r_child);
+            }
+        }
+
         /// \brief Remove all points from the containers
         void remove_all_records() {
             if (root_ == nullptr) {
@@ -2128,6 +2227,7 @@ namespace pareto {
         /// \brief Allocate a kd-node
         template <class... Args>
         kdtree_node *allocate_kdtree_node(Args &&...args) {
+            count_work(&work_stats::allocations);
             auto p =
                 std::allocator_traits<node_allocator_type>::allocate(alloc_, 1);
             std::allocator_traits<node_allocator_type>::construct(
@@ -2137,6 +2237,7 @@ namespace pareto {
 
         /// \brief Deallocate a kd-node
         void deallocate_kdtree_node(kdtree_node *p) {
+            count_work(&work_stats::deallocations);
             std::allocator_traits<node_allocator_type>::destroy(alloc_, p);
             std::allocator_traits<node_allocator_type>::deallocate(alloc_, p,
                                                                    1);
@@ -2166,6 +2267,9 @@ namespace pareto {
 
         /// \brief Key comparison (single dimension)
         dimension_compare comp_{dimension_compare()};
+
+        /// \brief Optional hash index from keys to nodes
+        std::optional<hash_index<key_type, kdtree_node *>> index_;
     };
 
     // MSVC hack (we cannot define it in iterator_impl)
@@ -8,8 +8,13 @@
 #include <pareto/matplot/front.h>
 
 namespace pareto {
+    /// \brief Plot an archive
+    /// Fronts with more than plot_decimation_threshold elements are
+    /// decimated to a representative subset first (see archive::decimate),
+    /// unless decimate is false.
     template <typename ARCHIVE_TYPE>
-    void plot_archive(const ARCHIVE_TYPE &ar, size_t front_idx = 0) {
+    void plot_archive(const ARCHIVE_TYPE &ar, size_t front_idx = 0,
+                      bool decimate = true) {
         if (ar.empty()) {
             return;
         }
@@ -103,9 +108,10 @@ namespace pareto {
                  ++pf_it) {
                 if (i < front_idx) {
                     plot_front(*pf_it, false, ar.size() < 10, worst_point,
-                               "--");
+                               "--", decimate);
                 } else {
-                    plot_front(*pf_it, false, ar.size() < 10, worst_point, "-");
+                    plot_front(*pf_it, false, ar.size() < 10, worst_point, "-",
+                               decimate);
                 }
                 ++i;
                 matplot::hold(true);
@@ -131,7 +137,13 @@ namespace pareto {
             std::vector<std::vector<double>> X(m);
             std::vector<double> C;
             double front_index = 1.;
-            for (auto pf_it = ar.begin_front(); pf_it != ar.end_front();
+            std::vector<typename ARCHIVE_TYPE::front_type> fronts;
+            if (decimate && ar.size() > plot_decimation_threshold) {
+                fronts = ar.decimate(plot_resolution);
+            } else {
+                fronts.assign(ar.begin_front(), ar.end_front());
+            }
+            for (auto pf_it = fronts.begin(); pf_it != fronts.end();
                  ++pf_it) {
                 for (const auto &[k, v] : *pf_it) {
                     for (size_t i = 0; i < m; ++i) {
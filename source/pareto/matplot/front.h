@@ -8,15 +8,30 @@
 #include <matplot/matplot.h>
 
 namespace pareto {
+    /// \brief Fronts with more elements are decimated before plotting
+    constexpr size_t plot_decimation_threshold = 5000;
+
+    /// \brief Grid resolution of decimated fronts (about the plot width in pixels)
+    constexpr size_t plot_resolution = 1000;
+
+    /// \brief Plot a front
+    /// Fronts with more than plot_decimation_threshold elements are
+    /// decimated to a representative subset first (see front::decimate),
+    /// unless decimate is false.
     template<typename FRONT_TYPE>
     void plot_front(const FRONT_TYPE &pf,
                     bool draw_rect = true,
                     bool draw_text = false,
                     const std::optional<typename FRONT_TYPE::key_type> &ref = std::nullopt,
-                    std::string_view line_spec = "-") {
+                    std::string_view line_spec = "-",
+                    bool decimate = true) {
         if (pf.empty()) {
             return;
         }
+        if (decimate && pf.size() > plot_decimation_threshold) {
+            plot_front(pf.decimate(plot_resolution), draw_rect, draw_text, ref, line_spec, false);
+            return;
+        }
         bool p = matplot::gca()->hold();
         bool q = matplot::gcf()->quiet_mode();
         matplot::gcf()->quiet_mode(true);
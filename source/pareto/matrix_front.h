@@ -0,0 +1,77 @@
+#ifndef PARETO_MATRIX_FRONT_H
+#define PARETO_MATRIX_FRONT_H
+
+#include <algorithm>
+#include <vector>
+
+#include <pareto/front.h>
+#include <pareto/matrix_tree.h>
+
+namespace pareto {
+    /// \brief Front over the rows of an external matrix
+    /// The mapped value of each point is its row index.
+    /// \see matrix_tree
+    template <class K, size_t M, typename C = std::less<K>>
+    using matrix_front = front<K, M, size_t, matrix_tree<K, M, C>>;
+
+    /// \brief Create a front from the rows of an external matrix
+    /// The coordinates are not copied. The rows dominated by other rows
+    /// are left out of the view, so the front only indexes its rows.
+    /// Only the first of identical rows is kept.
+    /// \param data First element of a row-major matrix
+    /// \param rows Number of rows in the matrix
+    /// \param dimensions Number of objectives in each row
+    /// \param stride Distance between rows. If 0, the rows are packed.
+    /// \param is_minimization Direction of each objective. If empty,
+    ///        all objectives are minimized.
+    /// \param filter_dominated Set this to false only if the rows are
+    ///        known to be non-dominated, such as a reference front.
+    template <class K, size_t M, typename C = std::less<K>>
+    matrix_front<K, M, C>
+    make_matrix_front(const K *data, size_t rows, size_t dimensions,
+                      size_t stride = 0,
+                      std::vector<bool> is_minimization = {},
+                      bool filter_dominated = true) {
+        using tree_type = matrix_tree<K, M, C>;
+        using point_type = typename tree_type::key_type;
+        using value_type = typename tree_type::value_type;
+        if (is_minimization.empty()) {
+            is_minimization.assign(dimensions, true);
+        }
+        tree_type all(data, rows, dimensions, stride);
+        if (!filter_dominated || all.empty()) {
+            return matrix_front<K, M, C>(std::move(all), is_minimization.begin(),
+                                         is_minimization.end());
+        }
+
+        // any other row in the box between the ideal point and a row
+        // dominates the row
+        point_type ideal(dimensions);
+        for (size_t i = 0; i < dimensions; ++i) {
+            ideal[i] = is_minimization[i] ? all.min_value(i) : all.max_value(i);
+        }
+        std::vector<size_t> survivors;
+        point_type lb(dimensions);
+        point_type ub(dimensions);
+        for (const value_type &v : all) {
+            for (size_t i = 0; i < dimensions; ++i) {
+                lb[i] = std::min(ideal[i], v.first[i]);
+                ub[i] = std::max(ideal[i], v.first[i]);
+            }
+            const point_type &p = v.first;
+            const size_t row = v.second;
+            auto it = all.find_intersection(
+                lb, ub, [&p, row](const value_type &q) {
+                    return q.first != p || q.second < row;
+                });
+            if (it == all.end()) {
+                survivors.emplace_back(row);
+            }
+        }
+        return matrix_front<K, M, C>(
+            tree_type(data, std::move(survivors), dimensions, stride),
+            is_minimization.begin(), is_minimization.end());
+    }
+} // namespace pareto
+
+#endif // PARETO_MATRIX_FRONT_H
@@ -0,0 +1,937 @@
+#ifndef PARETO_MATRIX_TREE_H
+#define PARETO_MATRIX_TREE_H
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <pareto/point.h>
+#include <pareto/query/predicates.h>
+#include <pareto/query/query_box.h>
+
+namespace pareto {
+    /// \class matrix_tree
+    /// Read-only spatial view of an external matrix of objectives.
+    ///
+    /// The points are the rows of a row-major [n x m] matrix owned by
+    /// the caller, such as the objective matrix of a simulator, and the
+    /// mapped value of each point is its row index. The coordinates are
+    /// never copied: the container only stores a permutation of the row
+    /// indices and a packed r-tree of bounding boxes over them.
+    ///
+    /// The tree is packed once with the sort-tile-recursive algorithm,
+    /// like the bulk loader of the disk_tree. Each leaf is a contiguous
+    /// range of the permutation and each node covers a contiguous range
+    /// of nodes in the level below, so the tree has no pointers.
+    ///
+    /// There are no modifying functions. This container is meant for
+    /// one-shot analyses of large matrices through the const functions
+    /// of a front.
+    ///
+    /// \warning The iterators materialize the point they point to, like
+    /// stream iterators. References to elements are only valid while
+    /// the iterator they came from exists, so reverse iterators should
+    /// not be dereferenced. The matrix needs to outlive the container.
+    ///
+    /// \tparam K Number/key type
+    /// \tparam M Number of dimensions (0 for runtime dimensions)
+    /// \tparam C Comparison function type in one dimension
+    template <class K, size_t M, typename C = std::less<K>> class matrix_tree {
+      private /* Internal types */:
+        using unprotected_point_type = point<K, M>;
+        using protected_point_type = const point<K, M>;
+        using unprotected_value_type = std::pair<unprotected_point_type, size_t>;
+        using protected_value_type = std::pair<protected_point_type, size_t>;
+        using point_type = unprotected_point_type;
+
+      public /* Forward declarations */:
+        template <bool is_const> class iterator_impl;
+
+      public /* Container Concept */:
+        using value_type = protected_value_type;
+        using reference = value_type const &;
+        using const_reference = value_type const &;
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+        using pointer = const value_type *;
+        using const_pointer = const value_type *;
+        using difference_type = std::ptrdiff_t;
+        using size_type = size_t;
+
+      public /* ReversibleContainer Concept */:
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      public /* AssociativeContainer Concept */:
+        using key_type = unprotected_point_type;
+        using mapped_type = size_t;
+        using key_compare =
+            std::function<bool(const key_type &, const key_type &)>;
+        using value_compare =
+            std::function<bool(const value_type &, const value_type &)>;
+
+      public /* AllocatorAwareContainer Concept */:
+        /// The container does not allocate elements. This is the
+        /// allocator other containers would use for the same elements.
+        using allocator_type = std::allocator<value_type>;
+
+      public /* SpatialContainer Concept */:
+        static constexpr size_t number_of_compile_dimensions = M;
+        using dimension_type = K;
+        using dimension_compare = C;
+        using box_type =
+            query_box<dimension_type, number_of_compile_dimensions>;
+        using predicate_list_type =
+            predicate_list<dimension_type, number_of_compile_dimensions,
+                           size_t>;
+
+      public /* View Concept */:
+        /// \brief The elements are views of memory owned by someone else
+        /// Adaptors cannot keep references to elements of views after
+        /// the iterators are gone.
+        static constexpr bool is_view = true;
+
+        /// \brief Number of children of a node and elements of a leaf
+        static constexpr size_t node_capacity = 16;
+
+      public /* Iterators */:
+        /// \brief Matrix tree iterator
+        /// This iterator keeps the position of the current element in
+        /// the permutation of rows and a copy of the current point.
+        /// Nodes whose bounding boxes cannot match the query are skipped
+        /// with their subtrees, and the elements that do not match the
+        /// query predicate are skipped in the leaves we visit.
+        template <bool is_const> class iterator_impl {
+          private /* Internal Types */:
+            using query_function = std::function<bool(const value_type &)>;
+            using node_function = std::function<bool(const box_type &)>;
+
+          public /* LegacyIterator Types */:
+            using value_type = const matrix_tree::value_type;
+            using reference = matrix_tree::const_reference;
+            using difference_type = matrix_tree::difference_type;
+            using pointer = matrix_tree::const_pointer;
+            using iterator_category = std::bidirectional_iterator_tag;
+
+          public /* LegacyIterator Constructors */:
+            /// \brief Copy constructor
+            /// All iterators are read-only, so they convert both ways.
+            template <bool rhs_is_const>
+            // NOLINTNEXTLINE(google-explicit-constructor)
+            iterator_impl(const iterator_impl<rhs_is_const> &rhs)
+                : tree_(rhs.tree_), position_(rhs.position_),
+                  current_(rhs.current_),
+                  query_function_(rhs.query_function_),
+                  node_function_(rhs.node_function_) {}
+
+            /// \brief Copy constructor
+            iterator_impl(const iterator_impl &rhs) = default;
+
+            /// \brief Copy assignment
+            iterator_impl &operator=(const iterator_impl &rhs) = default;
+
+          public /* LegacyForwardIterator Constructors */:
+            /// \brief Default constructor
+            iterator_impl() = default;
+
+          public /* Internal Constructors / Used by Container */:
+            /// \brief Iterator to an element in the permutation
+            iterator_impl(const matrix_tree *tree, size_t position)
+                : tree_(tree), position_(position) {
+                materialize();
+            }
+
+            /// \brief Iterator to first element that passes the query
+            iterator_impl(const matrix_tree *tree, query_function fn,
+                           node_function node_fn)
+                : tree_(tree), query_function_(std::move(fn)),
+                  node_function_(std::move(node_fn)) {
+                maybe_advance_leaf();
+                maybe_advance_predicate();
+            }
+
+          public /* LegacyIterator */:
+            /// \brief Dereference iterator
+            reference operator*() const { return *operator->(); }
+
+            iterator_impl &operator++() {
+                advance();
+                maybe_advance_predicate();
+                return *this;
+            }
+
+          public /* LegacyInputIterator */:
+            /// \brief Pointer to the materialized element
+            /// The materialized pair has the same layout as the value
+            /// type, so we convert it like the other trees do.
+            pointer operator->() const {
+                return reinterpret_cast<pointer>(&current_);
+            }
+
+          public /* LegacyForwardIterator */:
+            /// \brief Equality operator
+            template <bool rhs_is_const>
+            bool operator==(const iterator_impl<rhs_is_const> &rhs) const {
+                return position_ == rhs.position_;
+            }
+
+            /// \brief Inequality operator
+            template <bool rhs_is_const>
+            bool operator!=(const iterator_impl<rhs_is_const> &rhs) const {
+                return !(*this == rhs);
+            }
+
+            /// \brief Increment iterator
+            iterator_impl operator++(int) { // NOLINT(cert-dcl21-cpp):
+                auto tmp = *this;
+                operator++();
+                return tmp;
+            }
+
+          public /* LegacyBidirectionalIterator */:
+            /// \brief Decrement iterator
+            iterator_impl &operator--() {
+                retreat();
+                while (query_function_ && !query_function_(**this)) {
+                    retreat();
+                }
+                return *this;
+            }
+
+            /// \brief Decrement iterator
+            iterator_impl operator--(int) { // NOLINT(cert-dcl21-cpp)
+                auto tmp = *this;
+                operator--();
+                return tmp;
+            }
+
+          private /* Internal Functions */:
+            [[nodiscard]] bool is_end() const {
+                return position_ >= tree_->rows_.size();
+            }
+
+            /// \brief Copy the current row into the current point
+            void materialize() {
+                if (is_end()) {
+                    return;
+                }
+                const size_t row = tree_->rows_[position_];
+                const K *first = tree_->row_data(row);
+                if constexpr (M == 0) {
+                    if (current_.first.dimensions() != tree_->dimensions_) {
+                        current_.first = point_type(tree_->dimensions_);
+                    }
+                }
+                std::copy(first, first + tree_->dimensions_,
+                          current_.first.begin());
+                current_.second = row;
+            }
+
+            /// \brief Move to the next element
+            void advance() {
+                ++position_;
+                if (position_ % node_capacity == 0) {
+                    maybe_advance_leaf();
+                } else {
+                    materialize();
+                }
+            }
+
+            /// \brief Move to the previous element
+            void retreat() {
+                const size_t n = tree_->rows_.size();
+                if (position_ != n && position_ % node_capacity != 0) {
+                    --position_;
+                    materialize();
+                    return;
+                }
+                size_t leaf = position_ == n
+                                  ? tree_->number_of_leaves()
+                                  : position_ / node_capacity;
+                do {
+                    --leaf;
+                } while (node_function_ &&
+                         !tree_->leaf_passes(leaf, node_function_));
+                position_ = std::min((leaf + 1) * node_capacity, n) - 1;
+                materialize();
+            }
+
+            /// \brief Skip leaves that cannot match the query
+            /// The position is always at the start of a leaf here.
+            void maybe_advance_leaf() {
+                if (!is_end()) {
+                    const size_t leaf = tree_->next_leaf(
+                        position_ / node_capacity, node_function_);
+                    position_ = std::min(leaf * node_capacity,
+                                         tree_->rows_.size());
+                }
+                materialize();
+            }
+
+            /// \brief Skip elements that do not match the query
+            void maybe_advance_predicate() {
+                if (query_function_) {
+                    while (!is_end() && !query_function_(**this)) {
+                        advance();
+                    }
+                }
+            }
+
+          private:
+            /// \brief Container we are iterating
+            const matrix_tree *tree_{nullptr};
+
+            /// \brief Position of the current element in the permutation
+            size_t position_{0};
+
+            /// \brief Copy of the current element
+            unprotected_value_type current_;
+
+            /// \brief Query function, in case the iterator has a predicate
+            query_function query_function_;
+
+            /// \brief Node function, in case the iterator skips subtrees
+            node_function node_function_;
+
+          public:
+            /// Let the matrix tree access the spatial private constructors
+            friend matrix_tree;
+            template <bool> friend class iterator_impl;
+        };
+
+      public /* Constructors */:
+        /// \brief Create an empty view
+        matrix_tree() = default;
+
+        /// \brief Create an empty view
+        explicit matrix_tree(const C &comp) : comp_(comp) {}
+
+        /// \brief Create a view of all rows of a matrix
+        /// \param data First element of a row-major matrix
+        /// \param rows Number of rows in the matrix
+        /// \param dimensions Number of objectives in each row
+        /// \param stride Distance between rows. If 0, the rows are packed.
+        ///        Larger strides skip the other columns of each row.
+        matrix_tree(const K *data, size_t rows, size_t dimensions,
+                    size_t stride = 0, const C &comp = C())
+            : matrix_tree(data, all_rows(rows), dimensions, stride, comp) {}
+
+        /// \brief Create a view of some rows of a matrix
+        /// \param data First element of a row-major matrix
+        /// \param rows Indexes of the rows in the view
+        /// \param dimensions Number of objectives in each row
+        /// \param stride Distance between rows. If 0, the rows are packed.
+        matrix_tree(const K *data, std::vector<size_t> rows, size_t dimensions,
+                    size_t stride = 0, const C &comp = C())
+            : data_(data), dimensions_(dimensions),
+              stride_(stride == 0 ? dimensions : stride), comp_(comp),
+              rows_(std::move(rows)) {
+            if (M != 0 && dimensions_ != M) {
+                throw std::invalid_argument(
+                    "matrix_tree: the matrix does not have the number of "
+                    "dimensions set at compile time");
+            }
+            if (stride_ < dimensions_) {
+                throw std::invalid_argument(
+                    "matrix_tree: the stride is smaller than a row");
+            }
+            pack();
+        }
+
+      public /* Non-Modifying Functions: AllocatorAwareContainer */:
+        /// \brief Obtains a copy of the allocator
+        allocator_type get_allocator() const noexcept {
+            return allocator_type();
+        }
+
+      public /* Element Access / Map Concept */:
+        /// \brief Get the row of a point, and throw error if it does not
+        /// exist
+        /// This reference is valid while the container exists.
+        const mapped_type &at(const key_type &k) const {
+            auto it = find(k);
+            if (it != end()) {
+                return rows_[it.position_];
+            } else {
+                throw std::out_of_range("matrix_tree::at: key not found");
+            }
+        }
+
+      public /* Non-Modifying Functions: Container Concept */:
+        /// \brief Get iterator to first element
+        const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+        /// \brief Get iterator to past-the-end element
+        const_iterator end() const noexcept {
+            return const_iterator(this, rows_.size());
+        }
+
+        /// \brief Get iterator to first element
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        /// \brief Get iterator to past-the-end element
+        const_iterator cend() const noexcept { return end(); }
+
+      public /* Non-Modifying Functions: ReversibleContainer Concept */:
+        /// \brief Get iterator to first element in reverse
+        const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        }
+
+        /// \brief Get iterator to last element in reverse
+        const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        /// \brief Get iterator to first element in reverse
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+        /// \brief Get iterator to past-the-end element in reverse
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+      public /* Non-Modifying Functions / Capacity / Container Concept */:
+        /// \brief True if container is empty
+        [[nodiscard]] bool empty() const noexcept { return rows_.empty(); }
+
+        /// \brief Get container size
+        [[nodiscard]] size_t size() const noexcept { return rows_.size(); }
+
+        /// \brief Get container max size
+        [[nodiscard]] size_t max_size() const noexcept {
+            return std::numeric_limits<size_t>::max();
+        }
+
+      public /* Non-Modifying Functions / Capacity / Spatial Concept */:
+        /// \brief Get container dimensions
+        [[nodiscard]] size_t dimensions() const noexcept {
+            return M != 0 ? M : dimensions_;
+        }
+
+        /// \brief Get maximum value in a given dimension
+        /// The root bounds are tight, so this does not visit any row.
+        dimension_type max_value(size_t dimension) const {
+            if (empty()) {
+                return std::numeric_limits<dimension_type>::min();
+            }
+            return levels_.back().front().max()[dimension];
+        }
+
+        /// \brief Get minimum value in a given dimension
+        dimension_type min_value(size_t dimension) const {
+            if (empty()) {
+                return std::numeric_limits<dimension_type>::min();
+            }
+            return levels_.back().front().min()[dimension];
+        }
+
+      public /* Non-Modifying Functions / Matrix */:
+        /// \brief First element of the matrix
+        [[nodiscard]] const K *data() const noexcept { return data_; }
+
+        /// \brief Distance between the rows of the matrix
+        [[nodiscard]] size_t stride() const noexcept { return stride_; }
+
+        /// \brief Number of leaves in the tree
+        [[nodiscard]] size_t number_of_leaves() const noexcept {
+            return levels_.empty() ? 0 : levels_.front().size();
+        }
+
+      public /* Modifying Functions: Container */:
+        /// \brief Swap the content of two views
+        void swap(matrix_tree &other) noexcept {
+            std::swap(data_, other.data_);
+            std::swap(dimensions_, other.dimensions_);
+            std::swap(stride_, other.stride_);
+            std::swap(comp_, other.comp_);
+            rows_.swap(other.rows_);
+            levels_.swap(other.levels_);
+        }
+
+      public /* Lookup / Multimap Concept */:
+        /// \brief Returns the number of elements with key that compares
+        /// equivalent to the specified argument.
+        size_type count(const key_type &k) const {
+            return static_cast<size_type>(std::distance(find(k), end()));
+        }
+
+        /// \brief Returns the number of elements with key that compares
+        /// equivalent to the specified argument.
+        template <class L> size_type count(const L &k) const {
+            return count(key_type(k));
+        }
+
+        /// \brief Find point
+        const_iterator find(const key_type &p) const {
+            return const_iterator(
+                this, [p](const value_type &v) { return v.first == p; },
+                [p](const box_type &b) { return b.contains(p); });
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> const_iterator find(const L &x) const {
+            return find(key_type(x));
+        }
+
+        /// \brief Finds an element with key equivalent to key
+        bool contains(const key_type &k) const { return find(k) != end(); }
+
+        /// \brief Finds an element with key equivalent to key
+        template <class L> bool contains(const L &x) const {
+            return find(x) != end();
+        }
+
+      public /* Lookup / Spatial Concept */:
+        /// \brief Get iterator to first element that passes the list of
+        /// predicates
+        const_iterator find(const predicate_list_type &ps) const noexcept {
+            return const_iterator(
+                this,
+                [ps](const value_type &v) { return ps.pass_predicate(v); },
+                [ps](const box_type &b) {
+                    return ps.might_pass_predicate(b);
+                });
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator find_intersection(const point_type &k) const {
+            return find_intersection(k, k);
+        }
+
+        /// \brief Find intersection between points and query box
+        const_iterator find_intersection(const point_type &lb,
+                                         const point_type &ub) const {
+            return find_intersection(lb, ub, nullptr);
+        }
+
+        template <class PREDICATE_TYPE>
+        const_iterator find_intersection(const point_type &lb,
+                                         const point_type &ub,
+                                         PREDICATE_TYPE fn) const {
+            return query(
+                intersects<dimension_type, number_of_compile_dimensions>(lb,
+                                                                         ub),
+                fn);
+        }
+
+        /// \brief Find points within a query box
+        const_iterator find_within(const point_type &lb,
+                                   const point_type &ub) const {
+            return find_within(lb, ub, nullptr);
+        }
+
+        template <class PREDICATE_TYPE>
+        const_iterator find_within(const point_type &lb, const point_type &ub,
+                                   PREDICATE_TYPE fn) const {
+            return query(
+                within<dimension_type, number_of_compile_dimensions>(lb, ub),
+                fn);
+        }
+
+        /// \brief Find points outside a query box
+        const_iterator find_disjoint(const point_type &lb,
+                                     const point_type &ub) const {
+            return find_disjoint(lb, ub, nullptr);
+        }
+
+        /// \brief Find points outside a query box
+        template <class PREDICATE_TYPE>
+        const_iterator find_disjoint(const point_type &lb, const point_type &ub,
+                                     PREDICATE_TYPE fn) const {
+            return query(
+                disjoint<dimension_type, number_of_compile_dimensions>(lb, ub),
+                fn);
+        }
+
+        /// \brief Find points closest to a reference point
+        const_iterator find_nearest(const point_type &p) const {
+            return find_nearest(p, 1);
+        }
+
+        /// \brief Find k nearest points
+        const_iterator find_nearest(const point_type &p, size_t k) const {
+            return find_nearest(p, k, nullptr);
+        }
+
+        template <class PREDICATE_TYPE>
+        const_iterator find_nearest(const point_type &p, size_t k,
+                                    PREDICATE_TYPE fn) const {
+            return nearest(box_type(p, p), k, fn);
+        }
+
+        /// \brief Find points closest to a reference box
+        const_iterator find_nearest(const box_type &b, size_t k = 1) const {
+            return nearest(b, k, nullptr);
+        }
+
+        template <class PREDICATE_TYPE>
+        const_iterator find_nearest(const box_type &b, size_t k,
+                                    PREDICATE_TYPE fn) const {
+            return nearest(b, k, fn);
+        }
+
+        /// \brief Get iterator to element with maximum value in a given
+        /// dimension
+        /// Only the leaf with the maximum bound is visited.
+        const_iterator max_element(size_t dimension) const {
+            return extreme_element(dimension, true);
+        }
+
+        /// \brief Get iterator to element with minimum value in a given
+        /// dimension
+        const_iterator min_element(size_t dimension) const {
+            return extreme_element(dimension, false);
+        }
+
+      public /* Observers: AssociativeContainer */:
+        /// \brief Returns the function object that compares keys
+        key_compare key_comp() const noexcept {
+            return [this](const key_type &a, const key_type &b) {
+                return std::lexicographical_compare(a.begin(), a.end(),
+                                                    b.begin(), b.end(), comp_);
+            };
+        }
+
+        /// \brief Returns the function object that compares values
+        value_compare value_comp() const noexcept {
+            return [this](const value_type &a, const value_type &b) {
+                return std::lexicographical_compare(
+                    a.first.begin(), a.first.end(), b.first.begin(),
+                    b.first.end(), comp_);
+            };
+        }
+
+        /// \brief Returns the function object that compares numbers
+        /// This is the comparison operator for a single dimension
+        dimension_compare dimension_comp() const noexcept { return comp_; }
+
+      private /* Tree */:
+        /// \brief Indexes of all rows of a matrix
+        static std::vector<size_t> all_rows(size_t rows) {
+            std::vector<size_t> r(rows);
+            std::iota(r.begin(), r.end(), size_t{0});
+            return r;
+        }
+
+        /// \brief First coordinate of a row
+        const K *row_data(size_t row) const { return data_ + row * stride_; }
+
+        /// \brief Bounding box of a range of rows in the permutation
+        box_type bounds_of(size_t first, size_t last) const {
+            const K *r = row_data(rows_[first]);
+            point_type p(dimensions_);
+            std::copy(r, r + dimensions_, p.begin());
+            box_type b(p, p);
+            for (size_t i = first + 1; i < last; ++i) {
+                r = row_data(rows_[i]);
+                std::copy(r, r + dimensions_, p.begin());
+                b.stretch(p);
+            }
+            return b;
+        }
+
+        /// \brief Pack the rows with sort-tile-recursive and build the
+        /// levels of bounding boxes
+        void pack() {
+            levels_.clear();
+            if (rows_.empty()) {
+                return;
+            }
+            pack(rows_.begin(), rows_.end(), 0);
+            std::vector<box_type> leaves;
+            leaves.reserve((rows_.size() + node_capacity - 1) / node_capacity);
+            for (size_t i = 0; i < rows_.size(); i += node_capacity) {
+                leaves.emplace_back(
+                    bounds_of(i, std::min(i + node_capacity, rows_.size())));
+            }
+            levels_.emplace_back(std::move(leaves));
+            while (levels_.back().size() > 1) {
+                const std::vector<box_type> &children = levels_.back();
+                std::vector<box_type> parents;
+                parents.reserve((children.size() + node_capacity - 1) /
+                                node_capacity);
+                for (size_t i = 0; i < children.size(); i += node_capacity) {
+                    box_type b = children[i];
+                    const size_t last =
+                        std::min(i + node_capacity, children.size());
+                    for (size_t j = i + 1; j < last; ++j) {
+                        b.stretch(children[j]);
+                    }
+                    parents.emplace_back(b);
+                }
+                levels_.emplace_back(std::move(parents));
+            }
+        }
+
+        /// \brief Sort-tile-recursive packing of a range of rows
+        /// The rows are sorted by one dimension and cut into slabs,
+        /// and each slab is packed by the next dimensions.
+        void pack(std::vector<size_t>::iterator first,
+                  std::vector<size_t>::iterator last, size_t dimension) {
+            const size_t n = static_cast<size_t>(std::distance(first, last));
+            std::sort(first, last, [this, dimension](size_t a, size_t b) {
+                return comp_(row_data(a)[dimension], row_data(b)[dimension]);
+            });
+            const bool is_last_dimension = dimension + 1 == dimensions_;
+            if (n <= node_capacity || is_last_dimension) {
+                return;
+            }
+            const double n_leaves = std::ceil(static_cast<double>(n) /
+                                              static_cast<double>(node_capacity));
+            const double n_slabs = std::ceil(std::pow(
+                n_leaves, 1. / static_cast<double>(dimensions_ - dimension)));
+            const size_t slab_size =
+                node_capacity *
+                static_cast<size_t>(std::ceil(n_leaves / n_slabs));
+            for (auto it = first; it != last;) {
+                const size_t s = std::min(
+                    slab_size, static_cast<size_t>(std::distance(it, last)));
+                pack(it, it + static_cast<difference_type>(s), dimension + 1);
+                it += static_cast<difference_type>(s);
+            }
+        }
+
+        /// \brief First leaf at or after a leaf whose node and ancestors
+        /// pass a node function
+        /// We go up to the parent when we reach the first child of a
+        /// node, so subtrees that cannot match are skipped at once.
+        size_t next_leaf(size_t leaf,
+                         const std::function<bool(const box_type &)> &fn) const {
+            if (!fn) {
+                return leaf;
+            }
+            const size_t top = levels_.size() - 1;
+            size_t level = 0;
+            size_t i = leaf;
+            bool descended = false;
+            while (true) {
+                if (i >= levels_[level].size()) {
+                    return number_of_leaves();
+                }
+                if (!descended && level < top && i % node_capacity == 0) {
+                    i /= node_capacity;
+                    ++level;
+                    continue;
+                }
+                count_work(&work_stats::nodes_visited);
+                count_work(&work_stats::bounding_box_tests);
+                if (!fn(levels_[level][i])) {
+                    ++i;
+                    descended = false;
+                    continue;
+                }
+                if (level == 0) {
+                    return i;
+                }
+                i *= node_capacity;
+                --level;
+                descended = true;
+            }
+        }
+
+        /// \brief Whether a leaf and its ancestors pass a node function
+        bool leaf_passes(size_t leaf,
+                         const std::function<bool(const box_type &)> &fn) const {
+            size_t i = leaf;
+            for (const std::vector<box_type> &level : levels_) {
+                count_work(&work_stats::nodes_visited);
+                count_work(&work_stats::bounding_box_tests);
+                if (!fn(level[i])) {
+                    return false;
+                }
+                i /= node_capacity;
+            }
+            return true;
+        }
+
+        /// \brief Iterator to the elements that pass a predicate
+        /// The predicate is also used to skip subtrees.
+        template <class PREDICATE, class PREDICATE_TYPE>
+        const_iterator query(const PREDICATE &p, PREDICATE_TYPE fn) const {
+            std::function<bool(const value_type &)> query_fn;
+            if constexpr (std::is_same_v<PREDICATE_TYPE, std::nullptr_t>) {
+                query_fn = [p](const value_type &v) {
+                    return p.pass_predicate(v.first);
+                };
+            } else {
+                query_fn = [p, fn](const value_type &v) {
+                    return p.pass_predicate(v.first) && fn(v);
+                };
+            }
+            return const_iterator(this, std::move(query_fn),
+                                  [p](const box_type &b) {
+                                      return p.might_pass_predicate(b);
+                                  });
+        }
+
+        /// \brief Lower bound for the distance between two boxes
+        double box_distance(const box_type &a, const box_type &b) const {
+            double dist = 0.;
+            for (size_t i = 0; i < dimensions_; ++i) {
+                double d = 0.;
+                if (a.max()[i] < b.min()[i]) {
+                    d = static_cast<double>(b.min()[i] - a.max()[i]);
+                } else if (b.max()[i] < a.min()[i]) {
+                    d = static_cast<double>(a.min()[i] - b.max()[i]);
+                }
+                dist += d * d;
+            }
+            return std::sqrt(dist);
+        }
+
+        /// \brief Iterator to the k elements closest to a box
+        /// Nodes and rows are visited best-first, so we stop as soon as
+        /// the next node is farther than the k-th closest row.
+        template <class PREDICATE_TYPE>
+        const_iterator nearest(const box_type &b, size_t k,
+                               PREDICATE_TYPE fn) const {
+            if (k == 0 || empty()) {
+                return end();
+            }
+            // (distance, level + 1 or 0 for rows, index)
+            using entry = std::tuple<double, size_t, size_t>;
+            std::priority_queue<entry, std::vector<entry>, std::greater<>>
+                candidates;
+            count_work(&work_stats::heap_pushes);
+            candidates.emplace(box_distance(levels_.back().front(), b),
+                               levels_.size(), 0);
+            std::vector<size_t> nearest_rows;
+            double max_distance = 0.;
+            point_type p(dimensions_);
+            while (!candidates.empty() && nearest_rows.size() < k) {
+                const auto [distance, level, index] = candidates.top();
+                count_work(&work_stats::heap_pops);
+                candidates.pop();
+                if (level == 0) {
+                    nearest_rows.emplace_back(rows_[index]);
+                    max_distance = distance;
+                    continue;
+                }
+                count_work(&work_stats::nodes_visited);
+                const size_t children_level = level - 1;
+                const size_t first = index * node_capacity;
+                if (children_level == 0) {
+                    const size_t last =
+                        std::min(first + node_capacity, rows_.size());
+                    for (size_t i = first; i < last; ++i) {
+                        const K *r = row_data(rows_[i]);
+                        std::copy(r, r + dimensions_, p.begin());
+                        if constexpr (!std::is_same_v<PREDICATE_TYPE,
+                                                      std::nullptr_t>) {
+                            const unprotected_value_type v(p, rows_[i]);
+                            if (!fn(reinterpret_cast<const value_type &>(v))) {
+                                continue;
+                            }
+                        }
+                        count_work(&work_stats::heap_pushes);
+                        candidates.emplace(box_distance(box_type(p, p), b), 0,
+                                           i);
+                    }
+                } else {
+                    const std::vector<box_type> &children =
+                        levels_[children_level - 1];
+                    const size_t last =
+                        std::min(first + node_capacity, children.size());
+                    for (size_t i = first; i < last; ++i) {
+                        count_work(&work_stats::heap_pushes);
+                        candidates.emplace(box_distance(children[i], b),
+                                           children_level, i);
+                    }
+                }
+            }
+            if (nearest_rows.empty()) {
+                return end();
+            }
+            std::sort(nearest_rows.begin(), nearest_rows.end());
+            return const_iterator(
+                this,
+                [nearest_rows](const value_type &v) {
+                    return std::binary_search(nearest_rows.begin(),
+                                              nearest_rows.end(), v.second);
+                },
+                [this, b, max_distance](const box_type &node_box) {
+                    return box_distance(node_box, b) <= max_distance;
+                });
+        }
+
+        /// \brief Iterator to the element with the extreme value in a
+        /// dimension
+        const_iterator extreme_element(size_t dimension, bool maximum) const {
+            if (empty()) {
+                return end();
+            }
+            const std::vector<box_type> &leaves = levels_.front();
+            size_t best = 0;
+            for (size_t i = 1; i < leaves.size(); ++i) {
+                const bool is_better =
+                    maximum ? leaves[i].max()[dimension] >
+                                  leaves[best].max()[dimension]
+                            : leaves[i].min()[dimension] <
+                                  leaves[best].min()[dimension];
+                if (is_better) {
+                    best = i;
+                }
+            }
+            const size_t first = best * node_capacity;
+            const size_t last = std::min(first + node_capacity, rows_.size());
+            size_t position = first;
+            for (size_t i = first + 1; i < last; ++i) {
+                const K a = row_data(rows_[i])[dimension];
+                const K b = row_data(rows_[position])[dimension];
+                if (maximum ? b < a : a < b) {
+                    position = i;
+                }
+            }
+            return const_iterator(this, position);
+        }
+
+      private:
+        /// \brief First element of the external matrix
+        const K *data_{nullptr};
+
+        /// \brief Number of objectives in each row
+        size_t dimensions_{M};
+
+        /// \brief Distance between rows
+        size_t stride_{M};
+
+        dimension_compare comp_{dimension_compare()};
+
+        /// \brief Rows in the view, in the order of the leaves
+        std::vector<size_t> rows_;
+
+        /// \brief Bounding boxes of the nodes in each level
+        /// The first level has the leaves and the last level has the root.
+        /// Node i of a level covers nodes [i * node_capacity,
+        /// (i + 1) * node_capacity) of the level below.
+        std::vector<std::vector<box_type>> levels_;
+    };
+
+    /* Non-Modifying Functions / Comparison / Container Concept */
+    /// \brief Equality operator
+    /// \warning This operator tells us if the trees are equal
+    /// and not if they contain the same elements.
+    template <class K, size_t M, class C>
+    bool operator==(const matrix_tree<K, M, C> &lhs,
+                    const matrix_tree<K, M, C> &rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    /// \brief Inequality operator
+    template <class K, size_t M, class C>
+    bool operator!=(const matrix_tree<K, M, C> &lhs,
+                    const matrix_tree<K, M, C> &rhs) {
+        return !(lhs == rhs);
+    }
+
+} // namespace pareto
+
+#endif // PARETO_MATRIX_TREE_H
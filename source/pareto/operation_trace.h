@@ -0,0 +1,379 @@
+#ifndef PARETO_OPERATION_TRACE_H
+#define PARETO_OPERATION_TRACE_H
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Operation traces for fronts and archives
+/// Performance often depends on the exact order of the operations an
+/// optimizer runs, which random benchmarks cannot reproduce. A front or
+/// archive with an attached trace writer records each operation it is
+/// asked to run (op code, key, and query parameters) to a compact
+/// binary stream. The trace can later be replayed against fronts and
+/// archives with any container:
+///
+///     std::ofstream out("run.trace", std::ios::binary);
+///     pareto::operation_trace_writer writer(out);
+///     pf.set_operation_trace(&writer);
+///     // ... run the optimizer ...
+///     pf.set_operation_trace(nullptr);
+///
+///     std::ifstream in("run.trace", std::ios::binary);
+///     pareto::operation_trace_reader reader(in);
+///     pareto::trace_record r;
+///     while (reader.next(r)) {
+///         pareto::replay(r, other_front);
+///     }
+///
+/// Only the keys are recorded. Mapped values, which often identify the
+/// solutions of a production run, never leave the process.
+///
+/// Format: the magic "PTRC" and a version byte, followed by one record
+/// per operation. A record is the op code (1 byte), a parameter
+/// (LEB128 varint), and, for operations with a key, the number of
+/// dimensions (varint) and the coordinates as IEEE 754 doubles in
+/// little-endian byte order, so traces can be replayed on machines with
+/// another byte order.
+namespace pareto {
+    /// \brief Operations recorded in a trace
+    enum class trace_opcode : uint8_t {
+        /// Insert the key (parameter is unused)
+        insert,
+        /// Erase the key (parameter is unused)
+        erase,
+        /// Check if the container dominates the key
+        dominates,
+        /// Find the elements nearest to the key
+        /// The parameter is the number of elements (0 for the nearest)
+        find_nearest,
+        /// Hypervolume with the key as reference point
+        /// The parameter is the number of samples (0 for the exact value)
+        hypervolume,
+        /// Remove all elements
+        clear,
+        /// Set the archive capacity to the parameter
+        resize,
+        /// Erase one element with the key (parameter is unused)
+        /// Erasing through an iterator removes a single element, even
+        /// when other elements have the same key.
+        erase_one
+    };
+
+    /// \brief Whether the records of an operation have a key
+    constexpr bool has_key(trace_opcode op) noexcept {
+        return op != trace_opcode::clear && op != trace_opcode::resize;
+    }
+
+    /// \brief One operation read from a trace
+    struct trace_record {
+        trace_opcode op{trace_opcode::insert};
+        uint64_t parameter{0};
+        std::vector<double> key;
+    };
+
+    namespace detail {
+        constexpr char trace_magic[4] = {'P', 'T', 'R', 'C'};
+        constexpr uint8_t trace_version = 1;
+
+        static_assert(std::numeric_limits<double>::is_iec559,
+                      "operation traces store IEEE 754 doubles");
+
+        /// \brief Write a double as 8 little-endian bytes
+        inline void write_trace_double(std::ostream &os, double x) {
+            uint64_t bits;
+            std::memcpy(&bits, &x, sizeof(bits));
+            char bytes[sizeof(bits)];
+            for (char &b : bytes) {
+                b = static_cast<char>(bits & 0xFF);
+                bits >>= 8;
+            }
+            os.write(bytes, sizeof(bytes));
+        }
+
+        /// \brief Read a double from 8 little-endian bytes
+        /// \return False if the stream ends first
+        inline bool read_trace_double(std::istream &is, double &x) {
+            unsigned char bytes[sizeof(uint64_t)];
+            if (!is.read(reinterpret_cast<char *>(bytes), sizeof(bytes))) {
+                return false;
+            }
+            uint64_t bits = 0;
+            for (size_t i = sizeof(bytes); i > 0; --i) {
+                bits = (bits << 8) | bytes[i - 1];
+            }
+            std::memcpy(&x, &bits, sizeof(x));
+            return true;
+        }
+
+        /// \brief Depth of recorded operations in this thread
+        /// Operations call other public operations (insert calls
+        /// dominates, for instance), and only the outer one is recorded.
+        inline size_t &recording_depth() noexcept {
+            thread_local size_t depth = 0;
+            return depth;
+        }
+    } // namespace detail
+
+    /// \class Writer of operation traces
+    /// The writer does not own the stream. Records can come from
+    /// many threads (e.g. concurrent queries), and each record is
+    /// written as a whole.
+    class operation_trace_writer {
+      public:
+        /// \brief Write the trace header to os
+        explicit operation_trace_writer(std::ostream &os) : os_(&os) {
+            os_->write(detail::trace_magic, sizeof(detail::trace_magic));
+            os_->put(static_cast<char>(detail::trace_version));
+        }
+
+        /// \brief Record an operation with a key
+        template <class Key>
+        void record(trace_opcode op, const Key &key, uint64_t parameter = 0) {
+            std::lock_guard lock(mutex_);
+            write_header(op, parameter);
+            write_varint(key.dimensions());
+            for (size_t i = 0; i < key.dimensions(); ++i) {
+                detail::write_trace_double(*os_, static_cast<double>(key[i]));
+            }
+        }
+
+        /// \brief Record an operation without a key
+        void record(trace_opcode op, uint64_t parameter = 0) {
+            std::lock_guard lock(mutex_);
+            write_header(op, parameter);
+        }
+
+        /// \brief Number of records written
+        [[nodiscard]] uint64_t size() const noexcept { return size_; }
+
+      private:
+        void write_header(trace_opcode op, uint64_t parameter) {
+            os_->put(static_cast<char>(op));
+            write_varint(parameter);
+            ++size_;
+        }
+
+        void write_varint(uint64_t v) {
+            while (v >= 0x80) {
+                os_->put(static_cast<char>((v & 0x7F) | 0x80));
+                v >>= 7;
+            }
+            os_->put(static_cast<char>(v));
+        }
+
+        std::ostream *os_;
+        std::mutex mutex_;
+        uint64_t size_{0};
+    };
+
+    /// \brief Record an operation while in scope
+    /// Operations nested in a recorded operation are not recorded.
+    /// A scope without a writer does nothing.
+    class recording_scope {
+      public:
+        /// \brief Record an operation with a key
+        template <class Key>
+        recording_scope(operation_trace_writer *writer, trace_opcode op,
+                        const Key &key, uint64_t parameter = 0)
+            : writer_(writer) {
+            if (writer_ != nullptr) {
+                if (detail::recording_depth()++ == 0) {
+                    writer_->record(op, key, parameter);
+                }
+            }
+        }
+
+        /// \brief Record an operation without a key
+        recording_scope(operation_trace_writer *writer, trace_opcode op,
+                        uint64_t parameter = 0)
+            : writer_(writer) {
+            if (writer_ != nullptr) {
+                if (detail::recording_depth()++ == 0) {
+                    writer_->record(op, parameter);
+                }
+            }
+        }
+
+        /// \brief Do not record the operations in scope
+        explicit recording_scope(operation_trace_writer *writer)
+            : writer_(writer) {
+            if (writer_ != nullptr) {
+                ++detail::recording_depth();
+            }
+        }
+
+        ~recording_scope() {
+            if (writer_ != nullptr) {
+                --detail::recording_depth();
+            }
+        }
+
+        recording_scope(const recording_scope &) = delete;
+        recording_scope &operator=(const recording_scope &) = delete;
+
+        /// \brief True if we are inside a recorded operation
+        static bool nested() noexcept { return detail::recording_depth() > 0; }
+
+      private:
+        operation_trace_writer *writer_;
+    };
+
+    /// \class Reader of operation traces
+    class operation_trace_reader {
+      public:
+        /// \brief Read the trace header from is
+        /// \throw std::runtime_error If the stream is not a trace
+        explicit operation_trace_reader(std::istream &is) : is_(&is) {
+            char magic[sizeof(detail::trace_magic)];
+            if (!is_->read(magic, sizeof(magic)) ||
+                std::memcmp(magic, detail::trace_magic, sizeof(magic)) != 0) {
+                throw std::runtime_error(
+                    "operation_trace_reader: not an operation trace");
+            }
+            const int version = is_->get();
+            if (version != detail::trace_version) {
+                throw std::runtime_error(
+                    "operation_trace_reader: unsupported trace version");
+            }
+        }
+
+        /// \brief Read the next record
+        /// \return False at the end of the trace
+        /// \throw std::runtime_error If the trace is truncated
+        bool next(trace_record &r) {
+            const int op = is_->get();
+            if (op == std::char_traits<char>::eof()) {
+                return false;
+            }
+            if (op > static_cast<int>(trace_opcode::erase_one)) {
+                throw std::runtime_error(
+                    "operation_trace_reader: unknown op code");
+            }
+            r.op = static_cast<trace_opcode>(op);
+            r.parameter = read_varint();
+            r.key.clear();
+            if (has_key(r.op)) {
+                r.key.resize(static_cast<size_t>(read_varint()));
+                for (double &x : r.key) {
+                    if (!detail::read_trace_double(*is_, x)) {
+                        throw std::runtime_error(
+                            "operation_trace_reader: truncated record");
+                    }
+                }
+            }
+            return true;
+        }
+
+        /// \brief Read all remaining records
+        std::vector<trace_record> read_all() {
+            std::vector<trace_record> records;
+            trace_record r;
+            while (next(r)) {
+                records.emplace_back(r);
+            }
+            return records;
+        }
+
+      private:
+        uint64_t read_varint() {
+            uint64_t v = 0;
+            for (size_t shift = 0; shift < 64; shift += 7) {
+                const int c = is_->get();
+                if (c == std::char_traits<char>::eof()) {
+                    throw std::runtime_error(
+                        "operation_trace_reader: truncated record");
+                }
+                v |= static_cast<uint64_t>(c & 0x7F) << shift;
+                if ((c & 0x80) == 0) {
+                    return v;
+                }
+            }
+            throw std::runtime_error("operation_trace_reader: bad varint");
+        }
+
+        std::istream *is_;
+    };
+
+    namespace detail {
+        template <class Adapter, class = void>
+        struct has_resize : std::false_type {};
+
+        template <class Adapter>
+        struct has_resize<Adapter, std::void_t<decltype(std::declval<Adapter &>()
+                                                            .resize(size_t{}))>>
+            : std::true_type {};
+    } // namespace detail
+
+    /// \brief Run a recorded operation on a front or archive
+    /// Resize records are ignored by fronts. Inserted elements get a
+    /// default mapped value.
+    /// \throw std::invalid_argument If the container has another
+    /// number of compile time dimensions
+    /// \return The result of the operation as a number, so that the
+    /// compiler cannot remove queries
+    template <class Adapter>
+    double replay(const trace_record &r, Adapter &container) {
+        using key_type = typename Adapter::key_type;
+        using mapped_type = typename Adapter::mapped_type;
+        using coordinate_type = typename Adapter::dimension_type;
+        key_type k;
+        if (has_key(r.op)) {
+            if (Adapter::number_of_compile_dimensions != 0 &&
+                r.key.size() != Adapter::number_of_compile_dimensions) {
+                throw std::invalid_argument(
+                    "replay: the trace has another number of dimensions");
+            }
+            k = key_type(r.key.size());
+            for (size_t i = 0; i < r.key.size(); ++i) {
+                k[i] = static_cast<coordinate_type>(r.key[i]);
+            }
+        }
+        switch (r.op) {
+        case trace_opcode::insert:
+            return container.insert(std::make_pair(k, mapped_type()))
+                .second;
+        case trace_opcode::erase:
+            return static_cast<double>(container.erase(k));
+        case trace_opcode::erase_one: {
+            auto it = container.find(k);
+            if (it == container.end()) {
+                return 0.;
+            }
+            container.erase(it);
+            return 1.;
+        }
+        case trace_opcode::dominates:
+            return container.dominates(k);
+        case trace_opcode::find_nearest:
+            if (r.parameter == 0) {
+                return container.find_nearest(k) != container.end();
+            }
+            return container.find_nearest(k, r.parameter) != container.end();
+        case trace_opcode::hypervolume:
+            if (r.parameter == 0) {
+                return static_cast<double>(container.hypervolume(k));
+            }
+            return static_cast<double>(container.hypervolume(
+                static_cast<size_t>(r.parameter), k));
+        case trace_opcode::clear:
+            container.clear();
+            return 0.;
+        case trace_opcode::resize:
+            if constexpr (detail::has_resize<Adapter>::value) {
+                container.resize(static_cast<size_t>(r.parameter));
+            }
+            return 0.;
+        }
+        return 0.;
+    }
+} // namespace pareto
+
+#endif // PARETO_OPERATION_TRACE_H
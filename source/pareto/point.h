@@ -9,6 +9,7 @@
 #include <array>
 #include <cassert>
 #include <cmath>
+#include <functional>
 #include <numeric>
 #include <ostream>
 #include <utility>
@@ -177,6 +178,7 @@ namespace pareto {
         /// \return True if this point dominates p
         template<class Rng>
         bool dominates(const point &p, const Rng &is_minimization) const {
+            count_work(&work_stats::dominance_tests);
             auto il = is_minimization.begin();
             auto pi = p.values_.begin();
             bool better_at_any = false;
@@ -210,6 +212,7 @@ namespace pareto {
         /// if x is strictly better than x∗ in all objectives.
         template<class Rng>
         bool strongly_dominates(const point &p, const Rng &is_minimization) const {
+            count_work(&work_stats::dominance_tests);
             auto il = is_minimization.begin();
             auto pi = p.values_.begin();
             for (auto it = values_.begin(); it != values_.end(); it++) {
@@ -547,6 +550,24 @@ namespace pareto {
 
 }
 
+namespace std {
+    /// \brief Hash points so that they can be keys of unordered containers
+    /// Equal points have equal hashes, as required by point::operator==.
+    template <typename T, std::size_t M, typename CoordinateSystem>
+    struct hash<pareto::point<T, M, CoordinateSystem>> {
+        std::size_t operator()(
+            const pareto::point<T, M, CoordinateSystem> &p) const noexcept {
+            std::size_t seed = p.dimensions();
+            for (const auto &x : p) {
+                // same as boost::hash_combine
+                seed ^= std::hash<T>()(x) + 0x9e3779b9 + (seed << 6) +
+                        (seed >> 2);
+            }
+            return seed;
+        }
+    };
+} // namespace std
+
 #ifdef BUILD_BOOST_TREE
 /// Define traits for boost geometry to understand out point type
 /// This is for our preliminary experiments comparing our r-containers with
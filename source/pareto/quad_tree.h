@@ -13,10 +13,12 @@
 #include <forward_list>
 #include <functional>
 #include <map>
+#include <optional>
 #include <queue>
 #include <sstream>
 #include <vector>
 
+#include <pareto/common/hash_index.h>
 #include <pareto/point.h>
 #include <pareto/query/predicates.h>
 #include <pareto/query/query_box.h>
@@ -50,9 +52,9 @@ namespace pareto {
         using unprotected_key_type = unprotected_point_type;
         using protected_key_type = protected_point_type;
         using unprotected_value_type =
-            std::pair<unprotected_key_type, unprotected_mapped_type>;
+            element_pair_t<unprotected_key_type, unprotected_mapped_type>;
         using protected_value_type =
-            std::pair<protected_key_type, unprotected_mapped_type>;
+            element_pair_t<protected_key_type, unprotected_mapped_type>;
         using unprotected_allocator_type = typename std::allocator_traits<
             A>::template rebind_alloc<unprotected_value_type>;
         using unprotected_vector_type =
@@ -492,12 +494,14 @@ namespace pareto {
                 nearest_queue_.emplace_back(
                     current_node_, true,
                     nearest_predicate->distance(current_node_->value_.first));
+                count_work(&work_stats::heap_pushes);
                 std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
                                queue_comp);
                 for (auto &child : current_node_->children_) {
                     nearest_queue_.emplace_back(
                         child.second, false,
                         nearest_predicate->distance(current_node_->bounds_));
+                    count_work(&work_stats::heap_pushes);
                     std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
                                    queue_comp);
                 }
@@ -543,6 +547,7 @@ namespace pareto {
                     auto [element_node, is_value, distance] =
                         nearest_queue_.front();
                     auto &element = element_node->value_;
+                    count_work(&work_stats::heap_pops);
                     std::pop_heap(nearest_queue_.begin(), nearest_queue_.end(),
                                   queue_comp);
                     nearest_queue_.pop_back();
@@ -579,6 +584,7 @@ namespace pareto {
                             }
                         }
                     } else {
+                        count_work(&work_stats::nodes_visited);
                         // 11. else if Element is a leaf node then
                         // 15. else /* Element is a non-leaf node*/
                         // These two conditions have blocks enqueuing all child
@@ -592,6 +598,7 @@ namespace pareto {
                             element_node, true,
                             nearest_predicate->distance(
                                 element_node->value_.first));
+                        count_work(&work_stats::heap_pushes);
                         std::push_heap(nearest_queue_.begin(),
                                        nearest_queue_.end(), queue_comp);
                         for (auto &child : element_node->children_) {
@@ -603,6 +610,7 @@ namespace pareto {
                                 child.second, false,
                                 nearest_predicate->distance(
                                     child.second->bounds_));
+                            count_work(&work_stats::heap_pushes);
                             std::push_heap(nearest_queue_.begin(),
                                            nearest_queue_.end(), queue_comp);
                         }
@@ -664,6 +672,7 @@ namespace pareto {
                     // return if first time
                     // if we haven't checked the current node yet
                     if (first_time_in_this_branch) {
+                        count_work(&work_stats::nodes_visited);
                         if (predicates_.pass_predicate(current_node_->value_)) {
                             // found a valid value in current node
                             // point to it (already does) and return
@@ -718,6 +727,7 @@ namespace pareto {
                 while (!is_begin()) {
                     // return if first time
                     if (first_time_in_this_branch) {
+                        count_work(&work_stats::nodes_visited);
                         if (predicates_.pass_predicate(current_node_->value_)) {
                             // found a valid value in current node
                             // point to it (already does) and return
@@ -955,6 +965,9 @@ namespace pareto {
             } else {
                 root_ = nullptr;
             }
+            if (rhs.has_hash_index()) {
+                enable_hash_index();
+            }
         }
 
         /// \brief Copy constructor data but use another allocator
@@ -969,6 +982,9 @@ namespace pareto {
             } else {
                 root_ = nullptr;
             }
+            if (rhs.has_hash_index()) {
+                enable_hash_index();
+            }
         }
 
         /// \brief Move constructor
@@ -976,10 +992,12 @@ namespace pareto {
         /// by move-constructing from the allocator belonging to
         /// the old container
         quad_tree(quad_tree &&rhs) noexcept
-            : root_(std::move(rhs.root_)), size_(rhs.size_),
+            : container_with_pool(std::move(rhs)),
+              root_(std::move(rhs.root_)), size_(rhs.size_),
               dimensions_(rhs.dimensions_), alloc_(std::move(rhs.alloc_)),
-              comp_(rhs.comp_) {
+              comp_(rhs.comp_), index_(std::move(rhs.index_)) {
             rhs.root_ = nullptr;
+            rhs.index_.reset();
         }
 
         /// \brief Move constructor data but use new allocator
@@ -988,8 +1006,9 @@ namespace pareto {
               dimensions_(rhs.dimensions_),
               alloc_(std::allocator_traits<node_allocator_type>::
                          select_on_container_copy_construction(alloc)),
-              comp_(rhs.comp_) {
+              comp_(rhs.comp_), index_(std::move(rhs.index_)) {
             rhs.root_ = nullptr;
+            rhs.index_.reset();
         }
 
         /// \brief Destructor
@@ -1084,6 +1103,10 @@ namespace pareto {
             } else {
                 root_ = nullptr;
             }
+            index_.reset();
+            if (rhs.has_hash_index()) {
+                enable_hash_index();
+            }
             return *this;
         };
 
@@ -1113,10 +1136,12 @@ namespace pareto {
             if constexpr (should_move) {
                 alloc_ = std::move(rhs.alloc_);
                 root_ = rhs.root_;
+                index_ = std::move(rhs.index_);
             } else {
                 const bool same_memory_resources = alloc_ == rhs.alloc_;
                 if (same_memory_resources) {
                     root_ = rhs.root_;
+                    index_ = std::move(rhs.index_);
                 } else {
                     if (rhs.root_ != nullptr) {
                         root_ = allocate_quadtree_node();
@@ -1124,9 +1149,14 @@ namespace pareto {
                     } else {
                         root_ = nullptr;
                     }
+                    index_.reset();
+                    if (rhs.has_hash_index()) {
+                        enable_hash_index();
+                    }
                 }
             }
             rhs.root_ = nullptr;
+            rhs.index_.reset();
             return *this;
         }
 
@@ -1314,6 +1344,7 @@ namespace pareto {
             std::swap(size_, rhs.size_);
             std::swap(dimensions_, rhs.dimensions_);
             std::swap(comp_, rhs.comp_);
+            std::swap(index_, rhs.index_);
             const bool should_swap = std::allocator_traits<
                 allocator_type>::propagate_on_container_swap::value;
             if constexpr (should_swap) {
@@ -1328,6 +1359,9 @@ namespace pareto {
             remove_all_records();
             root_ = nullptr;
             size_ = 0;
+            if (index_) {
+                index_->clear();
+            }
         }
 
         /// Insert entry
@@ -1392,8 +1426,16 @@ namespace pareto {
         }
 
         /// \brief Erase element
+        /// We look for the element again to get a mutable iterator to it.
+        /// Other elements might have the same key, so we compare addresses.
         iterator erase(const_iterator position) {
-            return erase(create_unconst_iterator(position));
+            for (iterator it = find_intersection(position->first);
+                 it != end(); ++it) {
+                if (&*it == &*position) {
+                    return erase(it);
+                }
+            }
+            return end();
         }
 
         /// Erase element
@@ -1436,6 +1478,14 @@ namespace pareto {
 
         /// \brief Erase elements with given key
         size_type erase(const key_type &k) {
+            if (index_) {
+                size_type s = 0;
+                while (quadtree_node *node = index_->find(k)) {
+                    erase_impl(node);
+                    ++s;
+                }
+                return s;
+            }
             iterator first = find_intersection(k);
             iterator last = end();
             auto s = static_cast<size_type>(std::distance(first, last));
@@ -1452,6 +1502,9 @@ namespace pareto {
         /// \brief Returns the number of elements with key that compares
         /// equivalent to the specified argument.
         size_type count(const key_type &k) const {
+            if (index_) {
+                return index_->count(k);
+            }
             iterator it = (const_cast<quad_tree *>(this))->find_intersection(k);
             iterator end = (const_cast<quad_tree *>(this))->end();
             return static_cast<size_type>(std::distance(it, end));
@@ -1460,12 +1513,14 @@ namespace pareto {
         /// \brief Returns the number of elements with key that compares
         /// equivalent to the specified argument.
         template <class L> size_type count(const L &k) const {
-            iterator it = find_intersection(key_type{k}, key_type{k});
-            return static_cast<size_type>(std::distance(it, end()));
+            return count(key_type{k});
         }
 
         /// \brief Finds an element with key equivalent to key
         iterator find(const key_type &k) {
+            if (index_) {
+                return iterator(this, index_->find(k));
+            }
             iterator it = find_intersection(k, k);
             it.predicates_.clear();
             return it;
@@ -1473,6 +1528,9 @@ namespace pareto {
 
         /// \brief Finds an element with key equivalent to key
         const_iterator find(const key_type &k) const {
+            if (index_) {
+                return const_iterator(this, index_->find(k));
+            }
             const_iterator it = find_intersection(k, k);
             it.predicates_.clear();
             return it;
@@ -1480,16 +1538,12 @@ namespace pareto {
 
         /// \brief Finds an element with key equivalent to key
         template <class L> iterator find(const L &x) {
-            iterator it = find_intersection(key_type{x}, key_type{x});
-            it.predicates_.clear();
-            return it;
+            return find(key_type{x});
         }
 
         /// \brief Finds an element with key equivalent to key
         template <class L> const_iterator find(const L &x) const {
-            const_iterator it = find_intersection(key_type{x}, key_type{x});
-            it.predicates_.clear();
-            return it;
+            return find(key_type{x});
         }
 
         /// \brief Finds an element with key equivalent to key
@@ -1500,6 +1554,30 @@ namespace pareto {
             return find(x) != end();
         }
 
+      public /* Hash index */:
+        /// \brief Keep a hash index for exact lookups
+        /// With the index, find, count, contains and erase by key take
+        /// O(1) expected time instead of a box query.
+        /// \see kd_tree::enable_hash_index
+        void enable_hash_index() {
+            if (index_) {
+                return;
+            }
+            index_.emplace();
+            index_->reserve(size_);
+            if (root_ != nullptr) {
+                index_recursive(root_);
+            }
+        }
+
+        /// \brief Drop the hash index
+        void disable_hash_index() noexcept { index_.reset(); }
+
+        /// \brief Whether exact lookups go through the hash index
+        [[nodiscard]] bool has_hash_index() const noexcept {
+            return index_.has_value();
+        }
+
       public /* Query iterators */:
         /// \brief Get iterator to first element that passes the list of
         /// predicates
@@ -1797,6 +1875,9 @@ namespace pareto {
             /// If root node is empty, put the value there
             if (root_node == nullptr) {
                 root_node = allocate_quadtree_node(nullptr, v);
+                if (index_) {
+                    index_->insert(v.first, root_node);
+                }
                 ++size_;
                 return root_node;
             }
@@ -1815,6 +1896,9 @@ namespace pareto {
             /// The element would be in current->children_[quadrant]
             quadtree_node *new_node = allocate_quadtree_node(current, v);
             current->children_.emplace(quadrant, new_node);
+            if (index_) {
+                index_->insert(v.first, new_node);
+            }
 
             /// \brief Adjust the minimum bounds up to the root
             current->bounds_.stretch(v.first);
@@ -1857,6 +1941,7 @@ namespace pareto {
                 root_ = nullptr;
             }
             // deallocate node
+            unindex(node_to_remove);
             deallocate_quadtree_node(node_to_remove);
             assert(size_ > 0);
             --size_;
@@ -1868,6 +1953,7 @@ namespace pareto {
                     b.first.end(), comp_);
             };
             std::sort(reinsert_list.begin(), reinsert_list.end(), comp);
+            count_work(&work_stats::reinsertions, reinsert_list.size());
             bulk_insert(reinsert_list,
                         current_node == nullptr ? root_ : current_node);
 
@@ -1921,6 +2007,7 @@ namespace pareto {
             for (auto &[quadrant, child_node] : node_to_remove->children_) {
                 if (child_node->children_.empty()) {
                     reinsert_list.emplace_back(child_node->value_);
+                    unindex(child_node);
                     deallocate_quadtree_node(child_node);
                     --size_;
                 } else {
@@ -1930,6 +2017,7 @@ namespace pareto {
             if (move_root) {
                 --size_;
                 reinsert_list.emplace_back(node_to_remove->value_);
+                unindex(node_to_remove);
                 deallocate_quadtree_node(node_to_remove);
             }
         }
@@ -1993,6 +2081,21 @@ namespace pareto {
             }
         }
 
+        /// \brief Add a subtree to the hash index
+        void index_recursive(quadtree_node *node) {
+            index_->insert(node->value_.first, node);
+            for (auto &child : node->children_) {
+                index_recursive(child.second);
+            }
+        }
+
+        /// \brief Remove a node we are about to deallocate from the index
+        void unindex(quadtree_node *node) {
+            if (index_) {
+                index_->erase(node->value_.first, node);
+            }
+        }
+
         /// \brief Remove all points from the containers
         void remove_all_records() {
             if (root_ == nullptr) {
@@ -2043,6 +2146,7 @@ namespace pareto {
         /// \brief Allocate a quadtree-node
         template <class... Args>
         quadtree_node *allocate_quadtree_node(Args &&...args) {
+            count_work(&work_stats::allocations);
             auto p =
                 std::allocator_traits<node_allocator_type>::allocate(alloc_, 1);
             std::allocator_traits<node_allocator_type>::construct(
@@ -2052,6 +2156,7 @@ namespace pareto {
 
         /// \brief Deallocate a quadtree-node
         void deallocate_quadtree_node(quadtree_node *p) {
+            count_work(&work_stats::deallocations);
             std::allocator_traits<node_allocator_type>::destroy(alloc_, p);
             std::allocator_traits<node_allocator_type>::deallocate(alloc_, p,
                                                                    1);
@@ -2082,6 +2187,9 @@ namespace pareto {
 
         /// \brief Key comparison (single dimension)
         dimension_compare comp_{dimension_compare()};
+
+        /// \brief Optional hash index from keys to nodes
+        std::optional<hash_index<key_type, quadtree_node *>> index_;
     };
 
     // MSVC hack (we cannot define it inside iterator_impl)
@@ -222,6 +222,7 @@ namespace pareto {
         /// We use the underlying predicate function to check that
         /// The underlying predicate uses the querybox functions to check that
         bool pass_predicate(const query_box_type &rhs) const {
+            count_predicate(predicate_.index(), true);
             return std::visit([&rhs](const auto &predicate) { return predicate.pass_predicate(rhs); }, predicate_);
         }
 
@@ -229,6 +230,7 @@ namespace pareto {
         /// We use the underlying predicate function to check that
         /// The underlying predicate uses the querybox functions to check that
         bool might_pass_predicate(const query_box_type &rhs) const {
+            count_predicate(predicate_.index(), true);
             return std::visit([&rhs](const auto &predicate) { return predicate.might_pass_predicate(rhs); },
                               predicate_);
         }
@@ -237,6 +239,7 @@ namespace pareto {
         /// We use the underlying predicate function to check that
         /// The underlying predicate uses the querybox functions to check that
         bool pass_predicate(const point_type &rhs) const {
+            count_predicate(predicate_.index(), false);
             return std::visit([&rhs](const auto &predicate) { return predicate.pass_predicate(rhs); }, predicate_);
         }
 
@@ -244,6 +247,7 @@ namespace pareto {
         /// We use the underlying predicate function to check that
         /// The underlying predicate uses the querybox functions to check that
         bool might_pass_predicate(const point_type &rhs) const {
+            count_predicate(predicate_.index(), false);
             return std::visit([&rhs](const auto &predicate) { return predicate.might_pass_predicate(rhs); },
                               predicate_);
         }
@@ -252,6 +256,7 @@ namespace pareto {
         /// We use the underlying predicate function to check that
         /// The underlying predicate uses the querybox functions to check that
         bool pass_predicate(const value_type &rhs) const {
+            count_predicate(predicate_.index(), false);
             return std::visit([&rhs](const auto &predicate) { return predicate.pass_predicate(rhs); }, predicate_);
         }
 
@@ -259,6 +264,7 @@ namespace pareto {
         /// We use the underlying predicate function to check that
         /// The underlying predicate uses the querybox functions to check that
         bool might_pass_predicate(const value_type &rhs) const {
+            count_predicate(predicate_.index(), false);
             return std::visit([&rhs](const auto &predicate) { return predicate.might_pass_predicate(rhs); },
                               predicate_);
         }
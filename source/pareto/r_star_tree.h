@@ -46,9 +46,9 @@ namespace pareto {
         using unprotected_key_type = unprotected_point_type;
         using protected_key_type = protected_point_type;
         using unprotected_value_type =
-            std::pair<unprotected_key_type, unprotected_mapped_type>;
+            element_pair_t<unprotected_key_type, unprotected_mapped_type>;
         using protected_value_type =
-            std::pair<protected_key_type, unprotected_mapped_type>;
+            element_pair_t<protected_key_type, unprotected_mapped_type>;
         using unprotected_allocator_type = typename std::allocator_traits<
             A>::template rebind_alloc<unprotected_value_type>;
         using unprotected_vector_type =
@@ -706,6 +706,7 @@ namespace pareto {
                         current_node_, i,
                         current_node_->branches_[i].distance(
                             *nearest_predicate));
+                    count_work(&work_stats::heap_pushes);
                     std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
                                    queue_comp);
                 }
@@ -751,6 +752,7 @@ namespace pareto {
                     std::conditional_t<is_const, const branch_variant,
                                        branch_variant> &element =
                         element_node->branches_[element_index];
+                    count_work(&work_stats::heap_pops);
                     std::pop_heap(nearest_queue_.begin(), nearest_queue_.end(),
                                   queue_comp);
                     nearest_queue_.pop_back();
@@ -788,6 +790,7 @@ namespace pareto {
                             }
                         }
                     } else {
+                        count_work(&work_stats::nodes_visited);
                         // 11. else if Element is a leaf node then
                         // 15. else /* Element is a non-leaf node*/
                         // These two conditions have blocks enqueuing all child
@@ -806,6 +809,7 @@ namespace pareto {
                                 element.as_node(), i,
                                 element.as_node()->branches_[i].distance(
                                     *nearest_predicate));
+                            count_work(&work_stats::heap_pushes);
                             std::push_heap(nearest_queue_.begin(),
                                            nearest_queue_.end(), queue_comp);
                         }
@@ -906,6 +910,7 @@ namespace pareto {
                                 // Found a value branch in a node
                                 // Point to it and continue looking until we
                                 // find a value branch
+                                count_work(&work_stats::nodes_visited);
                                 current_node_ = current_node_->branches_[index]
                                                     .as_branch()
                                                     .second;
@@ -993,6 +998,7 @@ namespace pareto {
                                 // Found a value branch in a node
                                 // Point to it and continue looking until we
                                 // find a value branch
+                                count_work(&work_stats::nodes_visited);
                                 current_node_ = current_node_->branches_[index]
                                                     .as_branch()
                                                     .second;
@@ -1202,7 +1208,8 @@ namespace pareto {
         /// by move-constructing from the allocator belonging to
         /// the old container
         r_star_tree(r_star_tree &&rhs) noexcept
-            : root_(std::move(rhs.root_)), size_(rhs.size_),
+            : container_with_pool(std::move(rhs)),
+              root_(std::move(rhs.root_)), size_(rhs.size_),
               dimensions_(rhs.dimensions_),
               unit_sphere_volume_(rhs.unit_sphere_volume_),
               alloc_(std::move(rhs.alloc_)), comp_(rhs.comp_) {
@@ -1675,8 +1682,16 @@ namespace pareto {
         }
 
         /// \brief Erase element
+        /// We look for the element again to get a mutable iterator to it.
+        /// Other elements might have the same key, so we compare addresses.
         iterator erase(const_iterator position) {
-            return erase(create_unconst_iterator(position));
+            for (iterator it = find_intersection(position->first);
+                 it != end(); ++it) {
+                if (&*it == &*position) {
+                    return erase(it);
+                }
+            }
+            return end();
         }
 
         /// \brief Erase element
@@ -2347,6 +2362,7 @@ namespace pareto {
             choose_partition(par_vars, minnodes_);
 
             // Create a new node to hold (about) half the branches
+            count_work(&work_stats::node_splits);
             new_tree_node = allocate_rstar_tree_node();
             new_tree_node->level_ = old_node->level_;
             new_tree_node->parent_ = old_node->parent_;
@@ -2405,6 +2421,7 @@ namespace pareto {
             // the center)
             std::vector<branch_variant> removed_items(
                 buffer.begin() + n_items - p, buffer.end());
+            count_work(&work_stats::reinsertions, p);
             std::copy(buffer.begin(), buffer.begin() + n_items - p,
                       parent_node->branches_.begin());
             parent_node->count_ = parent_node->count_ - p + 1;
@@ -2935,6 +2952,8 @@ namespace pareto {
 
                 // This list node has less than minnodes_, so
                 // For each branch of this node, put it in the root
+                count_work(&work_stats::reinsertions,
+                           temp_rstar_tree_node->count_);
                 for (size_t index = 0; index < temp_rstar_tree_node->count_;
                      ++index) {
                     insert_branch(temp_rstar_tree_node->branches_[index],
@@ -3030,6 +3049,7 @@ namespace pareto {
                 // If branch doesn't have the minimum number of elements anymore
                 // Eliminate the node from the containers.
                 // Put the elements in a reinsert_list.
+                count_work(&work_stats::node_merges);
                 reinsert_list.emplace_back(
                     parent_node->branches_[index].as_node());
                 // Erase node from the containers
@@ -3152,7 +3172,7 @@ namespace pareto {
                 for (size_t index = 0; index < current->count_; ++index) {
                     const value_type &other_rtree_branch =
                         other->branches_[index].as_value();
-                    current->branches_[index] = branch_variant(std::make_pair(
+                    current->branches_[index] = branch_variant(unprotected_value_type(
                         other_rtree_branch.first, other_rtree_branch.second));
                 }
             }
@@ -3311,6 +3331,14 @@ namespace pareto {
                          rstar_tree_node *&node) {
             // bulk insert ranges {1, median - 1}, median, { median + 1, end()}
             if (!v.empty()) {
+                // insert_branch does not keep track of the records
+                if constexpr (number_of_compile_dimensions == 0) {
+                    if (dimensions_ == 0) {
+                        dimensions_ = v[0].first.dimensions();
+                        initialize_unit_sphere_volume();
+                    }
+                }
+                size_ += v.size();
                 if (v.size() == 1) {
                     insert_branch(branch_variant(v[0]), node, 0, true);
                 } else {
@@ -3354,6 +3382,7 @@ namespace pareto {
       private /* Allocate nodes */:
         /// \brief Allocate a quadtree-node
         template <class... Args> rstar_tree_node *allocate_rstar_tree_node() {
+            count_work(&work_stats::allocations);
             auto p =
                 std::allocator_traits<node_allocator_type>::allocate(alloc_, 1);
             std::allocator_traits<node_allocator_type>::construct(alloc_, p, 0,
@@ -3363,6 +3392,7 @@ namespace pareto {
 
         /// \brief Deallocate a quadtree-node
         void deallocate_rstar_tree_node(rstar_tree_node *p) {
+            count_work(&work_stats::deallocations);
             std::allocator_traits<node_allocator_type>::destroy(alloc_, p);
             std::allocator_traits<node_allocator_type>::deallocate(alloc_, p,
                                                                    1);
@@ -3382,7 +3412,7 @@ namespace pareto {
         size_t dimensions_{0};
 
         /// Unit sphere constant for required number of dimensions
-        dimension_type unit_sphere_volume_;
+        dimension_type unit_sphere_volume_{0};
 
         /// Node allocator
         /// It's fundamental to allocate our nodes with an efficient allocator
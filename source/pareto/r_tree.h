@@ -66,9 +66,9 @@ namespace pareto {
         using unprotected_key_type = unprotected_point_type;
         using protected_key_type = protected_point_type;
         using unprotected_value_type =
-            std::pair<unprotected_key_type, unprotected_mapped_type>;
+            element_pair_t<unprotected_key_type, unprotected_mapped_type>;
         using protected_value_type =
-            std::pair<protected_key_type, unprotected_mapped_type>;
+            element_pair_t<protected_key_type, unprotected_mapped_type>;
         using unprotected_allocator_type = typename std::allocator_traits<
             A>::template rebind_alloc<unprotected_value_type>;
         using unprotected_vector_type =
@@ -711,6 +711,7 @@ namespace pareto {
                         current_node_, i,
                         current_node_->branches_[i].distance(
                             *nearest_predicate));
+                    count_work(&work_stats::heap_pushes);
                     std::push_heap(nearest_queue_.begin(), nearest_queue_.end(),
                                    queue_comp);
                 }
@@ -756,6 +757,7 @@ namespace pareto {
                     std::conditional_t<is_const, const branch_variant,
                                        branch_variant> &element =
                         element_node->branches_[element_index];
+                    count_work(&work_stats::heap_pops);
                     std::pop_heap(nearest_queue_.begin(), nearest_queue_.end(),
                                   queue_comp);
                     nearest_queue_.pop_back();
@@ -793,6 +795,7 @@ namespace pareto {
                             }
                         }
                     } else {
+                        count_work(&work_stats::nodes_visited);
                         // 11. else if Element is a leaf node then
                         // 15. else /* Element is a non-leaf node*/
                         // These two conditions have blocks enqueuing all child
@@ -811,6 +814,7 @@ namespace pareto {
                                 element.as_node(), i,
                                 element.as_node()->branches_[i].distance(
                                     *nearest_predicate));
+                            count_work(&work_stats::heap_pushes);
                             std::push_heap(nearest_queue_.begin(),
                                            nearest_queue_.end(), queue_comp);
                         }
@@ -911,6 +915,7 @@ namespace pareto {
                                 // Found a value branch in a node
                                 // Point to it and continue looking until we
                                 // find a value branch
+                                count_work(&work_stats::nodes_visited);
                                 current_node_ = current_node_->branches_[index]
                                                     .as_branch()
                                                     .second;
@@ -998,6 +1003,7 @@ namespace pareto {
                                 // Found a value branch in a node
                                 // Point to it and continue looking until we
                                 // find a value branch
+                                count_work(&work_stats::nodes_visited);
                                 current_node_ = current_node_->branches_[index]
                                                     .as_branch()
                                                     .second;
@@ -1207,7 +1213,8 @@ namespace pareto {
         /// by move-constructing from the allocator belonging to
         /// the old container
         r_tree(r_tree &&rhs) noexcept
-            : root_(std::move(rhs.root_)), size_(rhs.size_),
+            : container_with_pool(std::move(rhs)),
+              root_(std::move(rhs.root_)), size_(rhs.size_),
               dimensions_(rhs.dimensions_),
               unit_sphere_volume_(rhs.unit_sphere_volume_),
               alloc_(std::move(rhs.alloc_)), comp_(rhs.comp_) {
@@ -1684,8 +1691,16 @@ namespace pareto {
         }
 
         /// \brief Erase element
+        /// We look for the element again to get a mutable iterator to it.
+        /// Other elements might have the same key, so we compare addresses.
         iterator erase(const_iterator position) {
-            return erase(create_unconst_iterator(position));
+            for (iterator it = find_intersection(position->first);
+                 it != end(); ++it) {
+                if (&*it == &*position) {
+                    return erase(it);
+                }
+            }
+            return end();
         }
 
         /// \brief Erase element
@@ -2292,6 +2307,7 @@ namespace pareto {
             choose_partition(par_vars, minnodes_);
 
             // Create a new node to hold (about) half of the branches
+            count_work(&work_stats::node_splits);
             new_tree_node = allocate_rtree_node();
             new_tree_node->level_ = old_node->level_;
             new_tree_node->parent_ = old_node->parent_;
@@ -2655,6 +2671,8 @@ namespace pareto {
 
                 // This list node has less than minnodes_, so
                 // For each branch of this node, put it in the root
+                count_work(&work_stats::reinsertions,
+                           temp_rtree_node->count_);
                 for (size_t index = 0; index < temp_rtree_node->count_;
                      ++index) {
                     insert_branch(temp_rtree_node->branches_[index], root_node,
@@ -2749,6 +2767,7 @@ namespace pareto {
                 // If branch doesn't have the minimum number of elements anymore
                 // Eliminate the node from the containers.
                 // Put the elements in a reinsert_list.
+                count_work(&work_stats::node_merges);
                 reinsert_list.emplace_back(
                     parent_node->branches_[index].as_node());
                 // Erase node from the containers
@@ -2868,7 +2887,7 @@ namespace pareto {
                 for (size_t index = 0; index < current->count_; ++index) {
                     const value_type &other_rtree_branch =
                         other->branches_[index].as_value();
-                    current->branches_[index] = branch_variant(std::make_pair(
+                    current->branches_[index] = branch_variant(unprotected_value_type(
                         other_rtree_branch.first, other_rtree_branch.second));
                 }
             }
@@ -3029,6 +3048,14 @@ namespace pareto {
                          rtree_node *&node) {
             // bulk insert ranges {1, median - 1}, median, { median + 1, end()}
             if (!v.empty()) {
+                // insert_branch does not keep track of the records
+                if constexpr (number_of_compile_dimensions == 0) {
+                    if (dimensions_ == 0) {
+                        dimensions_ = v[0].first.dimensions();
+                        initialize_unit_sphere_volume();
+                    }
+                }
+                size_ += v.size();
                 if (v.size() == 1) {
                     insert_branch(branch_variant(v[0]), node, 0);
                 } else {
@@ -3072,6 +3099,7 @@ namespace pareto {
       private /* Allocate nodes */:
         /// \brief Allocate a quadtree-node
         template <class... Args> rtree_node *allocate_rtree_node() {
+            count_work(&work_stats::allocations);
             auto p =
                 std::allocator_traits<node_allocator_type>::allocate(alloc_, 1);
             std::allocator_traits<node_allocator_type>::construct(alloc_, p, 0,
@@ -3081,6 +3109,7 @@ namespace pareto {
 
         /// \brief Deallocate a quadtree-node
         void deallocate_rtree_node(rtree_node *p) {
+            count_work(&work_stats::deallocations);
             std::allocator_traits<node_allocator_type>::destroy(alloc_, p);
             std::allocator_traits<node_allocator_type>::deallocate(alloc_, p,
                                                                    1);
@@ -3100,7 +3129,7 @@ namespace pareto {
         size_t dimensions_{0};
 
         /// \brief Unit sphere constant for required number of dimensions
-        dimension_type unit_sphere_volume_;
+        dimension_type unit_sphere_volume_{0};
 
         /// \brief Node allocator
         /// It's fundamental to allocate our nodes with an efficient allocator
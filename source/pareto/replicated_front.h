@@ -0,0 +1,107 @@
+#ifndef PARETO_REPLICATED_FRONT_H
+#define PARETO_REPLICATED_FRONT_H
+
+#include <memory>
+#include <vector>
+
+#include <pareto/common/numa.h>
+#include <pareto/front.h>
+
+namespace pareto {
+    /// \class Replicated Pareto Front
+    /// A read-mostly front with one replica per NUMA node. Reference
+    /// fronts (e.g. for IGD or to filter candidates) are queried by
+    /// workers on all sockets, and every node access is a remote access
+    /// for the workers on the other sockets. Each replica keeps its
+    /// nodes on its own NUMA node, and local() returns the replica on
+    /// the node of the calling thread.
+    ///
+    /// Modifiers update all replicas, so they are as expensive as one
+    /// modification per node. They must not run concurrently with
+    /// readers.
+    /// \note Replicas are only bound to their nodes with
+    /// BUILD_PARETO_WITH_PMR. Otherwise, all replicas are placed on
+    /// the node of the thread that creates them.
+    template <typename K, size_t M, typename T,
+              class Container = spatial_map<K, M, T>>
+    class replicated_front {
+      public /* Types */:
+        using front_type = front<K, M, T, Container>;
+        using value_type = typename front_type::value_type;
+        using key_type = typename front_type::key_type;
+        using size_type = typename front_type::size_type;
+
+      public /* Constructors */:
+        /// \brief Create one replica of reference per NUMA node
+        explicit replicated_front(
+            const front_type &reference,
+            size_t number_of_replicas = number_of_numa_nodes()) {
+            assign(reference, number_of_replicas);
+        }
+
+      public /* Replicas */:
+        /// \brief Number of replicas
+        [[nodiscard]] size_t number_of_replicas() const noexcept {
+            return replicas_.size();
+        }
+
+        /// \brief Replica on a given NUMA node
+        const front_type &replica(size_t node) const {
+            return *replicas_.at(node);
+        }
+
+        /// \brief Replica on the NUMA node of the calling thread
+        const front_type &local() const {
+            const size_t node = static_cast<size_t>(current_numa_node());
+            return *replicas_[node % replicas_.size()];
+        }
+
+      public /* Modifiers */:
+        /// \brief Replace all replicas with copies of reference
+        void assign(const front_type &reference,
+                    size_t number_of_replicas = number_of_numa_nodes()) {
+            replicas_.clear();
+            for (size_t node = 0; node < std::max(number_of_replicas, size_t{1});
+                 ++node) {
+                // the pool of each replica is created with the node hint
+                numa_node_guard guard(static_cast<int>(node));
+                // copy assignment keeps the allocator of the replica
+                auto replica = std::make_unique<front_type>();
+                *replica = reference;
+                replicas_.emplace_back(std::move(replica));
+            }
+        }
+
+        /// \brief Insert element in all replicas
+        /// \return True if the element was inserted
+        bool insert(const value_type &v) {
+            bool inserted = false;
+            for (auto &replica : replicas_) {
+                inserted = replica->insert(v).second;
+            }
+            return inserted;
+        }
+
+        /// \brief Erase element from all replicas
+        /// \return Number of elements erased from each replica
+        size_type erase(const key_type &k) {
+            size_type erased = 0;
+            for (auto &replica : replicas_) {
+                erased = replica->erase(k);
+            }
+            return erased;
+        }
+
+        /// \brief Clear all replicas
+        void clear() {
+            for (auto &replica : replicas_) {
+                replica->clear();
+            }
+        }
+
+      private:
+        std::vector<std::unique_ptr<front_type>> replicas_;
+    };
+} // namespace pareto
+
+#endif // PARETO_REPLICATED_FRONT_H
@@ -0,0 +1,505 @@
+#ifndef PARETO_SHARDED_FRONT_H
+#define PARETO_SHARDED_FRONT_H
+
+#include <algorithm>
+#include <atomic>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <pareto/common/numa.h>
+#include <pareto/common/parallel.h>
+#include <pareto/front.h>
+
+namespace pareto {
+    /// \class Sharded Pareto Front
+    /// A sharded front holds one local front per worker. This is the
+    /// layout of island-model optimizers, where each thread owns its
+    /// own front and a global front is periodically reduced from all
+    /// of them.
+    ///
+    /// Each worker only inserts into its own shard, so local inserts
+    /// need no locks at all. The global view (dominates, find_nearest,
+    /// iteration, consolidate) considers the elements of all shards
+    /// that are not dominated by any other shard. Queries run on the
+    /// workers of the default thread pool once the shards hold at least
+    /// parallel_threshold() elements. Smaller shards are queried by the
+    /// calling thread, because handing them to workers costs more than
+    /// the queries themselves.
+    ///
+    /// Each shard can be bound to the NUMA node of the worker that
+    /// owns it with bind_shard, so the worker never reads remote nodes.
+    ///
+    /// The list of global elements is cached until a shard changes, so
+    /// begin() only merges the shards once per batch of insertions.
+    ///
+    /// \warning The global view reads all shards. It must not be used
+    /// while the workers are inserting into their shards.
+    template <typename K, size_t M, typename T,
+              class Container = spatial_map<K, M, T>>
+    class sharded_front {
+      public /* Types */:
+        using front_type = front<K, M, T, Container>;
+        using container_type = Container;
+        using value_type = typename front_type::value_type;
+        using key_type = typename front_type::key_type;
+        using mapped_type = typename front_type::mapped_type;
+        using size_type = typename front_type::size_type;
+        using difference_type = typename front_type::difference_type;
+        using dimension_type = typename front_type::dimension_type;
+        using directions_type = typename front_type::directions_type;
+        static constexpr size_t number_of_compile_dimensions = M;
+
+      private /* Internal types */:
+        using point_type = key_type;
+
+        /// \brief A front on its own cache line
+        /// Workers update their shards concurrently, so the shards
+        /// should not share cache lines. Each slot is allocated on its
+        /// own so that a shard can be rebuilt on another NUMA node.
+        struct alignas(64) shard_slot {
+            front_type front_;
+        };
+        using shard_pointer = std::unique_ptr<shard_slot>;
+
+      public /* Iterators */:
+        /// \brief Iterator over the global non-dominated elements
+        /// begin() merges the shards into a list of the global elements,
+        /// which the iterators and later calls to begin() share. The
+        /// elements are visited in lexicographic order of their
+        /// objectives, with the maximized objectives negated, which is
+        /// the order of the merge.
+        class const_iterator {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename sharded_front::value_type;
+            using difference_type = typename sharded_front::difference_type;
+            using pointer = const value_type *;
+            using reference = const value_type &;
+
+            /// \brief A global element and the shard that holds it
+            struct entry {
+                size_t shard;
+                const value_type *element;
+            };
+            using entry_list = std::vector<entry>;
+
+            const_iterator() = default;
+
+            explicit const_iterator(std::shared_ptr<const entry_list> entries)
+                : entries_(std::move(entries)) {}
+
+            reference operator*() const {
+                return *(*entries_)[index_].element;
+            }
+
+            pointer operator->() const { return (*entries_)[index_].element; }
+
+            const_iterator &operator++() {
+                ++index_;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+
+            bool operator==(const const_iterator &rhs) const {
+                const bool lhs_is_end = is_end();
+                const bool rhs_is_end = rhs.is_end();
+                if (lhs_is_end || rhs_is_end) {
+                    return lhs_is_end == rhs_is_end;
+                }
+                return operator->() == rhs.operator->();
+            }
+
+            bool operator!=(const const_iterator &rhs) const {
+                return !(*this == rhs);
+            }
+
+            /// \brief Index of the shard that holds the current element
+            [[nodiscard]] size_t shard() const {
+                return (*entries_)[index_].shard;
+            }
+
+          private:
+            [[nodiscard]] bool is_end() const {
+                return entries_ == nullptr || index_ >= entries_->size();
+            }
+
+            std::shared_ptr<const entry_list> entries_;
+            size_t index_{0};
+        };
+
+        using iterator = const_iterator;
+
+      private /* Internal types */:
+        using merged_list = typename const_iterator::entry_list;
+
+      public /* Constants */:
+        /// \brief Default number of elements for parallel queries
+        static constexpr size_t default_parallel_threshold = 10000;
+
+      public /* Constructors */:
+        /// \brief Create one empty front per hardware thread
+        sharded_front() : sharded_front(default_number_of_threads()) {}
+
+        /// \brief Create n empty shards
+        explicit sharded_front(size_t number_of_shards) {
+            shards_.resize(std::max(number_of_shards, size_t{1}));
+            for (shard_pointer &slot : shards_) {
+                slot = std::make_unique<shard_slot>();
+            }
+        }
+
+        /// \brief Create n empty shards with the same directions
+        sharded_front(size_t number_of_shards,
+                      std::initializer_list<bool> il_dir)
+            : sharded_front(number_of_shards, il_dir.begin(), il_dir.end()) {
+        }
+
+        /// \brief Create n empty shards with the same directions
+        template <class DirectionIt>
+        sharded_front(size_t number_of_shards, DirectionIt first_dir,
+                      DirectionIt last_dir) {
+            shards_.resize(std::max(number_of_shards, size_t{1}));
+            for (shard_pointer &slot : shards_) {
+                slot = std::make_unique<shard_slot>(
+                    shard_slot{front_type({}, first_dir, last_dir)});
+            }
+        }
+
+      public /* Shards */:
+        /// \brief Number of local fronts
+        [[nodiscard]] size_t number_of_shards() const noexcept {
+            return shards_.size();
+        }
+
+        /// \brief Local front owned by a worker
+        /// Workers can use this front as any other front. No two
+        /// workers should use the same shard concurrently. Getting a
+        /// shard to modify drops the cached global view, so a worker
+        /// that keeps the reference between two uses of the global
+        /// view should call invalidate() after modifying the shard.
+        front_type &shard(size_t i) {
+            invalidate();
+            return shards_.at(i)->front_;
+        }
+
+        /// \brief Local front owned by a worker
+        const front_type &shard(size_t i) const {
+            return shards_.at(i)->front_;
+        }
+
+        /// \brief Insert element in the local front of a worker
+        /// Inserting in different shards from different threads needs no
+        /// synchronization.
+        std::pair<typename front_type::iterator, bool>
+        insert(size_t shard_index, const value_type &v) {
+            return shard(shard_index).insert(v);
+        }
+
+        /// \brief Move element to the local front of a worker
+        std::pair<typename front_type::iterator, bool>
+        insert(size_t shard_index, value_type &&v) {
+            return shard(shard_index).insert(std::move(v));
+        }
+
+        /// \brief Number of elements in all local fronts
+        /// This includes the elements dominated by other shards.
+        [[nodiscard]] size_type total_shard_sizes() const noexcept {
+            size_type s = 0;
+            for (const shard_pointer &slot : shards_) {
+                s += slot->front_.size();
+            }
+            return s;
+        }
+
+        /// \brief True if all local fronts are empty
+        [[nodiscard]] bool empty() const noexcept {
+            return std::all_of(
+                shards_.begin(), shards_.end(),
+                [](const shard_pointer &slot) { return slot->front_.empty(); });
+        }
+
+        /// \brief Clear all local fronts
+        void clear() {
+            for (shard_pointer &slot : shards_) {
+                slot->front_.clear();
+            }
+            invalidate();
+        }
+
+        /// \brief Drop the cached global view
+        /// The next call to begin() merges the shards again. Iterators
+        /// to the previous view still point to the elements they
+        /// visited, while these elements are not erased.
+        void invalidate() noexcept {
+            std::atomic_store(&merged_, std::shared_ptr<const merged_list>());
+        }
+
+        /// \brief Place the nodes of a shard on a NUMA node
+        /// The shard is rebuilt with a memory pool bound to the node.
+        /// A worker usually calls bind_shard(i) from its own thread,
+        /// which binds shard i to the socket running the worker.
+        /// \note Pools only exist with BUILD_PARETO_WITH_PMR. Otherwise,
+        /// nodes are placed on the node of the thread that touches
+        /// them first, which is the owner for shards it fills itself.
+        void bind_shard(size_t i, int numa_node = current_numa_node()) {
+            numa_node_guard guard(numa_node);
+            // copy assignment keeps the allocator of the new shard
+            auto bound = std::make_unique<shard_slot>();
+            bound->front_ = shard(i);
+            shards_[i] = std::move(bound);
+            invalidate();
+        }
+
+      public /* Global view */:
+        /// \brief Iterator to the first global element
+        /// This is a P-way merge of the shards sorted in lexicographic
+        /// order. An element can only be dominated by elements that come
+        /// before it in this order, so each element is checked against
+        /// the global elements we have already found, in a front of
+        /// their positions. This costs O(n log n) for n elements in all
+        /// shards, independent of the number of shards. The merge is
+        /// cached, so later calls cost O(1) until a shard changes.
+        const_iterator begin() const {
+            std::shared_ptr<const merged_list> merged =
+                std::atomic_load(&merged_);
+            if (merged == nullptr) {
+                merged = merge_shards();
+                std::atomic_store(&merged_, merged);
+            }
+            return const_iterator(std::move(merged));
+        }
+
+        const_iterator end() const { return const_iterator(); }
+
+        const_iterator cbegin() const { return begin(); }
+
+        const_iterator cend() const { return end(); }
+
+        /// \brief Check if any shard dominates p
+        /// The union of the shards dominates p if one of them does.
+        bool dominates(const point_type &p) const {
+            std::atomic<bool> found{false};
+            parallel_for(
+                number_of_shards(),
+                [&](size_t i) {
+                    if (!found.load(std::memory_order_relaxed) &&
+                        shard(i).dominates(p)) {
+                        found.store(true, std::memory_order_relaxed);
+                    }
+                },
+                query_threads());
+            return found.load();
+        }
+
+        /// \brief Find the global element nearest to p
+        /// Each shard looks for its nearest element not dominated by
+        /// the other shards in parallel. The shards look at their k
+        /// nearest elements and double k until they find one. The
+        /// iterator only visits the nearest element.
+        const_iterator find_nearest(const point_type &p) const {
+            const double no_candidate = std::numeric_limits<double>::max();
+            std::vector<std::pair<double, const value_type *>> candidates(
+                number_of_shards(), {no_candidate, nullptr});
+            parallel_for(
+                number_of_shards(),
+                [&](size_t i) {
+                    const front_type &pf = shard(i);
+                    for (size_t k = 1; k / 2 < pf.size(); k *= 2) {
+                        for (auto it = pf.find_nearest(p, k); it != pf.end();
+                             ++it) {
+                            const double d = p.distance(it->first);
+                            if (d < candidates[i].first &&
+                                !dominated_by_other_shards(it->first, i)) {
+                                candidates[i] = {d, &*it};
+                            }
+                        }
+                        if (candidates[i].second != nullptr) {
+                            break;
+                        }
+                    }
+                },
+                query_threads());
+            auto best = std::min_element(
+                candidates.begin(), candidates.end(),
+                [](const auto &a, const auto &b) { return a.first < b.first; });
+            if (best->second == nullptr) {
+                return end();
+            }
+            const size_t i =
+                static_cast<size_t>(std::distance(candidates.begin(), best));
+            using entry = typename const_iterator::entry;
+            using entry_list = typename const_iterator::entry_list;
+            return const_iterator(std::make_shared<const entry_list>(
+                entry_list{entry{i, best->second}}));
+        }
+
+        /// \brief Merge all shards into the global front
+        /// This is a tree reduction: in each round, pairs of partial
+        /// fronts are merged in parallel, halving the number of
+        /// partial fronts. The shards are not modified.
+        front_type consolidate() const {
+            std::vector<front_type> partial(number_of_shards());
+            const size_t n_threads = query_threads();
+            parallel_for(
+                number_of_shards(), [&](size_t i) { partial[i] = shard(i); },
+                n_threads);
+            for (size_t stride = 1; stride < partial.size(); stride *= 2) {
+                const size_t n_merges =
+                    (partial.size() + 2 * stride - 1) / (2 * stride);
+                parallel_for(
+                    n_merges,
+                    [&](size_t j) {
+                        const size_t target = 2 * stride * j;
+                        const size_t source = target + stride;
+                        if (source < partial.size()) {
+                            partial[target].merge(std::move(partial[source]));
+                        }
+                    },
+                    n_threads);
+            }
+            return std::move(partial[0]);
+        }
+
+      public /* Parallelism */:
+        /// \brief Number of elements from which queries run in parallel
+        [[nodiscard]] size_t parallel_threshold() const noexcept {
+            return parallel_threshold_;
+        }
+
+        /// \brief Set the number of elements from which queries run in
+        /// parallel
+        /// Set it to 0 to always use the workers.
+        void parallel_threshold(size_t n) noexcept { parallel_threshold_ = n; }
+
+        /// \brief Maximum number of threads in parallel queries
+        [[nodiscard]] size_t max_threads() const noexcept {
+            return max_threads_;
+        }
+
+        /// \brief Set the maximum number of threads in parallel queries
+        /// This includes the calling thread and can be larger than the
+        /// number of hardware threads.
+        void max_threads(size_t n) noexcept {
+            max_threads_ = std::max(n, size_t{1});
+        }
+
+      private /* Functions */:
+        /// \brief Number of objectives of the shards
+        [[nodiscard]] size_t dimensions() const {
+            for (const shard_pointer &slot : shards_) {
+                if (!slot->front_.empty()) {
+                    return slot->front_.dimensions();
+                }
+            }
+            return shard(0).dimensions();
+        }
+
+        /// \brief Number of threads for a query on the shards
+        [[nodiscard]] size_t query_threads() const {
+            return total_shard_sizes() < parallel_threshold_ ? 1 : max_threads_;
+        }
+
+        /// \brief Merge the shards into the list of global elements
+        std::shared_ptr<const merged_list> merge_shards() const {
+            using entry = typename const_iterator::entry;
+            using entry_list = typename const_iterator::entry_list;
+            const size_t m = dimensions();
+            std::vector<bool> is_mini(m, true);
+            for (const shard_pointer &slot : shards_) {
+                if (!slot->front_.empty()) {
+                    for (size_t d = 0; d < m; ++d) {
+                        is_mini[d] = slot->front_.is_minimization(d);
+                    }
+                    break;
+                }
+            }
+            auto lexicographic_less = [&](const value_type *a,
+                                          const value_type *b) {
+                for (size_t d = 0; d < m; ++d) {
+                    if (a->first[d] != b->first[d]) {
+                        return is_mini[d] == (a->first[d] < b->first[d]);
+                    }
+                }
+                return false;
+            };
+
+            // sort each shard
+            std::vector<std::vector<const value_type *>> sorted(
+                number_of_shards());
+            parallel_for(
+                number_of_shards(),
+                [&](size_t i) {
+                    sorted[i].reserve(shard(i).size());
+                    for (const value_type &v : shard(i)) {
+                        sorted[i].emplace_back(&v);
+                    }
+                    std::sort(sorted[i].begin(), sorted[i].end(),
+                              lexicographic_less);
+                },
+                query_threads());
+
+            // merge the shards and keep the elements nothing before
+            // them dominates
+            auto entries = std::make_shared<entry_list>();
+            front<K, M, size_t> found({}, is_mini.begin(), is_mini.end());
+            auto heap_greater = [&](const std::pair<size_t, size_t> &a,
+                                    const std::pair<size_t, size_t> &b) {
+                return lexicographic_less(sorted[b.first][b.second],
+                                          sorted[a.first][a.second]);
+            };
+            std::vector<std::pair<size_t, size_t>> heads;
+            for (size_t i = 0; i < sorted.size(); ++i) {
+                if (!sorted[i].empty()) {
+                    heads.emplace_back(i, 0);
+                }
+            }
+            std::make_heap(heads.begin(), heads.end(), heap_greater);
+            while (!heads.empty()) {
+                std::pop_heap(heads.begin(), heads.end(), heap_greater);
+                auto [i, j] = heads.back();
+                const value_type *v = sorted[i][j];
+                if (found.insert(std::make_pair(v->first, entries->size()))
+                        .second) {
+                    entries->emplace_back(entry{i, v});
+                }
+                if (j + 1 < sorted[i].size()) {
+                    heads.back().second = j + 1;
+                    std::push_heap(heads.begin(), heads.end(), heap_greater);
+                } else {
+                    heads.pop_back();
+                }
+            }
+            return entries;
+        }
+
+        /// \brief True if any shard other than `except` dominates p
+        bool dominated_by_other_shards(const point_type &p,
+                                       size_t except) const {
+            for (size_t j = 0; j < number_of_shards(); ++j) {
+                if (j != except && shard(j).dominates(p)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+      private /* Members */:
+        std::vector<shard_pointer> shards_;
+
+        /// \brief Cached global elements, or null if a shard changed
+        mutable std::shared_ptr<const merged_list> merged_;
+
+        size_t parallel_threshold_{default_parallel_threshold};
+        size_t max_threads_{default_number_of_threads()};
+    };
+} // namespace pareto
+
+#endif // PARETO_SHARDED_FRONT_H
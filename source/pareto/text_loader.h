@@ -0,0 +1,334 @@
+#ifndef PARETO_TEXT_LOADER_H
+#define PARETO_TEXT_LOADER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <pareto/archive.h>
+#include <pareto/common/parallel.h>
+#include <pareto/front.h>
+#include <pareto/point.h>
+
+/// Loader for text files with one point per line
+/// This is the format of reference fronts for the ZDT, DTLZ and WFG
+/// problems (".pf" files) and of the CSV files most tools export:
+/// - numbers are separated by spaces, tabs, commas or semicolons
+/// - lines starting with '#' or '%' are comments
+/// - the first line is a header and is skipped if it is not a number
+/// The file is split into chunks at line boundaries and the chunks
+/// are parsed in parallel with std::from_chars.
+namespace pareto {
+    /// \brief Options for loading text files
+    struct text_loader_options {
+        /// \brief Whether the points might dominate each other
+        /// Set this to false if the file is known to be a front, such
+        /// as a reference front, to skip the dominance filter.
+        bool filter_dominated{true};
+
+        /// \brief Maximum number of parsing threads, including the caller
+        size_t number_of_threads{default_number_of_threads()};
+
+        /// \brief Minimum number of bytes parsed by each thread
+        /// Small files are not worth the cost of the threads.
+        size_t min_chunk_size{size_t{1} << 20};
+    };
+
+    namespace detail {
+        inline bool is_text_separator(char c) {
+            return c == ' ' || c == '\t' || c == ',' || c == ';' ||
+                   c == '\r';
+        }
+
+        inline bool is_text_comment(char c) { return c == '#' || c == '%'; }
+
+        /// \brief Parse a number with from_chars
+        /// from_chars does not accept a leading '+', which some tools
+        /// write in scientific notation files.
+        /// \return Pointer past the number or nullptr if there is none
+        template <class K>
+        const char *parse_text_number(const char *first, const char *last,
+                                      K &value) {
+            if (first != last && *first == '+') {
+                ++first;
+            }
+#if !defined(__cpp_lib_to_chars)
+            // no floating point from_chars: fall back to strtod
+            // the buffer is null terminated, so strtod stops at its end
+            if constexpr (std::is_floating_point_v<K>) {
+                char *end = nullptr;
+                const long double v = std::strtold(first, &end);
+                if (end == first || end > last) {
+                    return nullptr;
+                }
+                value = static_cast<K>(v);
+                return end;
+            } else
+#endif
+            {
+                auto [ptr, ec] = std::from_chars(first, last, value);
+                if (ec != std::errc()) {
+                    return nullptr;
+                }
+                return ptr;
+            }
+        }
+
+        /// \brief Points parsed from a chunk of the text
+        template <class K> struct text_chunk {
+            /// Coordinates of all points, row by row
+            std::vector<K> coordinates;
+            /// Offset of the first line with an error, if any
+            size_t error_offset{std::string_view::npos};
+            /// Description of the error
+            const char *error{nullptr};
+        };
+
+        /// \brief Parse the lines in [first, last) of text
+        /// \param dimensions Number of numbers we expect in each line
+        template <class K>
+        void parse_text_chunk(std::string_view text, size_t first,
+                              size_t last, size_t dimensions,
+                              text_chunk<K> &out) {
+            const char *begin = text.data();
+            const char *it = begin + first;
+            const char *end = begin + last;
+            while (it != end) {
+                const char *line_begin = it;
+                const char *line_end = std::find(it, end, '\n');
+                while (it != line_end && is_text_separator(*it)) {
+                    ++it;
+                }
+                if (it == line_end || is_text_comment(*it)) {
+                    it = line_end == end ? end : line_end + 1;
+                    continue;
+                }
+                size_t n = 0;
+                while (it != line_end) {
+                    K value;
+                    const char *next = parse_text_number(it, line_end, value);
+                    if (next == nullptr) {
+                        out.error_offset = line_begin - begin;
+                        out.error = "invalid number";
+                        return;
+                    }
+                    out.coordinates.emplace_back(value);
+                    ++n;
+                    it = next;
+                    while (it != line_end && is_text_separator(*it)) {
+                        ++it;
+                    }
+                }
+                if (n != dimensions) {
+                    out.error_offset = line_begin - begin;
+                    out.error = "wrong number of values";
+                    return;
+                }
+                it = line_end == end ? end : line_end + 1;
+            }
+        }
+
+        /// \brief Skip comments and the header at the start of the text
+        /// \return Offset of the first line with numbers
+        inline size_t skip_text_preamble(std::string_view text) {
+            size_t pos = 0;
+            bool header_skipped = false;
+            while (pos < text.size()) {
+                size_t line_end = text.find('\n', pos);
+                if (line_end == std::string_view::npos) {
+                    line_end = text.size();
+                }
+                size_t first = pos;
+                while (first < line_end && is_text_separator(text[first])) {
+                    ++first;
+                }
+                const bool is_blank = first == line_end;
+                const bool is_comment =
+                    !is_blank && is_text_comment(text[first]);
+                if (!is_blank && !is_comment) {
+                    double ignored;
+                    const char *p = parse_text_number(
+                        text.data() + first, text.data() + line_end, ignored);
+                    if (p != nullptr || header_skipped) {
+                        return pos;
+                    }
+                    header_skipped = true;
+                }
+                pos = line_end + 1;
+            }
+            return text.size();
+        }
+
+        /// \brief Count the numbers in the first line of the text
+        inline size_t count_text_columns(std::string_view text) {
+            const char *it = text.data();
+            const char *end = it + text.size();
+            end = std::find(it, end, '\n');
+            size_t n = 0;
+            while (it != end) {
+                while (it != end && is_text_separator(*it)) {
+                    ++it;
+                }
+                if (it == end) {
+                    break;
+                }
+                double ignored;
+                const char *next = parse_text_number(it, end, ignored);
+                if (next == nullptr) {
+                    break;
+                }
+                ++n;
+                it = next;
+            }
+            return n;
+        }
+    } // namespace detail
+
+    /// \brief Parse the points in a text buffer
+    /// The mapped value of each point is its row index, if T is a number,
+    /// or a default constructed T otherwise.
+    /// \tparam K Number type
+    /// \tparam M Number of dimensions. If M is 0, the number of
+    ///         dimensions is the number of values in the first line.
+    /// \tparam T Mapped type
+    /// \param text Text with one point per line
+    /// \param options Number of threads and chunk size
+    /// \throw std::invalid_argument If a line is not a point
+    /// \return Values that can be passed to container and front constructors
+    template <class K, size_t M, class T = size_t>
+    std::vector<std::pair<point<K, M>, T>>
+    parse_text_points(std::string_view text,
+                      const text_loader_options &options = {}) {
+        const size_t start = detail::skip_text_preamble(text);
+        const size_t dimensions =
+            M != 0 ? M : detail::count_text_columns(text.substr(start));
+        std::vector<std::pair<point<K, M>, T>> values;
+        if (start == text.size()) {
+            return values;
+        }
+
+        // split the text into chunks at line boundaries
+        const size_t bytes = text.size() - start;
+        const size_t n_chunks = std::max(
+            std::min(options.number_of_threads,
+                     bytes / std::max(options.min_chunk_size, size_t{1})),
+            size_t{1});
+        std::vector<size_t> bounds(n_chunks + 1, text.size());
+        bounds[0] = start;
+        for (size_t i = 1; i < n_chunks; ++i) {
+            const size_t target =
+                std::max(start + i * bytes / n_chunks, bounds[i - 1]);
+            const size_t line_end = text.find('\n', target);
+            bounds[i] =
+                line_end == std::string_view::npos ? text.size() : line_end + 1;
+        }
+
+        std::vector<detail::text_chunk<K>> chunks(n_chunks);
+        parallel_for(
+            n_chunks,
+            [&](size_t i) {
+                detail::parse_text_chunk<K>(text, bounds[i], bounds[i + 1],
+                                               dimensions, chunks[i]);
+            },
+            options.number_of_threads);
+
+        // report the first error with its line number
+        for (const auto &chunk : chunks) {
+            if (chunk.error != nullptr) {
+                const auto line = std::count(
+                    text.begin(),
+                    text.begin() + static_cast<std::ptrdiff_t>(
+                                       chunk.error_offset),
+                    '\n');
+                throw std::invalid_argument(
+                    "parse_text_points: " + std::string(chunk.error) +
+                    " in line " + std::to_string(line + 1));
+            }
+        }
+
+        // copy the chunks to their rows in parallel
+        std::vector<size_t> first_row(n_chunks + 1, 0);
+        for (size_t i = 0; i < n_chunks; ++i) {
+            first_row[i + 1] =
+                first_row[i] + chunks[i].coordinates.size() / dimensions;
+        }
+        values.resize(first_row.back(),
+                      std::make_pair(point<K, M>(dimensions), T{}));
+        parallel_for(
+            n_chunks,
+            [&](size_t i) {
+                auto it = chunks[i].coordinates.begin();
+                for (size_t row = first_row[i]; row < first_row[i + 1];
+                     ++row) {
+                    auto &[p, v] = values[row];
+                    std::copy(it, it + static_cast<std::ptrdiff_t>(dimensions),
+                              p.begin());
+                    it += static_cast<std::ptrdiff_t>(dimensions);
+                    if constexpr (std::is_arithmetic_v<T>) {
+                        v = static_cast<T>(row);
+                    }
+                }
+            },
+            options.number_of_threads);
+        return values;
+    }
+
+    /// \brief Read the whole content of a file
+    /// \throw std::runtime_error If the file cannot be read
+    inline std::string read_text_file(const std::filesystem::path &path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("read_text_file: cannot open " +
+                                     path.string());
+        }
+        file.seekg(0, std::ios::end);
+        const auto size = file.tellg();
+        file.seekg(0, std::ios::beg);
+        std::string text(static_cast<size_t>(size), '\0');
+        if (!file.read(text.data(), size)) {
+            throw std::runtime_error("read_text_file: cannot read " +
+                                     path.string());
+        }
+        return text;
+    }
+
+    /// \brief Parse the points in a text file
+    /// \see parse_text_points
+    template <class K, size_t M, class T = size_t>
+    std::vector<std::pair<point<K, M>, T>>
+    read_text_points(const std::filesystem::path &path,
+                     const text_loader_options &options = {}) {
+        return parse_text_points<K, M, T>(read_text_file(path), options);
+    }
+
+    /// \brief Load the points in a text file into a front
+    /// The points go through the bulk loader of the front container.
+    /// \return Number of points inserted in the front
+    template <class K, size_t M, class T, class C>
+    size_t load_text(front<K, M, T, C> &pf, const std::filesystem::path &path,
+                     const text_loader_options &options = {}) {
+        auto values = read_text_points<K, M, T>(path, options);
+        return pf.bulk_insert(values.begin(), values.end(),
+                              options.filter_dominated);
+    }
+
+    /// \brief Load the points in a text file into an archive
+    /// \return Number of points inserted in the archive
+    template <class K, size_t M, class T, class C>
+    size_t load_text(archive<K, M, T, C> &ar,
+                     const std::filesystem::path &path,
+                     const text_loader_options &options = {}) {
+        auto values = read_text_points<K, M, T>(path, options);
+        return ar.insert(values.begin(), values.end());
+    }
+} // namespace pareto
+
+#endif // PARETO_TEXT_LOADER_H
@@ -0,0 +1,120 @@
+#ifndef PARETO_TRANSACTION_H
+#define PARETO_TRANSACTION_H
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace pareto {
+    /// \class Transaction on a front or archive
+    /// A transaction applies modifications to a front or archive and
+    /// keeps an undo log, so that we can evaluate what-if scenarios
+    /// without copying the container.
+    ///
+    /// Each operation records the key it inserted and the elements it
+    /// removed (dominated elements in a front, pruned elements in an
+    /// archive). rollback() undoes the operations in reverse order, so
+    /// it takes time proportional to the number of elements changed
+    /// rather than to the size of the container.
+    ///
+    /// Pending operations are rolled back when the transaction is
+    /// destroyed, unless they have been committed. Reinserting the
+    /// removed elements allocates, and destructors cannot throw, so the
+    /// operations the destructor fails to undo stay applied. Call
+    /// rollback() explicitly to handle these errors.
+    ///
+    /// \warning The container must not be modified by anything other
+    /// than the transaction while it has pending operations.
+    template <class Adapter> class transaction {
+      public:
+        using adapter_type = Adapter;
+        using value_type = typename Adapter::value_type;
+        using key_type = typename Adapter::key_type;
+        using size_type = typename Adapter::size_type;
+
+      public /* Constructors */:
+        explicit transaction(Adapter &target) : target_(&target) {}
+
+        transaction(const transaction &) = delete;
+
+        transaction(transaction &&rhs) noexcept
+            : target_(std::exchange(rhs.target_, nullptr)),
+              log_(std::move(rhs.log_)) {}
+
+        transaction &operator=(const transaction &) = delete;
+
+        transaction &operator=(transaction &&) = delete;
+
+        ~transaction() {
+            if (target_ != nullptr) {
+                try {
+                    rollback();
+                } catch (...) {
+                    // keep the operations we could not undo
+                }
+            }
+        }
+
+      public /* Modifiers */:
+        /// \brief Insert element and log the elements it removes
+        /// \return True if the element was inserted
+        bool insert(const value_type &v) {
+            entry e;
+            e.key = v.first;
+            const bool inserted = target_->insert_and_log(v, e.removed);
+            if (inserted || !e.removed.empty()) {
+                log_.emplace_back(std::move(e));
+            }
+            return inserted;
+        }
+
+        /// \brief Erase element and log the elements it removes
+        /// \return Number of elements erased
+        size_type erase(const key_type &k) {
+            entry e;
+            const size_type n = target_->erase_and_log(k, e.removed);
+            if (n != 0) {
+                log_.emplace_back(std::move(e));
+            }
+            return n;
+        }
+
+      public /* Transaction */:
+        /// \brief Keep all pending operations
+        void commit() noexcept { log_.clear(); }
+
+        /// \brief Undo all pending operations
+        /// If an undo throws, the operations it did not reach stay in
+        /// the log.
+        void rollback() {
+            while (!log_.empty()) {
+                entry &e = log_.back();
+                target_->undo(e.key, e.removed);
+                log_.pop_back();
+            }
+        }
+
+        /// \brief Number of pending operations
+        [[nodiscard]] size_t size() const noexcept { return log_.size(); }
+
+        /// \brief True if there are no pending operations
+        [[nodiscard]] bool empty() const noexcept { return log_.empty(); }
+
+      private:
+        /// \brief Undo information of one operation
+        struct entry {
+            /// Key to erase (all elements with this key are erased)
+            std::optional<key_type> key;
+            /// Elements to reinsert after erasing the key
+            std::vector<value_type> removed;
+        };
+
+        /// \brief Container we are modifying
+        Adapter *target_;
+
+        /// \brief Undo log
+        std::vector<entry> log_;
+    };
+} // namespace pareto
+
+#endif // PARETO_TRANSACTION_H
@@ -0,0 +1,331 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <pareto/archive.h>
+#include <pareto/implicit_tree.h>
+#include <pareto/kd_tree.h>
+#include <pareto/quad_tree.h>
+#include <pareto/r_star_tree.h>
+#include <pareto/r_tree.h>
+#include "../test_helpers.h"
+#include "../workloads.h"
+
+/*
+ * These benchmarks measure archives whose elements are spread over
+ * a fixed number of fronts. Front k is the concave front shifted by
+ * k * layer_gap in all objectives, so every element of front k is
+ * dominated by its copy in front k - 1.
+ *
+ * All random points are generated before the timed loops. Queries and
+ * read-only operations reuse the same archive. Insertions, erasures
+ * and pruning change the archive in batches and undo the changes
+ * after each batch. These benchmarks use manual timing, so only the
+ * batch is measured and the clock is read twice per batch rather
+ * than paused on every element. The at-capacity insertions are
+ * measured in a steady state.
+ */
+
+constexpr size_t dimensions = 3;
+constexpr size_t number_of_layers = 10;
+constexpr double layer_gap = 0.1;
+
+template <class Container>
+using archive_t = pareto::archive<double, dimensions, unsigned, Container>;
+
+/// \brief Base points of the first front
+template <class Container>
+const std::vector<typename archive_t<Container>::value_type> &
+base_values(size_t n) {
+    using archive_type = archive_t<Container>;
+    static std::map<size_t, std::vector<typename archive_type::value_type>>
+        cache;
+    static std::mutex working_with_cache;
+    std::lock_guard lock(working_with_cache);
+    auto it = cache.find(n);
+    if (it == cache.end()) {
+        auto pf = create_shaped_front<dimensions, Container>(
+            front_shape::concave, n);
+        it = cache.emplace(n, std::vector<typename archive_type::value_type>(
+                                  pf.begin(), pf.end()))
+                 .first;
+    }
+    return it->second;
+}
+
+/// \brief n values spread over number_of_layers fronts
+template <class Container>
+std::vector<typename archive_t<Container>::value_type>
+layered_values(size_t n) {
+    const auto &base = base_values<Container>(n / number_of_layers);
+    std::vector<typename archive_t<Container>::value_type> v;
+    v.reserve(base.size() * number_of_layers);
+    for (size_t layer = 0; layer < number_of_layers; ++layer) {
+        for (const auto &[k, m] : base) {
+            v.emplace_back(k + layer_gap * static_cast<double>(layer), m);
+        }
+    }
+    return v;
+}
+
+/// \brief An archive with capacity elements in number_of_layers fronts
+template <class Container>
+const archive_t<Container> &get_archive_from_cache(size_t capacity) {
+    static std::map<size_t, archive_t<Container>> cache;
+    static std::mutex working_with_cache;
+    std::lock_guard lock(working_with_cache);
+    auto it = cache.find(capacity);
+    if (it == cache.end()) {
+        auto v = layered_values<Container>(capacity);
+        it = cache
+                 .emplace(capacity, archive_t<Container>(capacity, v.begin(),
+                                                         v.end()))
+                 .first;
+    }
+    return it->second;
+}
+
+/// \brief Number of elements changed in each timed batch
+constexpr size_t batch_size = 64;
+
+/// \brief Number of query points generated for each benchmark
+constexpr size_t number_of_queries = 1024;
+
+/// \brief n points that belong to a given front of the archive
+template <class Container>
+std::vector<typename archive_t<Container>::key_type>
+points_at_depth(size_t depth, size_t n) {
+    using key_type = typename archive_t<Container>::key_type;
+    std::vector<key_type> v;
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto p = shaped_point<key_type>(front_shape::concave, dimensions,
+                                        workload_generator());
+        v.emplace_back(p + layer_gap * static_cast<double>(depth));
+    }
+    return v;
+}
+
+/// \brief Seconds since a given time point
+inline double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+
+/// \brief Construct an archive
+/// range(0) is the capacity
+template <class Container> struct construct {
+    void operator()(benchmark::State &state) const {
+        const auto capacity = static_cast<size_t>(state.range(0));
+        auto v = layered_values<Container>(capacity);
+        for (auto _ : state) {
+            archive_t<Container> ar(capacity, v.begin(), v.end());
+            benchmark::DoNotOptimize(ar.size());
+        }
+        state.SetItemsProcessed(state.iterations() * v.size());
+    }
+};
+
+/// \brief Insert elements that belong to a given front
+/// range(0) is the capacity and range(1) is the front depth.
+/// The archive has room for the elements, so the only costs are
+/// finding the fronts and pushing down the elements they dominate.
+/// Each iteration inserts a batch and erases it untimed.
+template <class Container> struct insert {
+    void operator()(benchmark::State &state) const {
+        const auto capacity = static_cast<size_t>(state.range(0));
+        const auto depth = static_cast<size_t>(state.range(1));
+        auto ar = get_archive_from_cache<Container>(capacity);
+        ar.resize(capacity * 2);
+        const auto points = points_at_depth<Container>(depth, batch_size);
+        for (auto _ : state) {
+            const auto start = std::chrono::steady_clock::now();
+            for (const auto &p : points) {
+                benchmark::DoNotOptimize(ar.insert({p, 0}));
+            }
+            state.SetIterationTime(seconds_since(start));
+            for (const auto &p : points) {
+                ar.erase(p);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * points.size());
+        state.counters["fronts"] = static_cast<double>(ar.size_fronts());
+    }
+};
+
+/// \brief Insert in an archive at capacity
+/// range(0) is the capacity. Every insertion prunes the most
+/// crowded element of the last front.
+template <class Container> struct insert_at_capacity {
+    void operator()(benchmark::State &state) const {
+        const auto capacity = static_cast<size_t>(state.range(0));
+        auto ar = get_archive_from_cache<Container>(capacity);
+        const auto points = points_at_depth<Container>(0, number_of_queries);
+        size_t i = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(
+                ar.insert({points[i++ % points.size()], 0}));
+        }
+        state.counters["fronts"] = static_cast<double>(ar.size_fronts());
+    }
+};
+
+/// \brief Erase elements from a given front
+/// range(0) is the capacity and range(1) is the front depth.
+/// Erasing from the first fronts promotes elements from the others.
+/// Each iteration erases a batch and reinserts it untimed.
+template <class Container> struct erase {
+    void operator()(benchmark::State &state) const {
+        const auto capacity = static_cast<size_t>(state.range(0));
+        const auto depth = static_cast<size_t>(state.range(1));
+        auto ar = get_archive_from_cache<Container>(capacity);
+        const auto &base = base_values<Container>(capacity / number_of_layers);
+        std::vector<typename archive_t<Container>::value_type> batch;
+        const size_t n = std::min(batch_size, base.size());
+        for (size_t i = 0; i < n; ++i) {
+            const auto &[k, m] = base[i * base.size() / n];
+            batch.emplace_back(k + layer_gap * static_cast<double>(depth), m);
+        }
+        for (auto _ : state) {
+            const auto start = std::chrono::steady_clock::now();
+            for (const auto &v : batch) {
+                benchmark::DoNotOptimize(ar.erase(v.first));
+            }
+            state.SetIterationTime(seconds_since(start));
+            for (const auto &v : batch) {
+                ar.insert(v);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * batch.size());
+    }
+};
+
+/// \brief Shrink the archive by most of its last front
+/// range(0) is the capacity. Removing more elements than the
+/// crowding-based pruning handles also removes random elements.
+/// Each iteration prunes a fresh copy of the archive.
+template <class Container> struct prune {
+    void operator()(benchmark::State &state) const {
+        const auto capacity = static_cast<size_t>(state.range(0));
+        const auto &cached = get_archive_from_cache<Container>(capacity);
+        const size_t last_front_size = capacity / number_of_layers;
+        const size_t excess = last_front_size - last_front_size / 8;
+        for (auto _ : state) {
+            auto ar = cached;
+            const auto start = std::chrono::steady_clock::now();
+            ar.resize(capacity - excess);
+            state.SetIterationTime(seconds_since(start));
+            benchmark::DoNotOptimize(ar.size());
+        }
+        state.SetItemsProcessed(state.iterations() * excess);
+    }
+};
+
+/// \brief Find the k nearest elements across all fronts
+/// range(0) is the capacity
+template <class Container> struct query_nearest {
+    void operator()(benchmark::State &state) const {
+        const auto capacity = static_cast<size_t>(state.range(0));
+        const auto &ar = get_archive_from_cache<Container>(capacity);
+        const auto points =
+            points_at_depth<Container>(number_of_layers / 2, number_of_queries);
+        size_t i = 0;
+        for (auto _ : state) {
+            auto it = ar.find_nearest(points[i++ % points.size()], 10);
+            benchmark::DoNotOptimize(it != ar.end());
+        }
+    }
+};
+
+/// \brief Iterate all elements in all fronts
+/// range(0) is the capacity
+template <class Container> struct iterate {
+    void operator()(benchmark::State &state) const {
+        const auto capacity = static_cast<size_t>(state.range(0));
+        const auto &ar = get_archive_from_cache<Container>(capacity);
+        for (auto _ : state) {
+            unsigned sum = 0;
+            for (const auto &[k, v] : ar) {
+                sum += v;
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * ar.size());
+    }
+};
+
+/// \brief Hypervolume and IGD of the first front
+/// range(0) is the capacity
+template <class Container> struct indicators {
+    void operator()(benchmark::State &state) const {
+        const auto capacity = static_cast<size_t>(state.range(0));
+        const auto &ar = get_archive_from_cache<Container>(capacity);
+        auto reference = create_shaped_front<dimensions, Container>(
+            front_shape::concave, 100, dimensions, 42);
+        auto nadir = ar.nadir();
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(ar.hypervolume(1000, nadir));
+            benchmark::DoNotOptimize(ar.igd(reference));
+        }
+    }
+};
+
+/// Factors for benchmarks
+void capacities(benchmark::internal::Benchmark *b) {
+    for (long long capacity : {100, 1000, 10000}) {
+        b->Args({capacity});
+    }
+}
+
+void capacities_and_depths(benchmark::internal::Benchmark *b) {
+    for (long long capacity : {100, 1000, 10000}) {
+        for (long long depth :
+             {0LL, static_cast<long long>(number_of_layers / 2),
+              static_cast<long long>(number_of_layers - 1)}) {
+            b->Args({capacity, depth});
+        }
+    }
+}
+
+template <class F, class S>
+void register_bench(const std::string &name, F functor, S s,
+                    bool manual_time) {
+    auto b = benchmark::RegisterBenchmark(name.c_str(), functor)->Apply(s);
+    if (manual_time) {
+        b->UseManualTime();
+    }
+}
+
+template <template <class> class F, class S>
+void register_all_containers(const std::string &name, S state_values,
+                             bool manual_time = false) {
+    register_bench(name + "<implicit_tree>",
+                   F<pareto::implicit_tree<double, dimensions, unsigned>>(),
+                   state_values, manual_time);
+    register_bench(name + "<quad_tree>",
+                   F<pareto::quad_tree<double, dimensions, unsigned>>(),
+                   state_values, manual_time);
+    register_bench(name + "<kd_tree>",
+                   F<pareto::kd_tree<double, dimensions, unsigned>>(),
+                   state_values, manual_time);
+    register_bench(name + "<r_tree>",
+                   F<pareto::r_tree<double, dimensions, unsigned>>(),
+                   state_values, manual_time);
+    register_bench(name + "<r_star_tree>",
+                   F<pareto::r_star_tree<double, dimensions, unsigned>>(),
+                   state_values, manual_time);
+}
+
+int main(int argc, char **argv) {
+    register_all_containers<construct>("construct", capacities);
+    register_all_containers<insert>("insert", capacities_and_depths, true);
+    register_all_containers<insert_at_capacity>("insert_at_capacity",
+                                                capacities);
+    register_all_containers<erase>("erase", capacities_and_depths, true);
+    register_all_containers<prune>("prune", capacities, true);
+    register_all_containers<query_nearest>("query_nearest", capacities);
+    register_all_containers<iterate>("iterate", capacities);
+    register_all_containers<indicators>("indicators", capacities);
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+}
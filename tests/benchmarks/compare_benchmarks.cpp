@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <regex>
+#include <string>
+#include <vector>
+
+/*
+ * Compare two sets of Google Benchmark results
+ *
+ * Usage:
+ *     ./compare_benchmarks baseline.json contender.json
+ *                          --threshold=0.05 --alpha=0.05
+ *                          --metric=real_time --filter=<regex>
+ *                          --out=report.json
+ *
+ * Both files should come from runs with --benchmark_repetitions and
+ * --benchmark_out_format=json. For each benchmark in both files, we
+ * compare the median times of the repetitions and test whether the
+ * two samples come from the same distribution with a Mann-Whitney U
+ * test, which, unlike a t-test, does not assume the times are
+ * normally distributed.
+ *
+ * A benchmark regresses if its median is more than threshold slower
+ * and the difference is significant (p < alpha). Without enough
+ * repetitions to test significance, only the threshold is used.
+ * If the files only have aggregates (--benchmark_report_aggregates_only),
+ * we compare the means with a Welch t-test instead.
+ *
+ * The tool prints a table of deltas, writes a JSON report with --out,
+ * and returns 1 if any benchmark regressed, so it can gate a build.
+ */
+
+using json = nlohmann::json;
+
+/// \brief Options of the comparison
+struct compare_options {
+    std::string baseline;
+    std::string contender;
+    double threshold = 0.05;
+    double alpha = 0.05;
+    std::string metric = "real_time";
+    std::string filter = ".*";
+    std::string report;
+};
+
+/// \brief Times of a benchmark in one result set
+struct benchmark_samples {
+    /// Times of each repetition (ns)
+    std::vector<double> times;
+    /// Aggregates reported by the benchmark library (ns)
+    std::optional<double> mean;
+    std::optional<double> stddev;
+    size_t repetitions = 0;
+};
+
+/// \brief Result of the comparison of one benchmark
+struct benchmark_delta {
+    std::string name;
+    std::string status;
+    double baseline = 0.;
+    double contender = 0.;
+    double delta = 0.;
+    std::optional<double> p_value;
+};
+
+/// \brief Factor to convert a time unit to nanoseconds
+double to_nanoseconds(const std::string &unit) {
+    if (unit == "us") {
+        return 1e3;
+    }
+    if (unit == "ms") {
+        return 1e6;
+    }
+    if (unit == "s") {
+        return 1e9;
+    }
+    return 1.;
+}
+
+/// \brief Read the samples of each benchmark in a result file
+std::map<std::string, benchmark_samples>
+read_results(const std::string &filename, const compare_options &o) {
+    std::ifstream fin(filename);
+    if (!fin) {
+        throw std::runtime_error("Cannot open file " + filename);
+    }
+    json results;
+    fin >> results;
+    const std::regex filter(o.filter);
+    std::map<std::string, benchmark_samples> samples;
+    for (const auto &b : results.at("benchmarks")) {
+        if (b.contains("error_occurred") && b["error_occurred"].get<bool>()) {
+            continue;
+        }
+        const std::string run_name = b.contains("run_name")
+                                         ? b["run_name"].get<std::string>()
+                                         : b["name"].get<std::string>();
+        if (!std::regex_search(run_name, filter)) {
+            continue;
+        }
+        const double t =
+            b.at(o.metric).get<double>() *
+            to_nanoseconds(b.value("time_unit", std::string("ns")));
+        benchmark_samples &s = samples[run_name];
+        s.repetitions = std::max(
+            s.repetitions, b.value("repetitions", size_t{1}));
+        const std::string run_type = b.value("run_type", std::string("iteration"));
+        if (run_type == "iteration") {
+            s.times.emplace_back(t);
+        } else {
+            const std::string aggregate =
+                b.value("aggregate_name", std::string());
+            if (aggregate == "mean") {
+                s.mean = t;
+            } else if (aggregate == "stddev") {
+                s.stddev = t;
+            }
+        }
+    }
+    return samples;
+}
+
+double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    const size_t n = v.size();
+    return n % 2 == 1 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.;
+}
+
+/// \brief Two-sided p-value of a standard normal statistic
+double normal_p_value(double z) { return std::erfc(std::abs(z) / std::sqrt(2.)); }
+
+/// \brief Two-sided Mann-Whitney U test with the normal approximation
+/// The approximation is good enough from about 5 samples per set,
+/// and we do not test smaller sets.
+std::optional<double> mann_whitney_p_value(const std::vector<double> &a,
+                                           const std::vector<double> &b) {
+    constexpr size_t min_samples = 5;
+    if (a.size() < min_samples || b.size() < min_samples) {
+        return std::nullopt;
+    }
+    // rank all values, with the average rank for ties
+    std::vector<std::pair<double, size_t>> all;
+    for (double x : a) {
+        all.emplace_back(x, 0);
+    }
+    for (double x : b) {
+        all.emplace_back(x, 1);
+    }
+    std::sort(all.begin(), all.end());
+    const auto n = static_cast<double>(all.size());
+    double rank_sum_a = 0.;
+    double tie_correction = 0.;
+    for (size_t i = 0; i < all.size();) {
+        size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) {
+            ++j;
+        }
+        const double average_rank = (static_cast<double>(i + j) + 1.) / 2.;
+        const auto ties = static_cast<double>(j - i);
+        tie_correction += ties * ties * ties - ties;
+        for (size_t k = i; k < j; ++k) {
+            if (all[k].second == 0) {
+                rank_sum_a += average_rank;
+            }
+        }
+        i = j;
+    }
+    const auto na = static_cast<double>(a.size());
+    const auto nb = static_cast<double>(b.size());
+    const double u = rank_sum_a - na * (na + 1.) / 2.;
+    const double mean_u = na * nb / 2.;
+    const double var_u =
+        na * nb / 12. * ((n + 1.) - tie_correction / (n * (n - 1.)));
+    if (var_u <= 0.) {
+        return 1.;
+    }
+    // continuity correction
+    const double diff = std::abs(u - mean_u) - 0.5;
+    return normal_p_value(std::max(diff, 0.) / std::sqrt(var_u));
+}
+
+/// \brief Two-sided Welch t-test from aggregates
+/// We use the normal approximation of the t distribution, which
+/// slightly underestimates p for few repetitions.
+std::optional<double> welch_p_value(const benchmark_samples &a,
+                                    const benchmark_samples &b) {
+    if (!a.mean || !a.stddev || !b.mean || !b.stddev || a.repetitions < 2 ||
+        b.repetitions < 2) {
+        return std::nullopt;
+    }
+    const double va = *a.stddev * *a.stddev / static_cast<double>(a.repetitions);
+    const double vb = *b.stddev * *b.stddev / static_cast<double>(b.repetitions);
+    if (va + vb <= 0.) {
+        return *a.mean == *b.mean ? 1. : 0.;
+    }
+    return normal_p_value((*b.mean - *a.mean) / std::sqrt(va + vb));
+}
+
+/// \brief Compare the baseline and contender samples of a benchmark
+benchmark_delta compare(const std::string &name, const benchmark_samples &a,
+                        const benchmark_samples &b, const compare_options &o) {
+    benchmark_delta d;
+    d.name = name;
+    if (!a.times.empty() && !b.times.empty()) {
+        d.baseline = median(a.times);
+        d.contender = median(b.times);
+        d.p_value = mann_whitney_p_value(a.times, b.times);
+    } else {
+        d.baseline = a.mean.value_or(0.);
+        d.contender = b.mean.value_or(0.);
+        d.p_value = welch_p_value(a, b);
+    }
+    d.delta = d.baseline > 0. ? (d.contender - d.baseline) / d.baseline : 0.;
+    const bool significant = !d.p_value || *d.p_value < o.alpha;
+    if (d.delta > o.threshold && significant) {
+        d.status = "regression";
+    } else if (d.delta < -o.threshold && significant) {
+        d.status = "improvement";
+    } else {
+        d.status = "unchanged";
+    }
+    return d;
+}
+
+compare_options parse_options(int argc, char **argv) {
+    compare_options o;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0) {
+            files.emplace_back(arg);
+            continue;
+        }
+        if (eq == std::string::npos) {
+            throw std::invalid_argument("Expected --option=value: " + arg);
+        }
+        const std::string key = arg.substr(2, eq - 2);
+        const std::string value = arg.substr(eq + 1);
+        if (key == "threshold") {
+            o.threshold = std::stod(value);
+        } else if (key == "alpha") {
+            o.alpha = std::stod(value);
+        } else if (key == "metric") {
+            o.metric = value;
+        } else if (key == "filter") {
+            o.filter = value;
+        } else if (key == "out") {
+            o.report = value;
+        } else {
+            throw std::invalid_argument("Unknown option: " + key);
+        }
+    }
+    if (files.size() != 2) {
+        throw std::invalid_argument(
+            "Usage: compare_benchmarks baseline.json contender.json "
+            "[--threshold=0.05] [--alpha=0.05] [--metric=real_time] "
+            "[--filter=regex] [--out=report.json]");
+    }
+    o.baseline = files[0];
+    o.contender = files[1];
+    return o;
+}
+
+int main(int argc, char **argv) {
+    try {
+        const compare_options o = parse_options(argc, argv);
+        const auto baseline = read_results(o.baseline, o);
+        const auto contender = read_results(o.contender, o);
+
+        std::vector<benchmark_delta> deltas;
+        for (const auto &[name, a] : baseline) {
+            auto it = contender.find(name);
+            if (it == contender.end()) {
+                benchmark_delta d;
+                d.name = name;
+                d.status = "missing";
+                deltas.emplace_back(d);
+            } else {
+                deltas.emplace_back(compare(name, a, it->second, o));
+            }
+        }
+        for (const auto &[name, b] : contender) {
+            if (baseline.find(name) == baseline.end()) {
+                benchmark_delta d;
+                d.name = name;
+                d.status = "new";
+                deltas.emplace_back(d);
+            }
+        }
+
+        size_t regressions = 0;
+        std::cout << std::left << std::setw(60) << "benchmark" << std::right
+                  << std::setw(14) << "baseline" << std::setw(14)
+                  << "contender" << std::setw(10) << "delta" << std::setw(10)
+                  << "p-value" << "  status" << '\n';
+        json report;
+        report["baseline"] = o.baseline;
+        report["contender"] = o.contender;
+        report["metric"] = o.metric;
+        report["threshold"] = o.threshold;
+        report["alpha"] = o.alpha;
+        report["benchmarks"] = json::array();
+        for (const benchmark_delta &d : deltas) {
+            regressions += d.status == "regression";
+            std::cout << std::left << std::setw(60) << d.name << std::right
+                      << std::setw(14) << d.baseline << std::setw(14)
+                      << d.contender << std::setw(9) << std::fixed
+                      << std::setprecision(1) << d.delta * 100. << "%"
+                      << std::setw(10) << std::setprecision(4);
+            if (d.p_value) {
+                std::cout << *d.p_value;
+            } else {
+                std::cout << "-";
+            }
+            std::cout << std::defaultfloat << std::setprecision(6) << "  "
+                      << d.status << '\n';
+            json entry = {{"name", d.name},
+                          {"status", d.status},
+                          {"baseline_ns", d.baseline},
+                          {"contender_ns", d.contender},
+                          {"delta", d.delta}};
+            entry["p_value"] = d.p_value ? json(*d.p_value) : json(nullptr);
+            report["benchmarks"].push_back(entry);
+        }
+        report["regressions"] = regressions;
+        std::cout << regressions << " regression(s) over "
+                  << o.threshold * 100. << "%" << std::endl;
+
+        if (!o.report.empty()) {
+            std::ofstream fout(o.report);
+            fout << std::setw(2) << report << std::endl;
+        }
+        return regressions == 0 ? 0 : 1;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+}
@@ -8,20 +8,27 @@
 #ifdef BUILD_BOOST_TREE
 #include <pareto/boost_tree.h>
 #endif
+#include "../perf_counters.h"
 #include "../test_helpers.h"
+#include "../workloads.h"
 
 /// \brief Construct a front
 /// Functors allow us to pass functions as template template parameters
 template<size_t COMPILE_DIMENSION, class Container>
 struct construct {
+    front_shape shape;
+    size_t m;
     void operator()(benchmark::State &state) const {
+        using pareto_front_t = pareto::front<double, COMPILE_DIMENSION, unsigned, Container>;
         size_t n = state.range(0);
+        perf_counters counters;
         for (auto _ : state) {
-            state.PauseTiming();
-            auto v = create_vector_with_values<COMPILE_DIMENSION, Container>(n);
-            state.ResumeTiming();
-            benchmark::DoNotOptimize(pareto::front<double, COMPILE_DIMENSION, unsigned, Container>(v.begin(), v.end()));
+            counters.pause(state);
+            auto v = create_shaped_values<pareto_front_t>(shape, n, m);
+            counters.resume(state);
+            benchmark::DoNotOptimize(pareto_front_t(v.begin(), v.end()));
         }
+        counters.report(state);
     }
 };
 
@@ -29,14 +36,20 @@ struct construct {
 /// Functors allow us to pass functions as template template parameters
 template<size_t COMPILE_DIMENSION, class Container>
 struct insert {
+    front_shape shape;
+    size_t m;
     void operator()(benchmark::State &state) const {
+        using pareto_front_t = pareto::front<double, COMPILE_DIMENSION, unsigned, Container>;
         size_t n = state.range(0);
+        perf_counters counters;
         for (auto _ : state) {
-            state.PauseTiming();
-            auto pf = create_test_pareto<COMPILE_DIMENSION, Container>(n);
-            state.ResumeTiming();
-            benchmark::DoNotOptimize(pf.insert(random_value<COMPILE_DIMENSION, Container>()));
+            counters.pause(state);
+            auto pf = get_shaped_front_from_cache<COMPILE_DIMENSION, Container>(shape, n, m);
+            auto p = shaped_query_point<typename pareto_front_t::key_type>(shape, m, workload_generator());
+            counters.resume(state);
+            benchmark::DoNotOptimize(pf.insert(std::make_pair(p, randi())));
         }
+        counters.report(state);
     }
 };
 
@@ -44,16 +57,21 @@ struct insert {
 /// Functors allow us to pass functions as template template parameters
 template<size_t COMPILE_DIMENSION, class Container>
 struct erase {
+    front_shape shape;
+    size_t m;
     void operator()(benchmark::State &state) const {
+        using pareto_front_t = pareto::front<double, COMPILE_DIMENSION, unsigned, Container>;
         auto n = static_cast<size_t>(state.range(0));
+        perf_counters counters;
         for (auto _ : state) {
-            state.PauseTiming();
-            auto pf = create_test_pareto<COMPILE_DIMENSION, Container>(n);
-            auto reference_p = random_point<COMPILE_DIMENSION, Container>();
+            counters.pause(state);
+            auto pf = get_shaped_front_from_cache<COMPILE_DIMENSION, Container>(shape, n, m);
+            auto reference_p = shaped_query_point<typename pareto_front_t::key_type>(shape, m, workload_generator());
             auto p = pf.find_nearest(reference_p);
-            state.ResumeTiming();
+            counters.resume(state);
             benchmark::DoNotOptimize(pf.erase(p));
         }
+        counters.report(state);
     }
 };
 
@@ -61,14 +79,19 @@ struct erase {
 /// Functors allow us to pass functions as template template parameters
 template<size_t COMPILE_DIMENSION, class Container>
 struct check_dominance {
+    front_shape shape;
+    size_t m;
     void operator()(benchmark::State &state) const {
+        using pareto_front_t = pareto::front<double, COMPILE_DIMENSION, unsigned, Container>;
+        perf_counters counters;
         for (auto _ : state) {
-            state.PauseTiming();
-            auto pf = create_test_pareto<COMPILE_DIMENSION, Container>(state.range(0));
-            auto p = random_point<COMPILE_DIMENSION, Container>();
-            state.ResumeTiming();
+            counters.pause(state);
+            auto pf = get_shaped_front_from_cache<COMPILE_DIMENSION, Container>(shape, state.range(0), m);
+            auto p = shaped_query_point<typename pareto_front_t::key_type>(shape, m, workload_generator());
+            counters.resume(state);
             benchmark::DoNotOptimize(pf.dominates(p));
         }
+        counters.report(state);
     }
 };
 
@@ -76,15 +99,20 @@ struct check_dominance {
 /// Functors allow us to pass functions as template template parameters
 template<size_t COMPILE_DIMENSION, class Container>
 struct query_intersection {
+    front_shape shape;
+    size_t m;
     void operator()(benchmark::State &state) const {
+        using pareto_front_t = pareto::front<double, COMPILE_DIMENSION, unsigned, Container>;
+        perf_counters counters;
         for (auto _ : state) {
-            state.PauseTiming();
-            auto pf = create_test_pareto<COMPILE_DIMENSION, Container>(state.range(0));
-            auto p1 = random_point<COMPILE_DIMENSION, Container>();
-            state.ResumeTiming();
+            counters.pause(state);
+            auto pf = get_shaped_front_from_cache<COMPILE_DIMENSION, Container>(shape, state.range(0), m);
+            auto p1 = shaped_query_point<typename pareto_front_t::key_type>(shape, m, workload_generator());
+            counters.resume(state);
             auto it = pf.find_intersection(p1,p1);
             benchmark::DoNotOptimize(it != pf.end());
         }
+        counters.report(state);
     }
 };
 
@@ -92,15 +120,20 @@ struct query_intersection {
 /// Functors allow us to pass functions as template template parameters
 template<size_t COMPILE_DIMENSION, class Container>
 struct query_nearest {
+    front_shape shape;
+    size_t m;
     void operator()(benchmark::State &state) const {
+        using pareto_front_t = pareto::front<double, COMPILE_DIMENSION, unsigned, Container>;
+        perf_counters counters;
         for (auto _ : state) {
-            state.PauseTiming();
-            auto pf = create_test_pareto<COMPILE_DIMENSION, Container>(state.range(0));
-            auto p = random_point<COMPILE_DIMENSION, Container>();
-            state.ResumeTiming();
+            counters.pause(state);
+            auto pf = get_shaped_front_from_cache<COMPILE_DIMENSION, Container>(shape, state.range(0), m);
+            auto p = shaped_query_point<typename pareto_front_t::key_type>(shape, m, workload_generator());
+            counters.resume(state);
             auto it = pf.find_nearest(p);
             benchmark::DoNotOptimize(it != pf.end());
         }
+        counters.report(state);
     }
 };
 
@@ -108,49 +141,48 @@ struct query_nearest {
 /// Functors allow us to pass functions as template template parameters
 template<size_t COMPILE_DIMENSION, class Container>
 struct hypervolume {
+    front_shape shape;
+    size_t m;
     void operator()(benchmark::State &state) const {
+        perf_counters counters;
         for (auto _ : state) {
-            state.PauseTiming();
-            auto pf = create_test_pareto<COMPILE_DIMENSION, Container>(state.range(0));
+            counters.pause(state);
+            auto pf = get_shaped_front_from_cache<COMPILE_DIMENSION, Container>(shape, state.range(0), m);
             auto nadir = pf.nadir();
             // size_t c = 0;
-            state.ResumeTiming();
+            counters.resume(state);
             if (state.range(1) == 0) {
                 benchmark::DoNotOptimize(pf.hypervolume(nadir));
             } else {
                 benchmark::DoNotOptimize(pf.hypervolume(state.range(1), nadir));
             }
         }
+        counters.report(state);
     }
 };
 
-template <typename FRONT_T, size_t COMPILE_DIMENSION>
-FRONT_T generate_reference_set() {
-    if constexpr (COMPILE_DIMENSION == 0) {
-        return FRONT_T(COMPILE_DIMENSION);
-    } else {
-        return FRONT_T();
-    }
-}
-
 /// Functors allow us to pass functions as template template parameters
 template<size_t COMPILE_DIMENSION, class Container>
 struct igd {
+    front_shape shape;
+    size_t m;
     void operator()(benchmark::State &state) const {
         using pareto_front_t = pareto::front<double, COMPILE_DIMENSION, unsigned, Container>;
+        perf_counters counters;
         for (auto _ : state) {
-            state.PauseTiming();
-            auto pf = create_test_pareto<COMPILE_DIMENSION, Container>(state.range(0));
+            counters.pause(state);
+            auto pf = get_shaped_front_from_cache<COMPILE_DIMENSION, Container>(shape, state.range(0), m);
             std::vector v(pf.begin(), pf.end());
-            auto reference_set = generate_reference_set<pareto_front_t,COMPILE_DIMENSION>();
+            pareto_front_t reference_set;
             for (auto &[k, v2] : v) {
                 auto k2 = k - 2.0;
                 reference_set.insert({k2, v2});
             }
             // size_t c = 0;
-            state.ResumeTiming();
+            counters.resume(state);
             benchmark::DoNotOptimize(pf.igd(reference_set));
         }
+        counters.report(state);
     }
 };
 
@@ -181,36 +213,96 @@ auto register_bench(const std::string& name, F functor, S s) {
 }
 
 template <size_t M, template <size_t,class> class F, bool is_boost_benchmark, class S>
-auto register_all_containers(const std::string& name, S state_values) {
-    if constexpr (!is_boost_benchmark) {
-        register_bench(name + ",implicit_tree>", F<M,pareto::implicit_tree<double,M,unsigned>>(), state_values);
-        register_bench(name + ",quad_tree>", F<M,pareto::quad_tree<double,M,unsigned>>(), state_values);
-        register_bench(name + ",kd_tree>", F<M,pareto::kd_tree<double,M,unsigned>>(), state_values);
-        register_bench(name + ",r_tree>", F<M,pareto::r_tree<double,M,unsigned>>(), state_values);
-        register_bench(name + ",r_star_tree>", F<M,pareto::r_star_tree<double,M,unsigned>>(), state_values);
-    }
+auto register_all_containers(const std::string& name, size_t m, S state_values) {
+    for (front_shape shape : all_front_shapes) {
+        const std::string shape_name = "," + to_string(shape) + ">";
+        if constexpr (!is_boost_benchmark) {
+            register_bench(name + ",implicit_tree" + shape_name, F<M,pareto::implicit_tree<double,M,unsigned>>{shape, m}, state_values);
+            register_bench(name + ",quad_tree" + shape_name, F<M,pareto::quad_tree<double,M,unsigned>>{shape, m}, state_values);
+            register_bench(name + ",kd_tree" + shape_name, F<M,pareto::kd_tree<double,M,unsigned>>{shape, m}, state_values);
+            register_bench(name + ",r_tree" + shape_name, F<M,pareto::r_tree<double,M,unsigned>>{shape, m}, state_values);
+            register_bench(name + ",r_star_tree" + shape_name, F<M,pareto::r_star_tree<double,M,unsigned>>{shape, m}, state_values);
+        }
 #ifdef BUILD_BOOST_TREE
-    else {
-        // register_bench(name + ",boost_tree>", F<M,pareto::boost_tree<double,M,unsigned>>(), state_values);
-    }
+        else {
+            // register_bench(name + ",boost_tree" + shape_name, F<M,pareto::boost_tree<double,M,unsigned>>{shape, m}, state_values);
+        }
 #endif
+    }
+}
+
+/// \brief Register a function with M dimensions at compile time and at runtime
+/// The containers with runtime dimensions (M = 0) are the ones
+/// we use in the Python bindings. Their benchmarks are named
+/// "op<m=0(M),..." so that runtime_ratio_reporter can compare
+/// them with "op<m=M,...".
+template <size_t M, template <size_t,class> class F, bool is_boost_benchmark, class S>
+void register_function(const std::string& op, S state_values) {
+    register_all_containers<M, F, is_boost_benchmark>(op + "<m=" + std::to_string(M), M, state_values);
+    register_all_containers<0, F, is_boost_benchmark>(op + "<m=0(" + std::to_string(M) + ")", M, state_values);
 }
 
 template <size_t M, bool is_hypervolume_benchmark, bool is_boost_benchmark>
 void register_all_functions() {
     if constexpr (!is_hypervolume_benchmark) {
-        register_all_containers<M, construct, is_boost_benchmark>("construct<m=" + std::to_string(M), pareto_sizes);
-        register_all_containers<M, insert, is_boost_benchmark>("insert<m=" + std::to_string(M), pareto_sizes);
-        register_all_containers<M, erase, is_boost_benchmark>("erase<m=" + std::to_string(M), pareto_sizes);
-        register_all_containers<M, check_dominance, is_boost_benchmark>("check_dominance<m=" + std::to_string(M), pareto_sizes);
-        register_all_containers<M, query_intersection, is_boost_benchmark>("query_intersection<m=" + std::to_string(M), pareto_sizes);
-        register_all_containers<M, query_nearest, is_boost_benchmark>("query_nearest<m=" + std::to_string(M), pareto_sizes);
-        register_all_containers<M, igd, is_boost_benchmark>("igd<m=" + std::to_string(M), pareto_sizes);
+        register_function<M, construct, is_boost_benchmark>("construct", pareto_sizes);
+        register_function<M, insert, is_boost_benchmark>("insert", pareto_sizes);
+        register_function<M, erase, is_boost_benchmark>("erase", pareto_sizes);
+        register_function<M, check_dominance, is_boost_benchmark>("check_dominance", pareto_sizes);
+        register_function<M, query_intersection, is_boost_benchmark>("query_intersection", pareto_sizes);
+        register_function<M, query_nearest, is_boost_benchmark>("query_nearest", pareto_sizes);
+        register_function<M, igd, is_boost_benchmark>("igd", pareto_sizes);
     } else {
-        register_all_containers<M, hypervolume, is_boost_benchmark>("hypervolume<m=" + std::to_string(M), pareto_sizes_and_samples);
+        register_function<M, hypervolume, is_boost_benchmark>("hypervolume", pareto_sizes_and_samples);
     }
 }
 
+/// \brief Console reporter that also compares runtime and compile time dimensions
+/// After all benchmarks run, it prints how many times slower each
+/// "op<m=0(M),..." benchmark was than its "op<m=M,..." counterpart.
+class runtime_ratio_reporter : public benchmark::ConsoleReporter {
+  public:
+    void ReportRuns(const std::vector<Run>& reports) override {
+        for (const auto& run : reports) {
+            if (run.run_type == Run::RT_Iteration) {
+                auto& [sum, count] = times_[run.benchmark_name()];
+                sum += run.GetAdjustedRealTime();
+                ++count;
+            }
+        }
+        ConsoleReporter::ReportRuns(reports);
+    }
+
+    void Finalize() override {
+        ConsoleReporter::Finalize();
+        bool header = false;
+        for (const auto& [name, time] : times_) {
+            const size_t open = name.find("<m=0(");
+            if (open == std::string::npos) {
+                continue;
+            }
+            const size_t close = name.find(')', open);
+            std::string compile_name = name.substr(0, open) + "<m=" +
+                                       name.substr(open + 5, close - open - 5) +
+                                       name.substr(close + 1);
+            auto it = times_.find(compile_name);
+            if (it == times_.end() || it->second.first == 0.) {
+                continue;
+            }
+            if (!header) {
+                GetOutputStream() << "\nRuntime / compile time dimensions:\n";
+                header = true;
+            }
+            const double runtime_mean = time.first / time.second;
+            const double compile_mean = it->second.first / it->second.second;
+            GetOutputStream() << name << ": " << runtime_mean / compile_mean << "x\n";
+        }
+    }
+
+  private:
+    std::map<std::string, std::pair<double, size_t>> times_;
+};
+
 template <bool is_hypervolume_benchmark, bool is_boost_benchmark>
 auto register_all_dimensions() {
 #ifdef BUILD_LONG_TESTS
@@ -254,6 +346,7 @@ int main(int argc, char** argv) {
      * Within each group, we follow this order:
      * * Smaller dimensions first
      * * Then each function
+     * * Then each front shape (see workloads.h)
      * * Then each data structure
      *
      */
@@ -267,5 +360,6 @@ int main(int argc, char** argv) {
     // register_all_dimensions<true,true>();
 
     benchmark::Initialize(&argc, argv);
-    benchmark::RunSpecifiedBenchmarks();
+    runtime_ratio_reporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
 }
\ No newline at end of file
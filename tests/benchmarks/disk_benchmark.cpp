@@ -0,0 +1,153 @@
+#include <benchmark/benchmark.h>
+#include <pareto/disk_tree.h>
+#include <pareto/front.h>
+#include "../test_helpers.h"
+
+/*
+ * These benchmarks measure the disk tree with a buffer pool much smaller
+ * than the container. The "page_reads" and "page_writes" counters are the
+ * number of pages that went through the page file per iteration.
+ *
+ * The page files are created in the system temporary directory. Use
+ * "TMPDIR=/path/to/disk ./disk_benchmark" to measure another disk.
+ */
+
+constexpr size_t dimensions = 3;
+using disk_tree_type = pareto::disk_tree<double, dimensions, unsigned>;
+using disk_front_type =
+    pareto::front<double, dimensions, unsigned, disk_tree_type>;
+using value_type = disk_tree_type::value_type;
+
+/// \brief Options with a buffer pool of a given number of pages
+pareto::disk_tree_options pool_options(size_t buffer_pool_pages) {
+    pareto::disk_tree_options options;
+    options.buffer_pool_pages = buffer_pool_pages;
+    return options;
+}
+
+/// \brief Values on the plane x+y+z=1, which do not dominate each other
+std::vector<value_type> create_front_values(size_t n) {
+    std::vector<value_type> values;
+    values.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        pareto::point<double, dimensions> p;
+        double sum = 0.;
+        for (size_t j = 0; j < dimensions; ++j) {
+            p[j] = randu() + 1e-6;
+            sum += p[j];
+        }
+        for (size_t j = 0; j < dimensions; ++j) {
+            p[j] /= sum;
+        }
+        values.emplace_back(p, randi());
+    }
+    return values;
+}
+
+/// \brief Bulk load the container
+/// range(0) is the number of elements and range(1) is the pool size
+void bulk_load(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto options = pool_options(static_cast<size_t>(state.range(1)));
+    auto values = create_vector_with_values<dimensions, disk_tree_type>(n);
+    size_t writes = 0;
+    for (auto _ : state) {
+        disk_tree_type t(values.begin(), values.end(), options);
+        t.flush();
+        writes += t.page_writes();
+        benchmark::DoNotOptimize(t.size());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["page_writes"] = benchmark::Counter(
+        static_cast<double>(writes), benchmark::Counter::kAvgIterations);
+}
+
+/// \brief Box and nearest queries
+/// range(0) is the number of elements and range(1) is the pool size
+void queries(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto options = pool_options(static_cast<size_t>(state.range(1)));
+    auto values = create_vector_with_values<dimensions, disk_tree_type>(n);
+    disk_tree_type t(values.begin(), values.end(), options);
+    auto points = create_vector_with_values<dimensions, disk_tree_type>(100);
+    const size_t reads_before = t.page_reads();
+    for (auto _ : state) {
+        for (const auto &[p, v] : points) {
+            pareto::point<double, dimensions> ub(p);
+            for (size_t i = 0; i < dimensions; ++i) {
+                ub[i] += 0.1;
+            }
+            benchmark::DoNotOptimize(
+                std::distance(t.find_intersection(p, ub), t.end()));
+            benchmark::DoNotOptimize(t.find_nearest(p, 5) != t.end());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * points.size());
+    state.counters["page_reads"] =
+        benchmark::Counter(static_cast<double>(t.page_reads() - reads_before),
+                           benchmark::Counter::kAvgIterations);
+}
+
+/// \brief Stream all elements through the buffer pool
+/// range(0) is the number of elements and range(1) is the pool size
+void streaming_iteration(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto options = pool_options(static_cast<size_t>(state.range(1)));
+    auto values = create_vector_with_values<dimensions, disk_tree_type>(n);
+    disk_tree_type t(values.begin(), values.end(), options);
+    for (auto _ : state) {
+        double sum = 0.;
+        for (const auto &[p, v] : t) {
+            sum += p[0];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+/// \brief Insert batches of non-dominated elements in a front
+/// Each insertion checks dominance against the elements in the pages.
+/// range(0) is the number of elements and range(1) is the pool size
+void front_batch_insert(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto options = pool_options(static_cast<size_t>(state.range(1)));
+    auto values = create_front_values(n);
+    for (auto _ : state) {
+        disk_front_type pf(disk_tree_type{options});
+        constexpr size_t batch_size = 1000;
+        for (size_t i = 0; i < values.size(); i += batch_size) {
+            const size_t last = std::min(i + batch_size, values.size());
+            pf.insert(values.begin() + static_cast<std::ptrdiff_t>(i),
+                      values.begin() + static_cast<std::ptrdiff_t>(last));
+        }
+        benchmark::DoNotOptimize(pf.size());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+void sizes_and_pools(benchmark::internal::Benchmark *b) {
+    for (long long n = 10000; n <= 1000000; n *= 10) {
+        for (long long pool = 16; pool <= 1024; pool *= 8) {
+            b->Args({n, pool});
+        }
+    }
+}
+
+void front_sizes_and_pools(benchmark::internal::Benchmark *b) {
+    for (long long n = 1000; n <= 10000; n *= 10) {
+        for (long long pool = 16; pool <= 1024; pool *= 8) {
+            b->Args({n, pool});
+        }
+    }
+}
+
+BENCHMARK(bulk_load)->Apply(sizes_and_pools)->Unit(benchmark::kMillisecond);
+BENCHMARK(queries)->Apply(sizes_and_pools);
+BENCHMARK(streaming_iteration)
+    ->Apply(sizes_and_pools)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(front_batch_insert)
+    ->Apply(front_sizes_and_pools)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
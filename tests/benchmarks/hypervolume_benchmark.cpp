@@ -1,65 +1,29 @@
 #include <benchmark/benchmark.h>
 #include <pareto/front.h>
+#include "../perf_counters.h"
 #include "../test_helpers.h"
-
-template<size_t dimensions, size_t runtime_dimensions>
-typename pareto::front<double, dimensions, unsigned>::key_type random_point() {
-    typename pareto::front<double, dimensions, unsigned>::key_type p(runtime_dimensions);
-    std::generate(p.begin(), p.end(), randn);
-    return p;
-}
-
-template<size_t dimensions, size_t runtime_dimensions>
-typename pareto::front<double, dimensions, unsigned>::value_type random_value() {
-    auto v = std::make_pair<typename pareto::front<double, dimensions, unsigned>::key_type, unsigned>(
-            random_point<dimensions, runtime_dimensions>(), randi());
-    return v;
-}
-
-template<typename FRONT_T, size_t dimensions, size_t runtime_dimensions>
-FRONT_T generate_reference_set() {
-    if constexpr (dimensions == 0) {
-        return FRONT_T(runtime_dimensions);
-    } else {
-        return FRONT_T();
-    }
-}
-
-template<size_t dimensions, size_t runtime_dimensions>
-pareto::front<double, dimensions, unsigned>
-create_test_pareto(size_t target_size) {
-    static std::map<size_t, pareto::front<double, dimensions, unsigned>> cache;
-    auto it = cache.find(target_size);
-    if (it != cache.end()) {
-        return it->second;
-    }
-    auto pf = generate_reference_set<pareto::front<double, dimensions, unsigned>, dimensions, runtime_dimensions>();
-    for (size_t i = 0; i < std::max(static_cast<size_t>(1000000), target_size * 100) && pf.size() < target_size; ++i) {
-        pf.insert(random_value<dimensions, runtime_dimensions>());
-    }
-    cache[target_size] = pf;
-    return pf;
-}
+#include "../workloads.h"
 
 template<size_t dimensions>
 void calculate_hypervolume(benchmark::State &state) {
-    // using pareto_front_t = pareto::front<double, dimensions, unsigned>;
-    // using point_t = typename pareto_front_t::key_type;
+    auto shape = static_cast<front_shape>(state.range(2));
     double hv = 0.0;
-    static std::map<size_t, double> known_hv;
+    static std::map<std::pair<size_t, front_shape>, double> known_hv;
+    auto hv_key = std::make_pair(size_t(state.range(0)), shape);
     if constexpr (dimensions == 0) {
-        if (known_hv.find(size_t(state.range(0))) != known_hv.end()) {
-            hv = known_hv[state.range(0)];
+        if (known_hv.find(hv_key) != known_hv.end()) {
+            hv = known_hv[hv_key];
         }
     }
 
+    perf_counters counters;
     for (auto _ : state) {
-        state.PauseTiming();
-        auto pf = create_test_pareto<dimensions, dimensions>(state.range(0));
+        counters.pause(state);
+        auto pf = get_shaped_front_from_cache<dimensions>(shape, state.range(0));
         auto nadir = pf.nadir();
         // size_t c = 0;
 
-        state.ResumeTiming();
+        counters.resume(state);
         if (state.range(1) == 0) {
             if (hv == 0.0) {
                 benchmark::DoNotOptimize(hv = pf.hypervolume(nadir));
@@ -68,13 +32,15 @@ void calculate_hypervolume(benchmark::State &state) {
             benchmark::DoNotOptimize(hv = pf.hypervolume(state.range(1), nadir));
         }
     }
+    counters.report(state);
 
     if constexpr (dimensions == 0) {
-        if (known_hv.find(size_t(state.range(0))) == known_hv.end()) {
-            known_hv[state.range(0)] = hv;
+        if (known_hv.find(hv_key) == known_hv.end()) {
+            known_hv[hv_key] = hv;
         }
     }
 
+    state.SetLabel(to_string(shape));
     state.counters["hv"] = hv;
 }
 
@@ -82,27 +48,33 @@ constexpr size_t max_pareto_size = 5000;
 constexpr size_t max_number_of_samples = 10000;
 
 void pareto_sizes_and_samples(benchmark::internal::Benchmark *b) {
-    for (long long i = 50; i <= static_cast<long long>(max_pareto_size); i *= 10) {
-        b->Args({i, 0});
-        for (long long j = 100; j <= static_cast<long long>(max_number_of_samples); j *= 10) {
-            b->Args({i, j});
+    for (front_shape shape : all_front_shapes) {
+        const auto s = static_cast<long long>(shape);
+        for (long long i = 50; i <= static_cast<long long>(max_pareto_size); i *= 10) {
+            b->Args({i, 0, s});
+            for (long long j = 100; j <= static_cast<long long>(max_number_of_samples); j *= 10) {
+                b->Args({i, j, s});
+            }
         }
     }
 }
 
 void pareto_sizes_and_samples2(benchmark::internal::Benchmark *b) {
-    for (long long i = 50; i <= 200; i *= 2) {
-        b->Args({i, 0});
+    for (front_shape shape : all_front_shapes) {
+        const auto s = static_cast<long long>(shape);
+        for (long long i = 50; i <= 200; i *= 2) {
+            b->Args({i, 0, s});
+            for (long long j = 100; j <= static_cast<long long>(max_number_of_samples); j *= 10) {
+                b->Args({i, j, s});
+            }
+        }
+        // if we calculate with n=200, we might as well try to calculate with n=500
+        // but that's not usually feasiable though
+        b->Args({500, 0, s});
         for (long long j = 100; j <= static_cast<long long>(max_number_of_samples); j *= 10) {
-            b->Args({i, j});
+            b->Args({500, j, s});
         }
     }
-    // if we calculate with n=200, we might as well try to calculate with n=500
-    // but that's not usually feasiable though
-    b->Args({500, 0});
-    for (long long j = 100; j <= static_cast<long long>(max_number_of_samples); j *= 10) {
-        b->Args({500, j});
-    }
 }
 
 size_t number_of_threads = std::thread::hardware_concurrency();
@@ -115,4 +87,4 @@ BENCHMARK_TEMPLATE(calculate_hypervolume, 9)->Apply(pareto_sizes_and_samples2)->
 BENCHMARK_TEMPLATE(calculate_hypervolume, 9)->Apply(pareto_sizes_and_samples)->Iterations(1);
 #endif
 
-BENCHMARK_MAIN();
\ No newline at end of file
+BENCHMARK_MAIN();
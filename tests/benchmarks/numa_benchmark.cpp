@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+#include <pareto/common/numa.h>
+#include <pareto/front.h>
+#include <pareto/replicated_front.h>
+#include <pareto/sharded_front.h>
+#include "../test_helpers.h"
+
+/*
+ * These benchmarks compare fronts whose nodes are on the NUMA node of
+ * the thread querying them with fronts whose nodes are somewhere else.
+ *
+ * On a single-node machine, all variants should take the same time.
+ * Remote memory can be simulated by running the benchmarks with a
+ * memory policy that differs from the CPU policy, e.g.
+ * "numactl --cpunodebind=0 --membind=1 ./numa_benchmark"
+ * in which case only the fronts bound with a node hint are local.
+ *
+ * Node hints only bind the container pools when the library is built
+ * with BUILD_PARETO_WITH_PMR. Otherwise, the "node" argument is ignored
+ * and all variants use the memory policy of the process.
+ */
+
+constexpr size_t dimensions = 3;
+using container_type = pareto::r_tree<double, dimensions, unsigned>;
+using front_type = pareto::front<double, dimensions, unsigned>;
+
+/// \brief Queries on a front whose pool is bound to a NUMA node
+/// range(0) is the front size and range(1) is the node (-1 for no hint)
+void query_bound_front(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto node = static_cast<int>(state.range(1));
+    const front_type reference =
+        get_test_pareto_from_cache<dimensions, container_type>(n, 0);
+    pareto::numa_node_guard guard(node);
+    front_type pf;
+    pf = reference;
+    auto points = create_vector_with_values<dimensions, container_type>(1000);
+    for (auto _ : state) {
+        for (const auto &[p, v] : points) {
+            benchmark::DoNotOptimize(pf.dominates(p));
+            benchmark::DoNotOptimize(pf.find_nearest(p) != pf.end());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * points.size());
+    state.counters["thread_node"] = pareto::current_numa_node();
+}
+
+/// \brief Queries on the local replica of a replicated front
+/// range(0) is the front size
+void query_replicated_front(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const front_type reference =
+        get_test_pareto_from_cache<dimensions, container_type>(n, 0);
+    pareto::replicated_front<double, dimensions, unsigned> replicated(
+        reference);
+    auto points = create_vector_with_values<dimensions, container_type>(1000);
+    for (auto _ : state) {
+        const front_type &pf = replicated.local();
+        for (const auto &[p, v] : points) {
+            benchmark::DoNotOptimize(pf.dominates(p));
+            benchmark::DoNotOptimize(pf.find_nearest(p) != pf.end());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * points.size());
+    state.counters["replicas"] =
+        static_cast<double>(replicated.number_of_replicas());
+}
+
+/// \brief Concurrent inserts in a sharded front
+/// range(0) is the number of elements per worker and range(1) is 1 if
+/// workers bind their shards to their own NUMA node
+void sharded_insert(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const bool bind_shards = state.range(1) != 0;
+    const size_t n_workers = pareto::default_number_of_threads();
+    std::vector<std::vector<front_type::value_type>> values(n_workers);
+    for (auto &v : values) {
+        v = create_vector_with_values<dimensions, container_type>(n);
+    }
+    for (auto _ : state) {
+        pareto::sharded_front<double, dimensions, unsigned> sf(n_workers);
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < n_workers; ++i) {
+            workers.emplace_back([&, i]() {
+                if (bind_shards) {
+                    sf.bind_shard(i);
+                }
+                for (const auto &v : values[i]) {
+                    sf.insert(i, v);
+                }
+                // query the local shard after building it
+                for (const auto &[p, v] : values[i]) {
+                    benchmark::DoNotOptimize(sf.shard(i).dominates(p));
+                }
+            });
+        }
+        for (auto &w : workers) {
+            w.join();
+        }
+        benchmark::DoNotOptimize(sf.total_shard_sizes());
+    }
+    state.SetItemsProcessed(state.iterations() * n * n_workers);
+}
+
+void sizes_and_nodes(benchmark::internal::Benchmark *b) {
+    const auto n_nodes = static_cast<long long>(pareto::number_of_numa_nodes());
+    for (long long n = 100; n <= 10000; n *= 10) {
+        for (long long node = -1; node < n_nodes; ++node) {
+            b->Args({n, node});
+        }
+    }
+}
+
+void sizes(benchmark::internal::Benchmark *b) {
+    for (long long n = 100; n <= 10000; n *= 10) {
+        b->Args({n});
+    }
+}
+
+void sizes_and_binding(benchmark::internal::Benchmark *b) {
+    for (long long n = 100; n <= 10000; n *= 10) {
+        b->Args({n, 0});
+        b->Args({n, 1});
+    }
+}
+
+BENCHMARK(query_bound_front)->Apply(sizes_and_nodes);
+BENCHMARK(query_replicated_front)->Apply(sizes);
+BENCHMARK(sharded_insert)->Apply(sizes_and_binding)->UseRealTime();
+
+BENCHMARK_MAIN();
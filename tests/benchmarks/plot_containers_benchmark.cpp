@@ -49,11 +49,16 @@ int main(int argc, char **argv) {
 
     size_t replicates = 30;
 
+    // Front shape (see workloads.h)
+    std::string_view front_shape = "concave";
+
     // Helper function
-    auto get_benchmark_name = [](std::string_view op, size_t m, size_t n,
-                                 std::string_view container) {
+    auto get_benchmark_name = [front_shape](std::string_view op, size_t m,
+                                            size_t n,
+                                            std::string_view container) {
         std::string r = std::string(op) + "<m=" + std::to_string(m) + "," +
-                        std::string(container) + ">/" + std::to_string(n);
+                        std::string(container) + "," +
+                        std::string(front_shape) + ">/" + std::to_string(n);
         if (op == "hypervolume") {
             r += "/10000";
         }
@@ -2,6 +2,7 @@
 #include <pareto/common/default_allocator.h>
 #include <pareto/point.h>
 #include <pareto/spatial_map.h>
+#include "../perf_counters.h"
 #include "../test_helpers.h"
 #include <map>
 
@@ -13,9 +14,13 @@ pareto::point<int, 3> random_int_point() {
 
 void std_allocator_map(benchmark::State& state) {
     std::map<int, int, std::less<>, std::allocator<std::pair<const int, int>>> m;
+    perf_counters counters;
+    counters.start();
     for (auto _ : state) {
         m.emplace(randi(),randi());
     }
+    counters.stop();
+    counters.report(state);
 }
 
 BENCHMARK(std_allocator_map);
@@ -23,9 +28,13 @@ BENCHMARK(std_allocator_map);
 #ifdef BUILD_PARETO_WITH_PMR
 void default_pmr_allocator_map(benchmark::State& state) {
     std::map<int, int, std::less<>, std::pmr::polymorphic_allocator<std::pair<const int, int>>> m;
+    perf_counters counters;
+    counters.start();
     for (auto _ : state) {
         m.emplace(randi(),randi());
     }
+    counters.stop();
+    counters.report(state);
 }
 BENCHMARK(default_pmr_allocator_map);
 
@@ -34,9 +43,13 @@ void unsyncronized_allocator_map(benchmark::State& state) {
     std::pmr::unsynchronized_pool_resource pool;
     std::pmr::polymorphic_allocator<std::pair<const int, int>> alloc(&pool);
     std::map<int, int, std::less<>, std::pmr::polymorphic_allocator<std::pair<const int, int>>> m(alloc);
+    perf_counters counters;
+    counters.start();
     for (auto _ : state) {
         m.emplace(randi(),randi());
     }
+    counters.stop();
+    counters.report(state);
 }
 BENCHMARK(unsyncronized_allocator_map);
 
@@ -45,9 +58,13 @@ void monotonic_allocator_map(benchmark::State& state) {
     std::pmr::monotonic_buffer_resource pool;
     std::pmr::polymorphic_allocator<std::pair<const int, int>> alloc(&pool);
     std::map<int, int, std::less<>, std::pmr::polymorphic_allocator<std::pair<const int, int>>> m(alloc);
+    perf_counters counters;
+    counters.start();
     for (auto _ : state) {
         m.emplace(randi(),randi());
     }
+    counters.stop();
+    counters.report(state);
 }
 BENCHMARK(monotonic_allocator_map);
 
@@ -55,9 +72,13 @@ BENCHMARK(monotonic_allocator_map);
 
 void std_allocator_spatial_map(benchmark::State& state) {
     pareto::spatial_map<int, 3, int, std::less<>, std::allocator<std::pair<const pareto::point<int,3>, int>>> m;
+    perf_counters counters;
+    counters.start();
     for (auto _ : state) {
         m.emplace(random_int_point(),randi());
     }
+    counters.stop();
+    counters.report(state);
 }
 BENCHMARK(std_allocator_spatial_map);
 
@@ -65,17 +86,25 @@ BENCHMARK(std_allocator_spatial_map);
 #ifdef BUILD_PARETO_WITH_PMR
 void default_pmr_allocator_spatial_map(benchmark::State& state) {
     pareto::spatial_map<int, 3, int, std::less<>, std::pmr::polymorphic_allocator<std::pair<const pareto::point<int,3>, int>>> m;
+    perf_counters counters;
+    counters.start();
     for (auto _ : state) {
         m.emplace(random_int_point(),randi());
     }
+    counters.stop();
+    counters.report(state);
 }
 BENCHMARK(default_pmr_allocator_spatial_map);
 
 void default_pareto_allocator_spatial_map(benchmark::State& state) {
     pareto::spatial_map<int, 3, int, std::less<>> m;
+    perf_counters counters;
+    counters.start();
     for (auto _ : state) {
         m.emplace(random_int_point(),randi());
     }
+    counters.stop();
+    counters.report(state);
 }
 BENCHMARK(default_pareto_allocator_spatial_map);
 
@@ -83,9 +112,13 @@ void unsyncronized_allocator_spatial_map(benchmark::State& state) {
     std::pmr::unsynchronized_pool_resource pool;
     std::pmr::polymorphic_allocator<std::pair<const int, int>> alloc(&pool);
     pareto::spatial_map<int, 3, int, std::less<>, std::pmr::polymorphic_allocator<std::pair<const pareto::point<int,3>, int>>> m(alloc);
+    perf_counters counters;
+    counters.start();
     for (auto _ : state) {
         m.emplace(random_int_point(),randi());
     }
+    counters.stop();
+    counters.report(state);
 }
 BENCHMARK(unsyncronized_allocator_spatial_map);
 
@@ -93,9 +126,13 @@ void monotonic_allocator_spatial_map(benchmark::State& state) {
     std::pmr::monotonic_buffer_resource pool(100000);
     std::pmr::polymorphic_allocator<std::pair<const int, int>> alloc(&pool);
     pareto::spatial_map<int, 3, int, std::less<>, std::pmr::polymorphic_allocator<std::pair<const pareto::point<int,3>, int>>> m(alloc);
+    perf_counters counters;
+    counters.start();
     for (auto _ : state) {
         m.emplace(random_int_point(),randi());
     }
+    counters.stop();
+    counters.report(state);
 }
 BENCHMARK(monotonic_allocator_spatial_map);
 #endif
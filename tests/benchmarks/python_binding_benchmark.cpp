@@ -0,0 +1,179 @@
+#include <benchmark/benchmark.h>
+#include <pybind11/embed.h>
+#include <pybind11/stl.h>
+#include <pareto/front.h>
+#include <pareto/kd_tree.h>
+#include <pareto/r_tree.h>
+#include "../test_helpers.h"
+#include "../workloads.h"
+
+/*
+ * These benchmarks call the Python bindings from an embedded
+ * interpreter. Each operation goes through the same argument
+ * conversion and dispatch as a call from a Python script, so the
+ * difference between "python_op" and "op" is the binding overhead
+ * on top of the runtime dimension (M = 0) containers.
+ *
+ * PARETO_PYTHON_MODULE_DIR is the directory with the compiled
+ * pareto module.
+ */
+
+namespace py = pybind11;
+
+/// \brief The pareto module, imported once
+/// The module is never destroyed because the interpreter is
+/// finalized before static objects are.
+py::module_ &pareto_module() {
+    static auto *m = [] {
+        py::module_::import("sys").attr("path").attr("insert")(
+            0, PARETO_PYTHON_MODULE_DIR);
+        return new py::module_(py::module_::import("pareto"));
+    }();
+    return *m;
+}
+
+using cpp_point_type = pareto::point<double, 0>;
+
+/// \brief Convert a C++ point to a Python point
+py::object to_python_point(const cpp_point_type &p) {
+    return pareto_module().attr("point")(
+        std::vector<double>(p.begin(), p.end()));
+}
+
+/// \brief Python and C++ fronts with the same shaped elements
+/// \tparam Container Container of the C++ front
+template <class Container> struct front_pair {
+    pareto::front<double, 0, unsigned, Container> cpp;
+    py::object python;
+};
+
+template <class Container>
+front_pair<Container> create_front_pair(const char *python_type,
+                                        front_shape shape, size_t n,
+                                        size_t m) {
+    front_pair<Container> r;
+    r.cpp = create_shaped_front<0, Container>(shape, n, m);
+    r.python = pareto_module().attr(python_type)();
+    for (const auto &[k, v] : r.cpp) {
+        r.python.attr("insert")(py::make_tuple(to_python_point(k), v));
+    }
+    return r;
+}
+
+/// \brief Insert in a front
+/// range(0) is the front size and range(1) is the number of dimensions
+template <class Container> struct insert {
+    const char *python_type;
+    bool use_python;
+    void operator()(benchmark::State &state) const {
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto m = static_cast<size_t>(state.range(1));
+        auto fronts =
+            create_front_pair<Container>(python_type, front_shape::concave,
+                                         n, m);
+        for (auto _ : state) {
+            state.PauseTiming();
+            auto p = shaped_query_point<cpp_point_type>(
+                front_shape::concave, m, workload_generator());
+            py::object py_p = to_python_point(p);
+            state.ResumeTiming();
+            if (use_python) {
+                fronts.python.attr("insert")(py::make_tuple(py_p, 0));
+            } else {
+                benchmark::DoNotOptimize(fronts.cpp.insert({p, 0}));
+            }
+        }
+    }
+};
+
+/// \brief Check point-front dominance
+/// range(0) is the front size and range(1) is the number of dimensions
+template <class Container> struct check_dominance {
+    const char *python_type;
+    bool use_python;
+    void operator()(benchmark::State &state) const {
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto m = static_cast<size_t>(state.range(1));
+        auto fronts =
+            create_front_pair<Container>(python_type, front_shape::concave,
+                                         n, m);
+        py::object dominates = fronts.python.attr("dominates");
+        for (auto _ : state) {
+            state.PauseTiming();
+            auto p = shaped_query_point<cpp_point_type>(
+                front_shape::concave, m, workload_generator());
+            py::object py_p = to_python_point(p);
+            state.ResumeTiming();
+            if (use_python) {
+                benchmark::DoNotOptimize(dominates(py_p).cast<bool>());
+            } else {
+                benchmark::DoNotOptimize(fronts.cpp.dominates(p));
+            }
+        }
+    }
+};
+
+/// \brief Find the nearest element
+/// range(0) is the front size and range(1) is the number of dimensions
+template <class Container> struct query_nearest {
+    const char *python_type;
+    bool use_python;
+    void operator()(benchmark::State &state) const {
+        const auto n = static_cast<size_t>(state.range(0));
+        const auto m = static_cast<size_t>(state.range(1));
+        auto fronts =
+            create_front_pair<Container>(python_type, front_shape::concave,
+                                         n, m);
+        py::object find_nearest = fronts.python.attr("find_nearest");
+        py::object next = py::module_::import("builtins").attr("next");
+        for (auto _ : state) {
+            state.PauseTiming();
+            auto p = shaped_query_point<cpp_point_type>(
+                front_shape::concave, m, workload_generator());
+            py::object py_p = to_python_point(p);
+            state.ResumeTiming();
+            if (use_python) {
+                benchmark::DoNotOptimize(next(find_nearest(py_p)).ptr());
+            } else {
+                auto it = fronts.cpp.find_nearest(p);
+                benchmark::DoNotOptimize(it != fronts.cpp.end());
+            }
+        }
+    }
+};
+
+void sizes_and_dimensions(benchmark::internal::Benchmark *b) {
+    for (long long n : {50, 500, 5000}) {
+        for (long long m : {2, 3, 5, 9}) {
+            b->Args({n, m});
+        }
+    }
+}
+
+template <template <class> class F>
+void register_function(const std::string &op) {
+    using r_tree_type = pareto::r_tree<double, 0, unsigned>;
+    using kd_tree_type = pareto::kd_tree<double, 0, unsigned>;
+    benchmark::RegisterBenchmark((op + "<r_tree>").c_str(),
+                                 F<r_tree_type>{"r_front", false})
+        ->Apply(sizes_and_dimensions);
+    benchmark::RegisterBenchmark(("python_" + op + "<r_tree>").c_str(),
+                                 F<r_tree_type>{"r_front", true})
+        ->Apply(sizes_and_dimensions);
+    benchmark::RegisterBenchmark((op + "<kd_tree>").c_str(),
+                                 F<kd_tree_type>{"kd_front", false})
+        ->Apply(sizes_and_dimensions);
+    benchmark::RegisterBenchmark(("python_" + op + "<kd_tree>").c_str(),
+                                 F<kd_tree_type>{"kd_front", true})
+        ->Apply(sizes_and_dimensions);
+}
+
+int main(int argc, char **argv) {
+    py::scoped_interpreter guard{};
+    register_function<insert>("insert");
+    register_function<check_dominance>("check_dominance");
+    register_function<query_nearest>("query_nearest");
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+}
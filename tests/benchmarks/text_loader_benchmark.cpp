@@ -0,0 +1,142 @@
+#include <benchmark/benchmark.h>
+#include <pareto/front.h>
+#include <pareto/implicit_tree.h>
+#include <pareto/text_loader.h>
+#include "../test_helpers.h"
+#include <sstream>
+
+/*
+ * These benchmarks compare the text loader with the usual iostream
+ * loop for reference front files. The "bytes_per_second" counter is
+ * the throughput of the whole load, including the front.
+ */
+
+constexpr size_t dimensions = 3;
+using front_type = pareto::front<double, dimensions, size_t>;
+using implicit_front_type =
+    pareto::front<double, dimensions, size_t,
+                  pareto::implicit_tree<double, dimensions, size_t>>;
+
+/// \brief Text of a reference front on the plane x+y+z=1
+std::string create_front_text(size_t n) {
+    std::ostringstream out;
+    out.precision(17);
+    for (size_t i = 0; i < n; ++i) {
+        const double x = randu() + 1e-6;
+        const double y = randu() + 1e-6;
+        const double z = randu() + 1e-6;
+        const double sum = x + y + z;
+        out << x / sum << ' ' << y / sum << ' ' << z / sum << '\n';
+    }
+    return out.str();
+}
+
+/// \brief Load with iostreams and insert one point at a time
+/// range(0) is the number of points
+void iostream_insert(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const std::string text = create_front_text(n);
+    for (auto _ : state) {
+        std::istringstream in(text);
+        front_type pf;
+        pareto::point<double, dimensions> p;
+        size_t i = 0;
+        while (in >> p[0] >> p[1] >> p[2]) {
+            pf.insert(std::make_pair(p, i++));
+        }
+        benchmark::DoNotOptimize(pf.size());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(text.size()));
+}
+
+/// \brief Parse the points only
+/// range(0) is the number of points and range(1) is the number of threads
+void parse_points(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const std::string text = create_front_text(n);
+    pareto::text_loader_options options;
+    options.number_of_threads = static_cast<size_t>(state.range(1));
+    options.min_chunk_size = 1 << 16;
+    for (auto _ : state) {
+        auto values =
+            pareto::parse_text_points<double, dimensions, size_t>(text,
+                                                                  options);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(text.size()));
+}
+
+/// \brief Parse the points and bulk load them into a front
+/// range(0) is the number of points, range(1) is the number of threads,
+/// and range(2) is whether we filter dominated points
+template <class FRONT> void load_front(benchmark::State &state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const std::string text = create_front_text(n);
+    pareto::text_loader_options options;
+    options.number_of_threads = static_cast<size_t>(state.range(1));
+    options.min_chunk_size = 1 << 16;
+    options.filter_dominated = state.range(2) != 0;
+    for (auto _ : state) {
+        auto values =
+            pareto::parse_text_points<double, dimensions, size_t>(text,
+                                                                  options);
+        FRONT pf;
+        pf.bulk_insert(values.begin(), values.end(),
+                       options.filter_dominated);
+        benchmark::DoNotOptimize(pf.size());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(text.size()));
+}
+
+void sizes(benchmark::internal::Benchmark *b) {
+    for (long long n = 10000; n <= 1000000; n *= 10) {
+        b->Args({n});
+    }
+}
+
+void sizes_and_threads(benchmark::internal::Benchmark *b) {
+    for (long long n = 10000; n <= 1000000; n *= 10) {
+        for (long long threads : {1, 4}) {
+            b->Args({n, threads});
+        }
+    }
+}
+
+void sizes_threads_and_filters(benchmark::internal::Benchmark *b) {
+    for (long long n = 10000; n <= 1000000; n *= 10) {
+        for (long long threads : {1, 4}) {
+            for (long long filter : {0, 1}) {
+                b->Args({n, threads, filter});
+            }
+        }
+    }
+}
+
+/// The implicit tree has no index to filter dominated points quickly,
+/// so it is only used for reference fronts
+void sizes_threads_without_filter(benchmark::internal::Benchmark *b) {
+    for (long long n = 10000; n <= 1000000; n *= 10) {
+        for (long long threads : {1, 4}) {
+            b->Args({n, threads, 0});
+        }
+    }
+}
+
+BENCHMARK(iostream_insert)->Apply(sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(parse_points)
+    ->Apply(sizes_and_threads)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(load_front, front_type)
+    ->Apply(sizes_threads_and_filters)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(load_front, implicit_front_type)
+    ->Apply(sizes_threads_without_filter)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
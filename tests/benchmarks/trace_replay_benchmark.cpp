@@ -0,0 +1,158 @@
+#include <benchmark/benchmark.h>
+#include <pareto/archive.h>
+#include <pareto/front.h>
+#include <pareto/implicit_tree.h>
+#include <pareto/kd_tree.h>
+#include <pareto/operation_trace.h>
+#include <pareto/quad_tree.h>
+#include <pareto/r_star_tree.h>
+#include <pareto/r_tree.h>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "../test_helpers.h"
+#include "../workloads.h"
+
+/*
+ * These benchmarks replay an operation trace against fronts or
+ * archives with each container, so we can compare the containers
+ * on the access pattern of a real optimizer.
+ *
+ * Run with "./trace_replay_benchmark --trace=run.trace" to replay
+ * a trace recorded with pareto::operation_trace_writer. Without a
+ * trace, the benchmarks replay a synthetic trace of a concave front
+ * with 70% dominance checks, 20% inserts, 5% nearest queries and 5%
+ * erasures.
+ *
+ * Traces of archives start with the archive capacity (a resize
+ * record), so they are replayed against archives. All other traces
+ * are replayed against fronts. The containers have runtime
+ * dimensions (M = 0) because the traces can have any number of
+ * dimensions.
+ */
+
+/// \brief Records of the trace we replay
+std::vector<pareto::trace_record> &trace_records() {
+    static std::vector<pareto::trace_record> records;
+    return records;
+}
+
+/// \brief Record a synthetic trace
+std::string synthetic_trace() {
+    std::stringstream ss;
+    pareto::operation_trace_writer writer(ss);
+    auto pf = create_shaped_front<3>(front_shape::concave, 1000);
+    pf.set_operation_trace(&writer);
+    std::mt19937 &g = workload_generator();
+    std::uniform_int_distribution<int> percent(0, 99);
+    for (size_t i = 0; i < 20000; ++i) {
+        const int r = percent(g);
+        auto p = shaped_query_point<pareto::point<double, 3>>(
+            front_shape::concave, 3, g);
+        if (r < 70) {
+            benchmark::DoNotOptimize(pf.dominates(p));
+        } else if (r < 90) {
+            pf.insert({shaped_point<pareto::point<double, 3>>(
+                           front_shape::concave, 3, g),
+                       0});
+        } else if (r < 95) {
+            benchmark::DoNotOptimize(pf.find_nearest(p) != pf.end());
+        } else {
+            auto it = pf.find_nearest(p);
+            if (it != pf.end()) {
+                pf.erase(it->first);
+            }
+        }
+    }
+    pf.set_operation_trace(nullptr);
+    return ss.str();
+}
+
+/// \brief Whether the trace was recorded from an archive
+bool is_archive_trace() {
+    const auto &records = trace_records();
+    return std::any_of(records.begin(), records.end(), [](const auto &r) {
+        return r.op == pareto::trace_opcode::resize;
+    });
+}
+
+/// \brief Replay the trace in an empty front or archive
+template <class Adapter> struct replay_trace {
+    void operator()(benchmark::State &state) const {
+        const auto &records = trace_records();
+        for (auto _ : state) {
+            Adapter c;
+            double sum = 0.;
+            for (const pareto::trace_record &r : records) {
+                sum += pareto::replay(r, c);
+            }
+            benchmark::DoNotOptimize(sum);
+            state.counters["size"] = static_cast<double>(c.size());
+        }
+        state.SetItemsProcessed(state.iterations() *
+                                static_cast<int64_t>(records.size()));
+    }
+};
+
+template <template <class> class F, class Container>
+void register_container(const std::string &name) {
+    using front_type = pareto::front<double, 0, unsigned, Container>;
+    using archive_type = pareto::archive<double, 0, unsigned, Container>;
+    if (is_archive_trace()) {
+        benchmark::RegisterBenchmark(("replay<archive," + name + ">").c_str(),
+                                     F<archive_type>())
+            ->Unit(benchmark::kMillisecond);
+    } else {
+        benchmark::RegisterBenchmark(("replay<front," + name + ">").c_str(),
+                                     F<front_type>())
+            ->Unit(benchmark::kMillisecond);
+    }
+}
+
+int main(int argc, char **argv) {
+    // take --trace out of the arguments before benchmark sees them
+    std::string trace_path;
+    int n_args = 0;
+    for (int i = 0; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--trace=", 8) == 0) {
+            trace_path = argv[i] + 8;
+        } else {
+            argv[n_args++] = argv[i];
+        }
+    }
+    argc = n_args;
+
+    try {
+        if (trace_path.empty()) {
+            std::stringstream ss(synthetic_trace());
+            trace_records() = pareto::operation_trace_reader(ss).read_all();
+        } else {
+            std::ifstream in(trace_path, std::ios::binary);
+            if (!in) {
+                std::cerr << "Cannot open " << trace_path << std::endl;
+                return 1;
+            }
+            trace_records() = pareto::operation_trace_reader(in).read_all();
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    register_container<replay_trace,
+                       pareto::implicit_tree<double, 0, unsigned>>(
+        "implicit_tree");
+    register_container<replay_trace, pareto::quad_tree<double, 0, unsigned>>(
+        "quad_tree");
+    register_container<replay_trace, pareto::kd_tree<double, 0, unsigned>>(
+        "kd_tree");
+    register_container<replay_trace, pareto::r_tree<double, 0, unsigned>>(
+        "r_tree");
+    register_container<replay_trace,
+                       pareto::r_star_tree<double, 0, unsigned>>(
+        "r_star_tree");
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,391 @@
+#include <pareto/archive.h>
+#include <pareto/common/tracing.h>
+#include <pareto/front.h>
+#include <pareto/implicit_tree.h>
+#include <pareto/kd_tree.h>
+#include <pareto/quad_tree.h>
+#include <pareto/r_star_tree.h>
+#include <pareto/r_tree.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <shared_mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "../test_helpers.h"
+#include "../workloads.h"
+
+/*
+ * Steady-state workload driver
+ *
+ * Microbenchmarks measure one operation at a time on a container that
+ * does not change. Optimizers mix operations: most candidates are only
+ * checked for dominance, some of them are inserted, and elements are
+ * queried and removed as the front moves. This driver replays such a
+ * mix against a live front or archive for a fixed duration, as YCSB
+ * does for key-value stores, and reports the throughput and the
+ * latency percentiles of each operation.
+ *
+ * Usage:
+ *     ./workload_driver --mix=dominates:70,insert:20,nearest:5,erase:5
+ *                       --duration=10 --threads=1 --structure=front
+ *                       --container=r_tree --shape=concave --size=10000
+ *                       --dimensions=3 --capacity=1000 --stream=65536
+ *
+ * All options are optional and the values above are the defaults.
+ * Inserted points are on the front shape, so they never dominate
+ * the elements already there and the size of the front only changes
+ * with the insert and erase rates. Query points are perturbed points
+ * of the shape, so some of them are dominated and some are not.
+ * Erase removes the element nearest to a query point, so its latency
+ * includes one nearest query.
+ *
+ * Each client generates its stream of operations and points before
+ * the clock starts, so the latencies only include the operations.
+ * Clients cycle through their streams until the duration is over.
+ *
+ * Fronts and archives are not concurrent containers yet. With more
+ * than one client thread, the driver protects the container with a
+ * shared mutex: queries share the lock and modifiers take it
+ * exclusively. The latencies include the time waiting for the lock.
+ */
+
+/// \brief Options of the driver
+struct driver_options {
+    std::vector<std::pair<pareto::traced_operation, double>> mix = {
+        {pareto::traced_operation::dominates, 70.},
+        {pareto::traced_operation::insert, 20.},
+        {pareto::traced_operation::find_nearest, 5.},
+        {pareto::traced_operation::erase, 5.}};
+    double duration = 10.;
+    size_t threads = 1;
+    std::string structure = "front";
+    std::string container = "r_tree";
+    front_shape shape = front_shape::concave;
+    size_t size = 10000;
+    size_t dimensions = 3;
+    size_t capacity = 1000;
+    size_t stream = 65536;
+};
+
+/// \brief Operations the driver can replay
+pareto::traced_operation parse_operation(const std::string &name) {
+    using pareto::traced_operation;
+    for (traced_operation op :
+         {traced_operation::insert, traced_operation::erase,
+          traced_operation::dominates, traced_operation::find_nearest}) {
+        if (name == pareto::to_string(op)) {
+            return op;
+        }
+    }
+    if (name == "nearest") {
+        return traced_operation::find_nearest;
+    }
+    throw std::invalid_argument("Unknown operation: " + name);
+}
+
+/// \brief Parse a mix such as "dominates:70,insert:30"
+std::vector<std::pair<pareto::traced_operation, double>>
+parse_mix(const std::string &s) {
+    std::vector<std::pair<pareto::traced_operation, double>> mix;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        const size_t colon = item.find(':');
+        if (colon == std::string::npos) {
+            throw std::invalid_argument("Expected operation:weight in " +
+                                        item);
+        }
+        const double weight = std::stod(item.substr(colon + 1));
+        if (weight < 0.) {
+            throw std::invalid_argument("Negative weight in " + item);
+        }
+        mix.emplace_back(parse_operation(item.substr(0, colon)), weight);
+    }
+    if (mix.empty()) {
+        throw std::invalid_argument("Empty operation mix");
+    }
+    return mix;
+}
+
+front_shape parse_shape(const std::string &name) {
+    for (front_shape s : all_front_shapes) {
+        if (name == to_string(s)) {
+            return s;
+        }
+    }
+    throw std::invalid_argument("Unknown front shape: " + name);
+}
+
+driver_options parse_options(int argc, char **argv) {
+    driver_options o;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+            throw std::invalid_argument("Expected --option=value: " + arg);
+        }
+        const std::string key = arg.substr(2, eq - 2);
+        const std::string value = arg.substr(eq + 1);
+        if (key == "mix") {
+            o.mix = parse_mix(value);
+        } else if (key == "duration") {
+            o.duration = std::stod(value);
+        } else if (key == "threads") {
+            o.threads = std::max(std::stoul(value), 1ul);
+        } else if (key == "structure") {
+            o.structure = value;
+        } else if (key == "container") {
+            o.container = value;
+        } else if (key == "shape") {
+            o.shape = parse_shape(value);
+        } else if (key == "size") {
+            o.size = std::stoul(value);
+        } else if (key == "dimensions") {
+            o.dimensions = std::max(std::stoul(value), 1ul);
+        } else if (key == "capacity") {
+            o.capacity = std::stoul(value);
+        } else if (key == "stream") {
+            o.stream = std::max(std::stoul(value), 1ul);
+        } else {
+            throw std::invalid_argument("Unknown option: " + key);
+        }
+    }
+    return o;
+}
+
+/// \brief Latencies and counts of each operation
+struct driver_results {
+    std::array<pareto::latency_histogram,
+               pareto::number_of_traced_operations>
+        latencies;
+    std::array<std::atomic<uint64_t>, pareto::number_of_traced_operations>
+        successes{};
+    double elapsed_seconds = 0.;
+    size_t initial_size = 0;
+    size_t final_size = 0;
+};
+
+/// \brief An operation of a client stream and its point
+template <class Adapter> struct operation_request {
+    pareto::traced_operation op;
+    typename Adapter::key_type point;
+};
+
+/// \brief Generate the operations of one client
+/// Inserted points are on the shape and the other points are
+/// perturbed points of the shape.
+template <class Adapter>
+std::vector<operation_request<Adapter>>
+generate_stream(const driver_options &o, const std::vector<double> &weights,
+                size_t id) {
+    using pareto::traced_operation;
+    using key_type = typename Adapter::key_type;
+    std::mt19937 g(static_cast<std::mt19937::result_type>(fixed_seed() + id));
+    std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+    std::vector<operation_request<Adapter>> stream;
+    stream.reserve(o.stream);
+    for (size_t i = 0; i < o.stream; ++i) {
+        const traced_operation op = o.mix[pick(g)].first;
+        stream.push_back(
+            {op, op == traced_operation::insert
+                     ? shaped_point<key_type>(o.shape, o.dimensions, g)
+                     : shaped_query_point<key_type>(o.shape, o.dimensions, g)});
+    }
+    return stream;
+}
+
+/// \brief Run one operation on a front or archive
+/// \return True if the operation succeeded (the point was dominated,
+/// the element was inserted, found, or erased)
+template <class Adapter>
+bool run_operation(Adapter &pf, std::shared_mutex &mutex, bool use_lock,
+                   const operation_request<Adapter> &request) {
+    using pareto::traced_operation;
+    using key_type = typename Adapter::key_type;
+    const key_type &p = request.point;
+    switch (request.op) {
+    case traced_operation::dominates: {
+        std::shared_lock lock(mutex, std::defer_lock);
+        if (use_lock) {
+            lock.lock();
+        }
+        return pf.dominates(p);
+    }
+    case traced_operation::find_nearest: {
+        std::shared_lock lock(mutex, std::defer_lock);
+        if (use_lock) {
+            lock.lock();
+        }
+        return pf.find_nearest(p) != pf.end();
+    }
+    case traced_operation::insert: {
+        std::unique_lock lock(mutex, std::defer_lock);
+        if (use_lock) {
+            lock.lock();
+        }
+        return pf.insert({p, 0}).second;
+    }
+    case traced_operation::erase: {
+        std::unique_lock lock(mutex, std::defer_lock);
+        if (use_lock) {
+            lock.lock();
+        }
+        auto it = pf.find_nearest(p);
+        if (it == pf.end()) {
+            return false;
+        }
+        const key_type k = it->first;
+        return pf.erase(k) > 0;
+    }
+    default:
+        return false;
+    }
+}
+
+/// \brief Replay the mix with all client threads for the duration
+template <class Adapter>
+void run_clients(Adapter &pf, const driver_options &o, driver_results &r) {
+    std::vector<double> weights;
+    for (const auto &[op, w] : o.mix) {
+        weights.emplace_back(w);
+    }
+    std::shared_mutex mutex;
+    const bool use_lock = o.threads > 1;
+    std::atomic<bool> stop{false};
+    r.initial_size = pf.size();
+    std::vector<std::vector<operation_request<Adapter>>> streams;
+    for (size_t i = 0; i < o.threads; ++i) {
+        streams.emplace_back(generate_stream<Adapter>(o, weights, i));
+    }
+
+    auto client = [&](size_t id) {
+        const auto &stream = streams[id];
+        for (size_t next = 0; !stop.load(std::memory_order_relaxed);
+             next = (next + 1) % stream.size()) {
+            const operation_request<Adapter> &request = stream[next];
+            const auto start = std::chrono::steady_clock::now();
+            const bool ok = run_operation(pf, mutex, use_lock, request);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            const auto i = static_cast<size_t>(request.op);
+            r.latencies[i].record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                    .count()));
+            if (ok) {
+                r.successes[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> clients;
+    for (size_t i = 0; i < o.threads; ++i) {
+        clients.emplace_back(client, i);
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(o.duration));
+    stop = true;
+    for (std::thread &t : clients) {
+        t.join();
+    }
+    r.elapsed_seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+    r.final_size = pf.size();
+}
+
+/// \brief Build the front or archive and replay the mix
+template <size_t M, class Container>
+void run_structure(const driver_options &o, driver_results &r) {
+    auto pf = create_shaped_front<M, Container>(o.shape, o.size, o.dimensions);
+    if (o.structure == "front") {
+        run_clients(pf, o, r);
+    } else if (o.structure == "archive") {
+        pareto::archive<double, M, unsigned, Container> ar(
+            std::max(o.capacity, pf.size()), pf.begin(), pf.end());
+        ar.resize(o.capacity);
+        run_clients(ar, o, r);
+    } else {
+        throw std::invalid_argument("Unknown structure: " + o.structure);
+    }
+}
+
+/// \brief Choose the container
+/// Dimensions without a compile time instantiation use the
+/// containers with runtime dimensions (M = 0).
+template <size_t M> void run_container(const driver_options &o, driver_results &r) {
+    if (o.container == "implicit_tree") {
+        run_structure<M, pareto::implicit_tree<double, M, unsigned>>(o, r);
+    } else if (o.container == "quad_tree") {
+        run_structure<M, pareto::quad_tree<double, M, unsigned>>(o, r);
+    } else if (o.container == "kd_tree") {
+        run_structure<M, pareto::kd_tree<double, M, unsigned>>(o, r);
+    } else if (o.container == "r_tree") {
+        run_structure<M, pareto::r_tree<double, M, unsigned>>(o, r);
+    } else if (o.container == "r_star_tree") {
+        run_structure<M, pareto::r_star_tree<double, M, unsigned>>(o, r);
+    } else {
+        throw std::invalid_argument("Unknown container: " + o.container);
+    }
+}
+
+void print_results(const driver_options &o, const driver_results &r) {
+    uint64_t total = 0;
+    for (const auto &h : r.latencies) {
+        total += h.count();
+    }
+    std::cout << o.structure << "<" << o.container << ",m=" << o.dimensions
+              << "," << to_string(o.shape) << "> with " << o.threads
+              << " client thread(s) for " << r.elapsed_seconds << "s\n";
+    std::cout << "size: " << r.initial_size << " -> " << r.final_size
+              << "\n";
+    std::cout << "throughput: " << static_cast<double>(total) /
+                                         r.elapsed_seconds
+              << " ops/s\n";
+    std::cout << std::left << std::setw(14) << "operation" << std::right
+              << std::setw(12) << "count" << std::setw(12) << "success"
+              << std::setw(14) << "ops/s" << std::setw(12) << "p50 (ns)"
+              << std::setw(12) << "p99 (ns)" << std::setw(12) << "p999 (ns)"
+              << std::setw(12) << "max (ns)" << '\n';
+    for (size_t i = 0; i < pareto::number_of_traced_operations; ++i) {
+        const pareto::latency_histogram &h = r.latencies[i];
+        if (h.count() == 0) {
+            continue;
+        }
+        std::cout << std::left << std::setw(14)
+                  << pareto::to_string(static_cast<pareto::traced_operation>(i))
+                  << std::right << std::setw(12) << h.count() << std::setw(12)
+                  << r.successes[i].load() << std::setw(14)
+                  << static_cast<uint64_t>(static_cast<double>(h.count()) /
+                                           r.elapsed_seconds)
+                  << std::setw(12) << h.percentile(50.) << std::setw(12)
+                  << h.percentile(99.) << std::setw(12) << h.percentile(99.9)
+                  << std::setw(12) << h.max() << '\n';
+    }
+}
+
+int main(int argc, char **argv) {
+    try {
+        const driver_options o = parse_options(argc, argv);
+        driver_results r;
+        switch (o.dimensions) {
+        case 2:
+            run_container<2>(o, r);
+            break;
+        case 3:
+            run_container<3>(o, r);
+            break;
+        case 5:
+            run_container<5>(o, r);
+            break;
+        default:
+            run_container<0>(o, r);
+            break;
+        }
+        print_results(o, r);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
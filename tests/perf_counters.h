@@ -0,0 +1,224 @@
+//
+// Hardware performance counters for benchmarks
+//
+
+#ifndef PARETO_PERF_COUNTERS_H
+#define PARETO_PERF_COUNTERS_H
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/// \brief Hardware counters around the timed regions of a benchmark
+/// Wall time alone does not tell us why a node layout or container is
+/// faster. When the environment variable PARETO_PERF_COUNTERS is set
+/// (e.g. "PARETO_PERF_COUNTERS=1 ./containers_benchmark"), this class
+/// opens Linux perf_event counters for the calling thread and reports
+/// cycles, instructions, instructions per cycle, cache misses, branch
+/// misses, and dTLB misses per iteration as user counters.
+///
+/// Replace state.PauseTiming() / state.ResumeTiming() with pause(state)
+/// and resume(state) so the counters exclude the same setup code as the
+/// timer, or call start() and stop() around a loop without pauses:
+///
+///     perf_counters counters;
+///     counters.start();
+///     for (auto _ : state) { ... }
+///     counters.stop();
+///     counters.report(state);
+///
+/// Counters that cannot be opened (containers and VMs often have no
+/// PMU, and perf_event_paranoid may forbid them) are not reported. On
+/// other platforms, or without the variable, this class does nothing.
+class perf_counters {
+  public:
+    perf_counters() {
+        fds_.fill(-1);
+        if (!enabled()) {
+            return;
+        }
+#ifdef __linux__
+        int last_error = 0;
+        for (size_t i = 0; i < events().size(); ++i) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = events()[i].type;
+            attr.config = events()[i].config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds_[i] = static_cast<int>(
+                syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fds_[i] == -1) {
+                last_error = errno;
+            }
+        }
+        if (!available() && !warned()) {
+            warned() = true;
+            std::cerr << "PARETO_PERF_COUNTERS: hardware counters are not "
+                         "available ("
+                      << std::strerror(last_error) << ")" << std::endl;
+        }
+#endif
+    }
+
+    ~perf_counters() {
+#ifdef __linux__
+        for (int fd : fds_) {
+            if (fd != -1) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    perf_counters(const perf_counters &) = delete;
+    perf_counters &operator=(const perf_counters &) = delete;
+
+    /// \brief True if the counters were requested with PARETO_PERF_COUNTERS
+    static bool enabled() {
+        const char *v = std::getenv("PARETO_PERF_COUNTERS");
+        return v != nullptr && *v != '\0' && std::string(v) != "0";
+    }
+
+    /// \brief True if at least one counter is open
+    [[nodiscard]] bool available() const {
+        for (int fd : fds_) {
+            if (fd != -1) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// \brief Start counting
+    void start() { control(enable_request()); }
+
+    /// \brief Stop counting
+    void stop() { control(disable_request()); }
+
+    /// \brief Pause the timer and the counters
+    void pause(benchmark::State &state) {
+        stop();
+        state.PauseTiming();
+    }
+
+    /// \brief Resume the timer and the counters
+    void resume(benchmark::State &state) {
+        state.ResumeTiming();
+        start();
+    }
+
+    /// \brief Report the counts per iteration as user counters
+    void report(benchmark::State &state) const {
+        std::array<double, n_events> values{};
+        bool has_value = false;
+        for (size_t i = 0; i < n_events; ++i) {
+            values[i] = read(i);
+            if (values[i] >= 0.) {
+                state.counters[events()[i].name] = benchmark::Counter(
+                    values[i], benchmark::Counter::kAvgIterations);
+                has_value = true;
+            }
+        }
+        if (has_value && values[0] > 0. && values[1] >= 0.) {
+            state.counters["IPC"] = values[1] / values[0];
+        }
+    }
+
+  private:
+    struct event {
+        const char *name;
+        uint32_t type;
+        uint64_t config;
+    };
+
+    static constexpr size_t n_events = 5;
+
+#ifdef __linux__
+    /// Cycles and instructions must come first (see report)
+    static const std::array<event, n_events> &events() {
+        static const std::array<event, n_events> e = {
+            {{"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+             {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+             {"cache_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+             {"branch_misses", PERF_TYPE_HARDWARE,
+              PERF_COUNT_HW_BRANCH_MISSES},
+             {"dTLB_misses", PERF_TYPE_HW_CACHE,
+              PERF_COUNT_HW_CACHE_DTLB |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)}}};
+        return e;
+    }
+
+    static unsigned long enable_request() { return PERF_EVENT_IOC_ENABLE; }
+    static unsigned long disable_request() { return PERF_EVENT_IOC_DISABLE; }
+#else
+    static const std::array<event, n_events> &events() {
+        static const std::array<event, n_events> e = {
+            {{"cycles", 0, 0},
+             {"instructions", 0, 0},
+             {"cache_misses", 0, 0},
+             {"branch_misses", 0, 0},
+             {"dTLB_misses", 0, 0}}};
+        return e;
+    }
+
+    static unsigned long enable_request() { return 0; }
+    static unsigned long disable_request() { return 0; }
+#endif
+
+    static bool &warned() {
+        static bool w = false;
+        return w;
+    }
+
+    void control([[maybe_unused]] unsigned long request) {
+#ifdef __linux__
+        for (int fd : fds_) {
+            if (fd != -1) {
+                ioctl(fd, request, 0);
+            }
+        }
+#endif
+    }
+
+    /// \brief Count of event i, scaled if the kernel multiplexed it
+    /// \return -1 if the counter is not available
+    [[nodiscard]] double read([[maybe_unused]] size_t i) const {
+#ifdef __linux__
+        // value, time enabled, time running
+        uint64_t v[3] = {0, 0, 0};
+        if (fds_[i] == -1 ||
+            ::read(fds_[i], v, sizeof(v)) != static_cast<ssize_t>(sizeof(v))) {
+            return -1.;
+        }
+        if (v[2] == 0) {
+            // never scheduled on the PMU
+            return v[1] == 0 ? 0. : -1.;
+        }
+        return static_cast<double>(v[0]) * static_cast<double>(v[1]) /
+               static_cast<double>(v[2]);
+#else
+        return -1.;
+#endif
+    }
+
+    std::array<int, n_events> fds_{};
+};
+
+#endif // PARETO_PERF_COUNTERS_H
@@ -14,9 +14,13 @@
 #include <pareto/r_tree.h>
 #elif r_star_TREETAG
 #include <pareto/r_star_tree.h>
+#elif disk_TREETAG
+#include <pareto/disk_tree.h>
 #endif
 
 #include <pareto/archive.h>
+#include <pareto/change_log.h>
+#include <pareto/transaction.h>
 
 template <size_t COMPILE_DIMENSION, typename Container>
 void test_archive(size_t RUNTIME_DIMENSION = COMPILE_DIMENSION,
@@ -205,7 +209,22 @@ void test_archive(size_t RUNTIME_DIMENSION = COMPILE_DIMENSION,
         }
         archive_type ar3 = ar;
         REQUIRE_FALSE(ar.dominates(ar3));
+        // merging rank by rank is equivalent to inserting every element
+        archive_type ar4(10 * max_size, {}, is_mini.begin(), is_mini.end());
+        ar4.insert(ar.begin(), ar.end());
+        archive_type ar5 = ar4;
+        archive_type ar6 = ar2;
+        ar4.insert(ar2.begin(), ar2.end());
+        ar5.merge(std::move(ar6));
+        REQUIRE(ar6.empty());
+        REQUIRE(ar5.check_invariants());
+        REQUIRE(ar4.size() == ar5.size());
+        REQUIRE(ar4.size_fronts() == ar5.size_fronts());
+        for (const auto &[k, v] : ar4) {
+            REQUIRE(ar5.contains(k));
+        }
         ar3.merge(ar2);
+        REQUIRE(ar3.check_invariants());
         REQUIRE_FALSE(ar2.dominates(ar3));
         size_t ars1 = ar.size();
         size_t ars2 = ar2.size();
@@ -214,6 +233,106 @@ void test_archive(size_t RUNTIME_DIMENSION = COMPILE_DIMENSION,
         REQUIRE(ars2 == ar.size());
     }
 
+    SECTION("What-if insertion") {
+        auto ar = random_pareto_archive();
+        const archive_type original = ar;
+        {
+            transaction<archive_type> t(ar);
+            for (size_t i = 0; i < 50; ++i) {
+                auto v = random_value();
+                auto preview = ar.preview_insert(v.first);
+                REQUIRE(preview.rank <= ar.size_fronts());
+                t.insert(v);
+                if (preview.inserted && ar.size() < ar.capacity()) {
+                    REQUIRE(ar.contains(v.first));
+                }
+            }
+            if (!ar.empty()) {
+                REQUIRE(t.erase(ar.begin()->first) > 0);
+            }
+            REQUIRE(ar.check_invariants());
+            // rolled back by the destructor
+        }
+        REQUIRE(ar.check_invariants());
+        REQUIRE(ar.size() == original.size());
+        REQUIRE(ar.size_fronts() == original.size_fronts());
+        for (const auto &[k, v] : original) {
+            REQUIRE(ar.contains(k));
+        }
+        // committed changes are kept
+        transaction<archive_type> t(ar);
+        auto v = random_value();
+        const bool inserted = t.insert(v);
+        t.commit();
+        t.rollback();
+        REQUIRE(ar.contains(v.first) == inserted);
+    }
+
+    SECTION("Change log") {
+        auto ar = random_pareto_archive();
+        // replay the feed into a mirror of the archive ranks
+        std::vector<std::vector<point_type>> mirror;
+        auto remove_from = [&](size_t rank, const point_type &k) {
+            REQUIRE(rank < mirror.size());
+            auto it = std::find(mirror[rank].begin(), mirror[rank].end(), k);
+            REQUIRE(it != mirror[rank].end());
+            mirror[rank].erase(it);
+        };
+        change_log<point_type> log(
+            [&](const change<point_type> &c) {
+                switch (c.type) {
+                case change_type::insert:
+                    mirror[c.rank].emplace_back(c.key);
+                    break;
+                case change_type::erase:
+                    remove_from(c.rank, c.key);
+                    break;
+                case change_type::move:
+                    remove_from(c.previous_rank, c.key);
+                    mirror[c.rank].emplace_back(c.key);
+                    break;
+                case change_type::insert_front:
+                    mirror.emplace(mirror.begin() + c.rank);
+                    break;
+                case change_type::erase_front:
+                    REQUIRE(mirror[c.rank].empty());
+                    mirror.erase(mirror.begin() + c.rank);
+                    break;
+                case change_type::clear:
+                    mirror.clear();
+                    break;
+                }
+            },
+            true);
+        ar.set_change_log(&log);
+        ar = random_pareto_archive();
+        for (size_t i = 0; i < 200; ++i) {
+            ar.insert(random_value());
+        }
+        for (size_t i = 0; i < 20 && !ar.empty(); ++i) {
+            ar.erase(ar.begin()->first);
+        }
+        // merges log each element they insert, move or evict
+        const uint64_t before_merge = log.next_sequence();
+        ar.merge(random_pareto_archive());
+        auto source = random_pareto_archive();
+        auto first_rank = *source.begin_front();
+        ar.merge(first_rank);
+        for (auto it = log.since(before_merge); it != log.end(); ++it) {
+            REQUIRE(it->type != change_type::clear);
+        }
+        REQUIRE(log.size() == log.next_sequence());
+        REQUIRE(mirror.size() == ar.size_fronts());
+        size_t rank = 0;
+        for (auto it = ar.begin_front(); it != ar.end_front(); ++it) {
+            REQUIRE(mirror[rank].size() == it->size());
+            for (const auto &k : mirror[rank]) {
+                REQUIRE(it->contains(k));
+            }
+            ++rank;
+        }
+    }
+
     SECTION("Queries") {
         auto ar = random_pareto_archive();
         auto p = random_point();
@@ -265,6 +384,12 @@ void test_archive(size_t RUNTIME_DIMENSION = COMPILE_DIMENSION,
             }
             REQUIRE_FALSE(c > 5);
         }
+        REQUIRE(static_cast<size_t>(std::distance(
+                    ar.find_nearest(p, ar.size() + 5), ar.end())) ==
+                ar.size());
+        ar.clear();
+        REQUIRE(ar.find_nearest(p) == ar.end());
+        REQUIRE(ar.find_nearest(p, 5) == ar.end());
     }
 
     SECTION("Indicators") {
@@ -598,4 +723,15 @@ TEST_CASE("R*-Archive") {
         test_all_dimensions<false, pareto::r_star_tree>();
     }
 }
+#elif disk_TREETAG
+// small pages and buffer pool so that pages split and get evicted
+template <class K, size_t M, class T, class C, class A>
+using small_page_disk_tree =
+    pareto::disk_tree<K, M, T, C, A, pareto::disk_tree_defaults<256, 4>>;
+
+TEST_CASE("Disk-Archive") {
+    SECTION("Compile Time Dimension") {
+        test_all_dimensions<false, small_page_disk_tree>();
+    }
+}
 #endif
\ No newline at end of file
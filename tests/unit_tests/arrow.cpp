@@ -0,0 +1,105 @@
+
+#include "../test_helpers.h"
+#include <catch2/catch.hpp>
+#include <pareto/archive.h>
+#include <pareto/arrow.h>
+
+TEST_CASE("Arrow") {
+    /*
+     * Columns from Arrow are read by the bulk loader and
+     * exported column by column.
+     */
+    using namespace pareto;
+    // columns x0, x1, id of a struct array with 5 rows
+    // the first row is skipped by the offset
+    std::vector<double> x0 = {9., 0.1, 0.5, 0.6, 0.9};
+    std::vector<float> x1 = {9.f, 0.875f, 0.5f, 0.625f, 0.125f};
+    std::vector<int64_t> ids = {0, 1, 2, 3, 4};
+    const void *x0_buffers[] = {nullptr, x0.data()};
+    const void *x1_buffers[] = {nullptr, x1.data()};
+    const void *id_buffers[] = {nullptr, ids.data()};
+    ArrowArray x0_array{5, 0, 0, 2, 0, x0_buffers, nullptr,
+                        nullptr, nullptr, nullptr};
+    ArrowArray x1_array{5, 0, 0, 2, 0, x1_buffers, nullptr,
+                        nullptr, nullptr, nullptr};
+    ArrowArray id_array{5, 0, 0, 2, 0, id_buffers, nullptr,
+                        nullptr, nullptr, nullptr};
+    ArrowSchema x0_schema{"g", "x0", nullptr, 0, 0, nullptr,
+                          nullptr, nullptr, nullptr};
+    ArrowSchema x1_schema{"f", "x1", nullptr, 0, 0, nullptr,
+                          nullptr, nullptr, nullptr};
+    ArrowSchema id_schema{"l", "id", nullptr, 0, 0, nullptr,
+                          nullptr, nullptr, nullptr};
+    ArrowArray *children[] = {&x0_array, &x1_array, &id_array};
+    ArrowSchema *child_schemas[] = {&x0_schema, &x1_schema, &id_schema};
+    const void *struct_buffers[] = {nullptr};
+    ArrowArray array{4, 0, 1, 1, 3, struct_buffers, children,
+                     nullptr, nullptr, nullptr};
+    ArrowSchema schema{"+s", "", nullptr, 0, 3, child_schemas,
+                       nullptr, nullptr, nullptr};
+
+    // (0.6, 0.625) is dominated by (0.5, 0.5)
+    front<double, 2, unsigned> pf;
+    REQUIRE(import_arrow(pf, array, schema) == 3);
+    REQUIRE(pf.size() == 3);
+    REQUIRE(pf.contains({0.5, 0.5}));
+    REQUIRE_FALSE(pf.contains({0.6, 0.625}));
+    REQUIRE_FALSE(pf.contains({9., 9.}));
+    REQUIRE(pf.at({0.9, 0.125}) == 4);
+
+    ArrowArray out;
+    ArrowSchema out_schema;
+    export_arrow(pf, &out, &out_schema);
+    REQUIRE(out.length == 3);
+    REQUIRE(out_schema.n_children == 3);
+    REQUIRE(std::string(out_schema.children[2]->name) == "id");
+    REQUIRE(std::string(out_schema.children[2]->format) == "I");
+    // round trip
+    front<double, 2, unsigned> pf2;
+    REQUIRE(import_arrow(pf2, out, out_schema) == 3);
+    for (const auto &[k, v] : pf) {
+        REQUIRE(pf2.at(k) == v);
+    }
+    out_schema.release(&out_schema);
+    const auto *x0_out = static_cast<const double *>(
+        out.children[0]->buffers[1]);
+    REQUIRE(pf.contains({x0_out[0], static_cast<const double *>(
+                                         out.children[1]->buffers[1])[0]}));
+    out.release(&out);
+    REQUIRE(out.release == nullptr);
+
+    // producers might not count the nulls, so the validity
+    // bitmap decides; the null in row 0 is skipped by the offset
+    const uint8_t validity[] = {0b11110};
+    const void *x0_nullable_buffers[] = {validity, x0.data()};
+    x0_array.null_count = -1;
+    x0_array.buffers = x0_nullable_buffers;
+    auto import_size = [&]() {
+        front<double, 2, unsigned> nullable_pf;
+        return import_arrow(nullable_pf, array, schema);
+    };
+    REQUIRE(import_size() == 3);
+    x0_array.null_count = 1;
+    REQUIRE(import_size() == 3);
+    const uint8_t validity_with_null[] = {0b10110};
+    x0_nullable_buffers[0] = validity_with_null;
+    x0_array.null_count = -1;
+    REQUIRE_THROWS_AS(import_size(), std::invalid_argument);
+    x0_nullable_buffers[0] = nullptr;
+    REQUIRE(import_size() == 3);
+    x0_array.buffers = x0_buffers;
+    x0_array.null_count = 0;
+
+    // archives export their ranks
+    archive<double, 2, unsigned> ar(10);
+    import_arrow(ar, array, schema);
+    REQUIRE(ar.size() == 4);
+    export_arrow(ar, &out, &out_schema);
+    REQUIRE(out_schema.n_children == 4);
+    REQUIRE(std::string(out_schema.children[3]->name) == "rank");
+    const auto *ranks =
+        static_cast<const uint64_t *>(out.children[3]->buffers[1]);
+    REQUIRE(std::count(ranks, ranks + out.length, uint64_t{1}) == 1);
+    out.release(&out);
+    out_schema.release(&out_schema);
+}
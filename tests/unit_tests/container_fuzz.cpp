@@ -6,12 +6,14 @@
 #ifdef BUILD_BOOST_TREE
 #include <pareto/boost_tree.h>
 #endif
+#include <pareto/disk_tree.h>
 #include <pareto/front.h>
 #include <pareto/implicit_tree.h>
 #include <pareto/kd_tree.h>
 #include <pareto/quad_tree.h>
 #include <pareto/r_star_tree.h>
 #include <pareto/r_tree.h>
+#include <thread>
 
 template <class TREE_TYPE>
 void test_tree() {
@@ -327,6 +329,22 @@ void test_tree() {
         REQUIRE(t.size() == s - 2);
     }
 
+    SECTION("Erasing with const iterator") {
+        insert_some();
+        // erase the element with the same key as another one
+        value_type first_element = *t.begin();
+        value_type same_key(first_element.first, first_element.second + 1);
+        t.insert(same_key);
+        size_t s = t.size();
+        const auto &ct = t;
+        auto cit = std::find(ct.begin(), ct.end(), same_key);
+        REQUIRE(cit != ct.end());
+        t.erase(cit);
+        REQUIRE(t.size() == s - 1);
+        REQUIRE(std::find(t.begin(), t.end(), same_key) == t.end());
+        REQUIRE(std::find(t.begin(), t.end(), first_element) != t.end());
+    }
+
     SECTION("Min/max values and elements") {
         insert_some();
         clear_some();
@@ -359,6 +377,63 @@ void test_tree() {
             REQUIRE(*tit == *t2it);
         }
     }
+
+    if constexpr (supports_hash_index_v<tree_type>) {
+        SECTION("Hash index") {
+            t.enable_hash_index();
+            REQUIRE(t.has_hash_index());
+            insert_some();
+            clear_some();
+            value_type d(key_type({5.2, 6.3, 1.3}), 7);
+            t.insert(d);
+            t.insert(d);
+            REQUIRE(t.count(d.first) == 2);
+
+            // compare with the box queries of a tree without the index
+            auto check_lookups = [&](tree_type &indexed) {
+                tree_type plain(indexed);
+                plain.disable_hash_index();
+                REQUIRE(indexed.size() == plain.size());
+                for (const auto &v : plain) {
+                    auto it = indexed.find(v.first);
+                    REQUIRE(it != indexed.end());
+                    REQUIRE(it->first == v.first);
+                    REQUIRE(indexed.count(v.first) == plain.count(v.first));
+                }
+                key_type missing({randn(), randn(), randn()});
+                REQUIRE(indexed.find(missing) == indexed.end());
+                REQUIRE_FALSE(indexed.contains(missing));
+                REQUIRE(indexed.count(missing) == 0);
+            };
+            check_lookups(t);
+
+            // erasing moves values between nodes
+            std::vector<key_type> keys;
+            for (const auto &v : t) {
+                keys.emplace_back(v.first);
+            }
+            for (size_t i = 0; i < keys.size(); i += 3) {
+                t.erase(keys[i]);
+                REQUIRE_FALSE(t.contains(keys[i]));
+            }
+            check_lookups(t);
+            t.erase(t.begin());
+            check_lookups(t);
+
+            // copies and moves keep their own index
+            tree_type t2(t);
+            REQUIRE(t2.has_hash_index());
+            check_lookups(t2);
+            tree_type t3(std::move(t2));
+            REQUIRE(t3.has_hash_index());
+            check_lookups(t3);
+            t2 = t3;
+            check_lookups(t2);
+
+            t.clear();
+            REQUIRE_FALSE(t.contains(keys.back()));
+        }
+    }
 }
 
 #ifdef implicit_TREETAG
@@ -414,4 +489,78 @@ TEST_CASE("R*-Tree") {
         test_tree<pareto::r_star_tree<double, 3, unsigned>>();
     }
 }
+#elif disk_TREETAG
+TEST_CASE("Disk-Tree") {
+    // small pages and buffer pool so that pages split and get evicted
+    using small_page_disk_tree =
+        pareto::disk_tree<double, 3, unsigned, std::less<double>,
+                          std::allocator<std::pair<const pareto::point<double, 3>, unsigned>>,
+                          pareto::disk_tree_defaults<256, 4>>;
+    SECTION("Compile Time Dimension") {
+        test_tree<small_page_disk_tree>();
+    }
+    SECTION("Internal Pages") {
+        // internal pages are pages too, so a large tree has
+        // several levels of pages and few pages in memory
+        small_page_disk_tree t;
+        std::vector<std::pair<pareto::point<double, 3>, unsigned>> v;
+        std::mt19937 g(0);
+        std::uniform_real_distribution<double> ud(0., 1.);
+        for (unsigned i = 0; i < 2000; ++i) {
+            v.emplace_back(pareto::point<double, 3>({ud(g), ud(g), ud(g)}), i);
+        }
+        for (size_t i = 0; i < 1000; ++i) {
+            t.insert(v[i]);
+        }
+        t.insert(v.begin() + 1000, v.end());
+        REQUIRE(t.size() == 2000);
+        REQUIRE(t.height() >= 2);
+        REQUIRE(t.buffer_pool_size() <= 4 + t.height() + 1);
+        for (const auto &[k, m] : v) {
+            auto it = t.find(k);
+            REQUIRE(it != t.end());
+            REQUIRE(it->second == m);
+        }
+        REQUIRE(std::distance(t.begin(), t.end()) == 2000);
+        for (size_t i = 0; i < 1500; ++i) {
+            REQUIRE(t.erase(v[i].first) == 1);
+        }
+        REQUIRE(t.size() == 500);
+        REQUIRE(std::distance(t.begin(), t.end()) == 500);
+        for (size_t i = 1500; i < v.size(); ++i) {
+            REQUIRE(t.contains(v[i].first));
+        }
+
+        // const queries from many threads share the buffer pool
+        const small_page_disk_tree &ct = t;
+        std::vector<size_t> found(4, 0);
+        std::vector<std::thread> readers;
+        for (size_t r = 0; r < found.size(); ++r) {
+            readers.emplace_back([&, r]() {
+                for (size_t i = 1500; i < v.size(); ++i) {
+                    found[r] += ct.find(v[i].first) != ct.end();
+                }
+                found[r] += std::distance(ct.begin(), ct.end());
+            });
+        }
+        for (auto &reader : readers) {
+            reader.join();
+        }
+        for (size_t n : found) {
+            REQUIRE(n == 1000);
+        }
+
+        // trees with options of their own
+        pareto::disk_tree_options options;
+        options.page_size = 512;
+        options.buffer_pool_pages = 8;
+        pareto::disk_tree<double, 3, unsigned> custom(options);
+        custom.insert(v.begin(), v.end());
+        REQUIRE(custom.options().page_size == 512);
+        REQUIRE(custom.page_capacity() > t.page_capacity());
+        REQUIRE(custom.size() == 2000);
+        REQUIRE(pareto::disk_tree<double, 3, unsigned>().options().page_size ==
+                4096);
+    }
+}
 #endif
\ No newline at end of file
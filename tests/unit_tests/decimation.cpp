@@ -0,0 +1,53 @@
+
+#include "../test_helpers.h"
+#include "../workloads.h"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <pareto/archive.h>
+
+TEST_CASE("Decimation") {
+    /*
+     * Decimated fronts keep the extremes of each grid cell,
+     * so every element is close to a kept element.
+     */
+    auto pf = create_shaped_front<2>(front_shape::concave, 20000);
+    auto lod = pf.decimate(100);
+    REQUIRE(!lod.empty());
+    REQUIRE(lod.size() <= 400);
+    REQUIRE(lod.ideal() == pf.ideal());
+    REQUIRE(lod.nadir() == pf.nadir());
+    for (const auto &[k, v] : lod) {
+        REQUIRE(pf.contains(k));
+    }
+    const double cell_diagonal = std::sqrt(2.) * 0.01;
+    for (const auto &[k, v] : pf) {
+        REQUIRE(k.distance(lod.find_nearest(k)->first) <=
+                cell_diagonal + 1e-9);
+    }
+    REQUIRE(pf.decimate(pf.size()).size() == pf.size());
+    REQUIRE(pf.decimate(0).size() == pf.size());
+
+    auto many = create_shaped_front<0>(front_shape::linear, 5000, 3);
+    auto many_lod = many.decimate(100);
+    REQUIRE(many_lod.size() < many.size());
+    REQUIRE(many_lod.dimensions() == 3);
+    REQUIRE(many_lod.ideal() == many.ideal());
+    for (const auto &[k, v] : many_lod) {
+        REQUIRE(many.contains(k));
+    }
+
+    pareto::archive<double, 2, unsigned> ar(10000);
+    for (const auto &[k, v] : pf) {
+        if (ar.size() < 9000) {
+            ar.insert({k + static_cast<double>(ar.size() % 3), v});
+        }
+    }
+    auto fronts = ar.decimate(100);
+    REQUIRE(fronts.size() == ar.size_fronts());
+    size_t decimated_size = 0;
+    for (const auto &f : fronts) {
+        REQUIRE(f.size() <= 400);
+        decimated_size += f.size();
+    }
+    REQUIRE(decimated_size < ar.size());
+}
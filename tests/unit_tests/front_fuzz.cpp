@@ -14,9 +14,13 @@
 #include <pareto/r_tree.h>
 #elif r_star_TREETAG
 #include <pareto/r_star_tree.h>
+#elif disk_TREETAG
+#include <pareto/disk_tree.h>
 #endif
 
 #include <pareto/front.h>
+#include <pareto/change_log.h>
+#include <pareto/transaction.h>
 
 template <size_t COMPILE_DIMENSION, typename Container>
 void test_front(size_t RUNTIME_DIMENSION = COMPILE_DIMENSION,
@@ -185,6 +189,19 @@ void test_front(size_t RUNTIME_DIMENSION = COMPILE_DIMENSION,
         REQUIRE_FALSE(pf.dominates(pf3));
         pf3.merge(pf2);
         REQUIRE_FALSE(pf2.dominates(pf3));
+        REQUIRE(pf3.check_invariants());
+        // merging is equivalent to inserting every element
+        front_type pf4 = pf;
+        pf4.insert(pf2.begin(), pf2.end());
+        front_type pf5 = pf2;
+        front_type pf6 = pf;
+        pf6.merge(std::move(pf5));
+        REQUIRE(pf5.empty());
+        REQUIRE(pf6.check_invariants());
+        REQUIRE(pf4.size() == pf6.size());
+        for (const auto &[k, v] : pf4) {
+            REQUIRE(pf6.contains(k));
+        }
         size_t pfs1 = pf.size();
         size_t pfs2 = pf2.size();
         pf.swap(pf2);
@@ -192,6 +209,115 @@ void test_front(size_t RUNTIME_DIMENSION = COMPILE_DIMENSION,
         REQUIRE(pfs2 == pf.size());
     }
 
+    SECTION("What-if insertion") {
+        auto pf = random_pareto_front();
+        const front_type original = pf;
+        point_type reference(test_dimension);
+        for (size_t i = 0; i < test_dimension; ++i) {
+            reference[i] = is_mini[i] ? 100. : -100.;
+        }
+        transaction<front_type> t(pf);
+        for (size_t i = 0; i < 20; ++i) {
+            auto v = random_value();
+            auto preview = pf.preview_insert(v.first);
+            const size_t previous_size = pf.size();
+            REQUIRE(t.insert(v) == preview.inserted);
+            if (preview.inserted) {
+                REQUIRE(pf.size() ==
+                        previous_size + 1 - preview.evicted.size());
+            } else {
+                REQUIRE(preview.rank == 1);
+                REQUIRE(pf.size() == previous_size);
+            }
+        }
+        if (!pf.empty()) {
+            REQUIRE(t.erase(pf.begin()->first) > 0);
+        }
+        REQUIRE_FALSE(t.empty());
+        t.rollback();
+        REQUIRE(t.empty());
+        REQUIRE(pf.check_invariants());
+        REQUIRE(pf.size() == original.size());
+        for (const auto &[k, v] : original) {
+            REQUIRE(pf.contains(k));
+        }
+        // hypervolume delta
+        if (test_dimension <= 5) {
+            for (size_t i = 0; i < 10; ++i) {
+                auto v = random_value();
+                auto preview = pf.preview_insert(v.first, reference);
+                front_type pf2 = pf;
+                pf2.insert(v);
+                REQUIRE(preview.hypervolume_delta ==
+                        Approx(pf2.hypervolume(reference) -
+                               pf.hypervolume(reference))
+                            .margin(1e-6));
+            }
+        }
+    }
+
+    SECTION("Change log") {
+        auto pf = random_pareto_front();
+        change_log<point_type> log;
+        pf.set_change_log(&log);
+        // replay the feed into a mirror of the front
+        std::vector<point_type> mirror(pf.size());
+        std::transform(pf.begin(), pf.end(), mirror.begin(),
+                       [](const value_type &v) { return v.first; });
+        for (size_t i = 0; i < 100; ++i) {
+            pf.insert(random_value());
+        }
+        pf.erase(pf.begin()->first);
+        front_type pf2({}, is_mini.begin(), is_mini.end());
+        for (size_t i = 0; i < 50; ++i) {
+            pf2.insert(random_value());
+        }
+        pf.merge(pf2);
+        REQUIRE_FALSE(log.empty());
+        for (const auto &c : log) {
+            if (c.type == change_type::insert) {
+                mirror.emplace_back(c.key);
+            } else if (c.type == change_type::erase) {
+                auto it = std::find(mirror.begin(), mirror.end(), c.key);
+                REQUIRE(it != mirror.end());
+                mirror.erase(it);
+            } else if (c.type == change_type::clear) {
+                mirror.clear();
+            }
+        }
+        REQUIRE(mirror.size() == pf.size());
+        for (const auto &k : mirror) {
+            REQUIRE(pf.contains(k));
+        }
+        // sequence numbers
+        const uint64_t next = log.next_sequence();
+        REQUIRE(log.since(next) == log.end());
+        log.trim(next - 1);
+        REQUIRE(log.size() == 1);
+        REQUIRE(log.begin()->sequence == next - 1);
+        pf.set_change_log(nullptr);
+        pf.clear();
+        REQUIRE(log.next_sequence() == next);
+    }
+
+    SECTION("Bulk insert") {
+        std::vector<value_type> values;
+        for (size_t i = 0; i < 300; ++i) {
+            values.emplace_back(random_value());
+        }
+        front_type pf({}, is_mini.begin(), is_mini.end());
+        for (const auto &v : values) {
+            pf.insert(v);
+        }
+        front_type pf2({}, is_mini.begin(), is_mini.end());
+        pf2.bulk_insert(values.begin(), values.begin() + 150);
+        pf2.bulk_insert(values.begin() + 150, values.end());
+        REQUIRE(pf2.size() == pf.size());
+        for (const auto &v : pf) {
+            REQUIRE(pf2.contains(v.first));
+        }
+    }
+
     SECTION("Queries") {
         auto pf = random_pareto_front();
         auto p = random_point();
@@ -574,4 +700,15 @@ TEST_CASE("R*-Front") {
         test_all_dimensions<false, pareto::r_star_tree>();
     }
 }
+#elif disk_TREETAG
+// small pages and buffer pool so that pages split and get evicted
+template <class K, size_t M, class T, class C, class A>
+using small_page_disk_tree =
+    pareto::disk_tree<K, M, T, C, A, pareto::disk_tree_defaults<256, 4>>;
+
+TEST_CASE("Disk-Front") {
+    SECTION("Compile Time Dimension") {
+        test_all_dimensions<false, small_page_disk_tree>();
+    }
+}
 #endif
\ No newline at end of file
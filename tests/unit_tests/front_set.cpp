@@ -0,0 +1,68 @@
+
+#include "../test_helpers.h"
+#include <catch2/catch.hpp>
+#include <pareto/archive.h>
+#include <pareto/disk_tree.h>
+#include <pareto/kd_tree.h>
+
+TEST_CASE("Key-only front") {
+    /*
+     * Fronts and archives of objective vectors only
+     * accept keys directly.
+     */
+    using namespace pareto;
+    front_set<double, 2> pf;
+    REQUIRE(pf.insert({0.2, 0.8}).second);
+    point<double, 2> p({0.5, 0.5});
+    REQUIRE(pf.insert(p).second);
+    REQUIRE(pf.insert(point<double, 2>({0.8, 0.2})).second);
+    REQUIRE_FALSE(pf.insert({0.6, 0.6}).second);
+    pf(0.1, 0.9);
+    REQUIRE(pf.size() == 4);
+    REQUIRE(pf.contains({0.5, 0.5}));
+    REQUIRE(pf.dominates(point<double, 2>({0.9, 0.9})));
+    REQUIRE(pf.hypervolume({1., 1.}) == Approx(0.38));
+
+    archive_set<double, 2> ar(10);
+    ar.insert({0.5, 0.5});
+    ar.insert({0.6, 0.6});
+    REQUIRE(ar.size() == 2);
+    REQUIRE(ar.size_fronts() == 2);
+
+    // elements only store their keys
+    static_assert(sizeof(front_set<double, 3>::value_type) ==
+                  sizeof(point<double, 3>));
+    static_assert(sizeof(front_set<double, 2>::value_type) ==
+                  sizeof(point<double, 2>));
+    static_assert(sizeof(archive_set<double, 3>::value_type) ==
+                  sizeof(point<double, 3>));
+    static_assert(
+        sizeof(front_set<double, 3, kd_tree<double, 3, no_value>>::value_type) ==
+        sizeof(point<double, 3>));
+    double sum = 0.;
+    for (const auto &[k, v] : pf) {
+        sum += k[0];
+        REQUIRE(v == no_value());
+    }
+    REQUIRE(sum == Approx(1.6));
+    std::pair<point<double, 2>, no_value> copy = *pf.begin();
+    REQUIRE(pf.contains(copy.first));
+    front_set<double, 2, kd_tree<double, 2, no_value>> kd_pf(pf.begin(),
+                                                             pf.end());
+    REQUIRE(kd_pf.size() == pf.size());
+    for (const auto &[k, v] : kd_pf) {
+        REQUIRE(pf.contains(k));
+    }
+    REQUIRE(kd_pf.erase(point<double, 2>({0.5, 0.5})) == 1);
+    REQUIRE(kd_pf.size() == 3);
+
+    // disk pages do not store the empty values
+    using key_only_tree = disk_tree<double, 3, no_value>;
+    using mapped_tree = disk_tree<double, 3, unsigned>;
+    REQUIRE(key_only_tree().page_capacity() >
+            mapped_tree().page_capacity());
+    front_set<double, 3, key_only_tree> disk_pf;
+    disk_pf.insert({1., 2., 3.});
+    disk_pf.insert({3., 2., 1.});
+    REQUIRE(disk_pf.size() == 2);
+}
@@ -0,0 +1,63 @@
+
+#include "../test_helpers.h"
+#include <catch2/catch.hpp>
+#include <pareto/kd_tree.h>
+
+TEST_CASE("Hash index") {
+    /*
+     * Exact lookups go through a hash index
+     * instead of a box query.
+     */
+    using namespace pareto;
+    using kd_front =
+        front<double, 2, unsigned, kd_tree<double, 2, unsigned>>;
+    kd_front pf;
+    pf.enable_hash_index();
+    REQUIRE(pf.has_hash_index());
+    pf(0.2, 0.8) = 1;
+    pf(0.5, 0.5) = 2;
+    pf(0.8, 0.2) = 3;
+    REQUIRE(pf.contains({0.5, 0.5}));
+    REQUIRE(pf.count({0.5, 0.5}) == 1);
+    REQUIRE(pf.at({0.8, 0.2}) == 3);
+    REQUIRE_FALSE(pf.dominates(point<double, 2>({0.5, 0.5})));
+    REQUIRE(pf.dominates(point<double, 2>({0.6, 0.6})));
+    // the new point dominates and removes (0.5, 0.5)
+    pf(0.4, 0.4) = 4;
+    REQUIRE_FALSE(pf.contains({0.5, 0.5}));
+    REQUIRE(pf.count({0.5, 0.5}) == 0);
+    REQUIRE(pf.erase({0.4, 0.4}) == 1);
+    REQUIRE(pf.size() == 2);
+
+    // merges rebuild the container and keep the index
+    kd_front other;
+    other(0.1, 0.95) = 5;
+    other(0.3, 0.3) = 6;
+    pf.merge(other);
+    REQUIRE(pf.has_hash_index());
+    REQUIRE(pf.contains({0.3, 0.3}));
+    REQUIRE(pf.count(point<double, 0>({0.3, 0.3})) == 1);
+    kd_front many;
+    for (unsigned i = 0; i < 8; ++i) {
+        const double x = i / 32.;
+        many(x, 0.25 - x) = i;
+    }
+    pf.merge(many);
+    REQUIRE(pf.has_hash_index());
+    REQUIRE(pf.count(point<double, 2>({0.125, 0.125})) == 1);
+    kd_front empty_pf;
+    empty_pf.enable_hash_index();
+    kd_front source;
+    source(0.5, 0.5) = 7;
+    empty_pf.merge(source);
+    REQUIRE(empty_pf.has_hash_index());
+    REQUIRE(empty_pf.at({0.5, 0.5}) == 7);
+
+    pf.disable_hash_index();
+    REQUIRE_FALSE(pf.has_hash_index());
+    REQUIRE(pf.contains({0.125, 0.125}));
+
+    // r-trees move elements between nodes, so they have no index
+    front<double, 2, unsigned> rf;
+    REQUIRE_FALSE(rf.has_hash_index());
+}
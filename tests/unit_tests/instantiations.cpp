@@ -0,0 +1,32 @@
+
+#include <catch2/catch.hpp>
+#include <pareto/instantiations.h>
+
+TEST_CASE("Explicit instantiations") {
+    /*
+     * With BUILD_PARETO_INSTANTIATIONS, this target links to
+     * pareto_instantiations, and these fronts and archives are
+     * extern templates compiled in the library.
+     */
+    using namespace pareto;
+    front<double, 3, uint64_t> pf;
+    pf(0.2, 0.8, 0.5) = 1;
+    pf(0.8, 0.2, 0.5) = 2;
+    pf(0.5, 0.5, 0.5) = 3;
+    REQUIRE(pf.size() == 3);
+    REQUIRE(pf.dominates(point<double, 3>({0.9, 0.9, 0.9})));
+    REQUIRE(pf.find_nearest({0.5, 0.5, 0.4})->second == 3);
+    REQUIRE(pf.hypervolume({1., 1., 1.}) > 0.);
+    REQUIRE(pf.erase({0.5, 0.5, 0.5}) == 1);
+
+    archive<double, 3, uint64_t> ar(10);
+    ar(0.5, 0.5, 0.5) = 1;
+    ar(0.6, 0.6, 0.6) = 2;
+    REQUIRE(ar.size() == 2);
+    REQUIRE(ar.size_fronts() == 2);
+    size_t n = 0;
+    for (auto it = ar.begin(); it != ar.end(); ++it) {
+        ++n;
+    }
+    REQUIRE(n == 2);
+}
@@ -0,0 +1,57 @@
+
+#include "../test_helpers.h"
+#include <catch2/catch.hpp>
+#include <pareto/matrix_front.h>
+
+TEST_CASE("Matrix view") {
+    /*
+     * A front can index the rows of an external matrix
+     * without copying them.
+     */
+    using namespace pareto;
+    // rows with 3 columns, where the last column is not an objective
+    const size_t n = 2000;
+    std::vector<double> matrix(n * 3);
+    std::generate(matrix.begin(), matrix.end(), [] { return randu(); });
+    matrix[3 * 5] = matrix[3 * 7];
+    matrix[3 * 5 + 1] = matrix[3 * 7 + 1];
+
+    front<double, 2, size_t> pf;
+    for (size_t i = 0; i < n; ++i) {
+        pf.insert(std::make_pair(
+            point<double, 2>({matrix[3 * i], matrix[3 * i + 1]}), i));
+    }
+    const auto mf = make_matrix_front<double, 2>(matrix.data(), n, 2, 3);
+    REQUIRE(mf.size() == pf.size());
+    for (const auto &[k, v] : pf) {
+        REQUIRE(mf.contains(k));
+        REQUIRE(mf.at(k) == v);
+    }
+    REQUIRE(mf.ideal() == pf.ideal());
+    REQUIRE(mf.nadir() == pf.nadir());
+    REQUIRE(mf.hypervolume({1., 1.}) == Approx(pf.hypervolume({1., 1.})));
+    const point<double, 2> p({0.5, 0.5});
+    REQUIRE(mf.dominates(p) == pf.dominates(p));
+    REQUIRE(mf.find_nearest(p)->first == pf.find_nearest(p)->first);
+    REQUIRE(std::distance(mf.find_nearest(p, 5), mf.end()) == 5);
+    REQUIRE(std::distance(mf.find_intersection({0.2, 0.}, {0.4, 1.}),
+                          mf.end()) ==
+            std::distance(pf.find_intersection({0.2, 0.}, {0.4, 1.}),
+                          pf.end()));
+    REQUIRE(std::distance(mf.find_dominated({0.9, 0.9}), mf.end()) ==
+            std::distance(pf.find_dominated({0.9, 0.9}), pf.end()));
+
+    // indicators between two views
+    const auto all = make_matrix_front<double, 0>(matrix.data(), n, 2, 3,
+                                                  {true, true}, false);
+    REQUIRE(all.size() == n);
+    REQUIRE(all.dimensions() == 2);
+    const auto reference =
+        make_matrix_front<double, 0>(matrix.data(), n / 2, 2, 3);
+    const auto target = make_matrix_front<double, 0>(
+        matrix.data() + 3 * (n / 2), n / 2, 2, 3);
+    REQUIRE(target.igd(reference) >= 0.);
+    REQUIRE(target.gd(reference) == Approx(reference.igd(target)));
+    REQUIRE_THROWS_AS((matrix_tree<double, 3>(matrix.data(), n, 2)),
+                      std::invalid_argument);
+}
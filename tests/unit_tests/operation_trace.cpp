@@ -0,0 +1,135 @@
+
+#include "../test_helpers.h"
+#include "../workloads.h"
+#include <catch2/catch.hpp>
+#include <pareto/archive.h>
+#include <pareto/kd_tree.h>
+#include <pareto/operation_trace.h>
+#include <sstream>
+
+TEST_CASE("Operation trace") {
+    using namespace pareto;
+    std::stringstream trace;
+    operation_trace_writer writer(trace);
+    front<double, 3, unsigned> pf;
+    pf(0.5, 0.5, 0.5) = 1;
+    // attaching the writer records a clear and the current elements
+    pf.set_operation_trace(&writer);
+    REQUIRE(pf.get_operation_trace() == &writer);
+    REQUIRE(writer.size() == 2);
+    std::vector<double> results;
+    std::mt19937 g(static_cast<std::mt19937::result_type>(fixed_seed()));
+    for (size_t i = 0; i < 200; ++i) {
+        auto p = shaped_query_point<point<double, 3>>(front_shape::concave,
+                                                      3, g);
+        switch (i % 5) {
+        case 0:
+        case 1:
+            results.emplace_back(pf.insert({p, 0}).second);
+            break;
+        case 2:
+            results.emplace_back(pf.dominates(p));
+            break;
+        case 3:
+            results.emplace_back(pf.find_nearest(p, 2) != pf.end());
+            break;
+        default:
+            auto it = pf.find_nearest(p);
+            results.emplace_back(it != pf.end());
+            if (it != pf.end()) {
+                results.emplace_back(
+                    static_cast<double>(pf.erase(it->first)));
+            }
+            break;
+        }
+    }
+    pf.set_operation_trace(nullptr);
+    const auto recorded = pf;
+    pf.insert({{0., 0., 0.}, 0});
+    // nested operations (insert calls dominates) are not recorded
+    REQUIRE(writer.size() == 2 + results.size());
+
+    // replay the trace in a front with another container
+    trace.seekg(0);
+    operation_trace_reader reader(trace);
+    front<double, 3, unsigned, kd_tree<double, 3, unsigned>> replayed;
+    std::vector<double> replayed_results;
+    trace_record r;
+    for (size_t i = 0; reader.next(r); ++i) {
+        const double result = replay(r, replayed);
+        if (i >= 2) {
+            replayed_results.emplace_back(result);
+        }
+    }
+    REQUIRE(replayed_results == results);
+    REQUIRE(replayed.size() == recorded.size());
+    for (const auto &[k, v] : recorded) {
+        REQUIRE(replayed.contains(k));
+    }
+
+    // erasing through an iterator removes one of the elements
+    // with the same key in the replay too
+    std::stringstream duplicate_trace;
+    operation_trace_writer duplicate_writer(duplicate_trace);
+    front<double, 2, unsigned> duplicates;
+    duplicates.set_operation_trace(&duplicate_writer);
+    duplicates.insert({{0.5, 0.5}, 1});
+    duplicates.insert({{0.5, 0.5}, 2});
+    duplicates.insert({{0.25, 0.75}, 3});
+    REQUIRE(duplicates.size() == 3);
+    duplicates.erase(duplicates.find(point<double, 2>{0.5, 0.5}));
+    REQUIRE(duplicates.size() == 2);
+    duplicates.set_operation_trace(nullptr);
+    duplicate_trace.seekg(0);
+    operation_trace_reader duplicate_reader(duplicate_trace);
+    front<double, 2, unsigned, kd_tree<double, 2, unsigned>>
+        replayed_duplicates;
+    std::vector<trace_record> duplicate_records =
+        duplicate_reader.read_all();
+    REQUIRE(duplicate_records.back().op == trace_opcode::erase_one);
+    for (const trace_record &dr : duplicate_records) {
+        replay(dr, replayed_duplicates);
+    }
+    REQUIRE(replayed_duplicates.size() == duplicates.size());
+    REQUIRE(replayed_duplicates.contains(point<double, 2>{0.5, 0.5}));
+
+    // archives record their capacity
+    std::stringstream archive_trace;
+    operation_trace_writer archive_writer(archive_trace);
+    archive<double, 2, unsigned> ar(5);
+    ar.set_operation_trace(&archive_writer);
+    for (size_t i = 0; i < 20; ++i) {
+        ar.insert({random_point<2, kd_tree<double, 2, unsigned>>(), 0});
+    }
+    ar.resize(3);
+    ar.set_operation_trace(nullptr);
+    archive_trace.seekg(0);
+    operation_trace_reader archive_reader(archive_trace);
+    archive<double, 2, unsigned, kd_tree<double, 2, unsigned>> replayed_ar;
+    for (const trace_record &ar_r : archive_reader.read_all()) {
+        replay(ar_r, replayed_ar);
+    }
+    REQUIRE(replayed_ar.capacity() == 3);
+    REQUIRE(replayed_ar.size() == ar.size());
+    REQUIRE(replayed_ar.size_fronts() == ar.size_fronts());
+    for (const auto &[k, v] : ar) {
+        REQUIRE(replayed_ar.contains(k));
+    }
+
+    // keys are little-endian doubles on every machine
+    std::stringstream byte_trace;
+    operation_trace_writer byte_writer(byte_trace);
+    byte_writer.record(trace_opcode::insert, point<double, 1>{1.0});
+    const std::string bytes = byte_trace.str();
+    REQUIRE(bytes.size() == 5 + 3 + 8);
+    REQUIRE(bytes.substr(8) == std::string("\0\0\0\0\0\0\xF0\x3F", 8));
+
+    // bad traces throw
+    std::stringstream bad("not a trace");
+    REQUIRE_THROWS_AS(operation_trace_reader(bad), std::runtime_error);
+    std::string truncated = archive_trace.str();
+    truncated.resize(truncated.size() - 3);
+    std::stringstream truncated_trace(truncated);
+    operation_trace_reader truncated_reader(truncated_trace);
+    REQUIRE_THROWS_AS(truncated_reader.read_all(), std::runtime_error);
+}
@@ -0,0 +1,57 @@
+
+#include "../test_helpers.h"
+#include "../workloads.h"
+#include <catch2/catch.hpp>
+#include <pareto/archive.h>
+
+TEST_CASE("Deterministic random numbers") {
+    /*
+     * Randomized algorithms use the generator of each container,
+     * so the same seed gives the same results for any number of
+     * threads. Each hypervolume estimate uses a new stream.
+     */
+    pareto::counter_generator g(42);
+    pareto::counter_generator g2(42);
+    REQUIRE(g() == g2());
+    g.discard(10);
+    for (size_t i = 0; i < 10; ++i) {
+        g2();
+    }
+    REQUIRE(g == g2);
+    REQUIRE(g.split(3)() == g2.split(3)());
+    REQUIRE(g.split(3)() != g.split(4)());
+
+    auto pf = create_shaped_front<2>(front_shape::concave, 2000);
+    const auto reference = pf.nadir();
+    const double exact = pf.hypervolume(reference);
+    pf.seed(7);
+    const double hv1 = pf.hypervolume(50000, reference, 1);
+    const double hv2 = pf.hypervolume(50000, reference, 1);
+    REQUIRE(hv1 != hv2);
+    REQUIRE(hv1 == Approx(exact).epsilon(0.02));
+    REQUIRE(hv2 == Approx(exact).epsilon(0.02));
+    pf.seed(7);
+    REQUIRE(hv1 == pf.hypervolume(50000, reference, 4));
+    auto copy = pf;
+    REQUIRE(copy.hypervolume(50000, reference) == hv2);
+    REQUIRE(pf.hypervolume(50000, reference) == hv2);
+    copy.seed(8);
+    REQUIRE(copy.hypervolume(50000, reference) != hv1);
+
+    pareto::archive<double, 2, unsigned> hv_archive(pf.size(), pf.begin(),
+                                                   pf.end());
+    REQUIRE(hv_archive.hypervolume(1000, reference) !=
+            hv_archive.hypervolume(1000, reference));
+
+    auto pruned = [&](uint64_t seed) {
+        pareto::archive<double, 2, unsigned> ar(2000);
+        ar.seed(seed);
+        for (const auto &[k, v] : pf) {
+            ar.insert({k + static_cast<double>(v % 2), v});
+        }
+        ar.resize(100);
+        return std::vector<std::pair<pareto::point<double, 2>, unsigned>>(
+            ar.begin(), ar.end());
+    };
+    REQUIRE(pruned(5) == pruned(5));
+}
@@ -0,0 +1,187 @@
+
+#include "../test_helpers.h"
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <mutex>
+#include <pareto/replicated_front.h>
+#include <pareto/sharded_front.h>
+#include <set>
+#include <thread>
+
+template <size_t COMPILE_DIMENSION>
+void test_sharded_front(size_t number_of_shards, const std::vector<bool> &is_mini,
+                        bool force_parallel) {
+    using namespace pareto;
+    using sharded_front_type = sharded_front<double, COMPILE_DIMENSION, unsigned>;
+    using front_type = typename sharded_front_type::front_type;
+    using value_type = typename front_type::value_type;
+
+    // values for each worker
+    std::vector<std::vector<value_type>> values(number_of_shards);
+    for (auto &v : values) {
+        v = create_vector_with_values<COMPILE_DIMENSION, typename front_type::container_type>(300);
+    }
+
+    // workers insert in their shards concurrently
+    sharded_front_type sf(number_of_shards, is_mini.begin(), is_mini.end());
+    REQUIRE(sf.number_of_shards() == number_of_shards);
+    REQUIRE(sf.empty());
+    if (force_parallel) {
+        // use the workers even on machines with one hardware thread
+        sf.parallel_threshold(0);
+        sf.max_threads(4);
+    } else {
+        sf.max_threads(1);
+    }
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < number_of_shards; ++i) {
+        workers.emplace_back([&sf, &values, i]() {
+            for (const auto &v : values[i]) {
+                sf.insert(i, v);
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    REQUIRE_FALSE(sf.empty());
+
+    // reference front with all values
+    front_type reference({}, is_mini.begin(), is_mini.end());
+    for (const auto &v : values) {
+        reference.insert(v.begin(), v.end());
+    }
+
+    SECTION("Consolidate") {
+        front_type global = sf.consolidate();
+        REQUIRE(global.check_invariants());
+        REQUIRE(global.size() == reference.size());
+        for (const auto &[k, v] : reference) {
+            REQUIRE(global.contains(k));
+        }
+        // shards are not modified
+        REQUIRE(sf.total_shard_sizes() >= global.size());
+    }
+
+    SECTION("NUMA placement") {
+        // rebinding a shard keeps its elements
+        const size_t shard_size = sf.shard(0).size();
+        sf.bind_shard(0, 0);
+        REQUIRE(sf.shard(0).size() == shard_size);
+        REQUIRE(sf.consolidate().size() == reference.size());
+        // replicas are copies of the reference front
+        replicated_front<double, COMPILE_DIMENSION, unsigned> replicated(reference, 2);
+        REQUIRE(replicated.number_of_replicas() == 2);
+        REQUIRE(replicated.local().size() == reference.size());
+        REQUIRE(replicated.replica(1).size() == reference.size());
+        auto p = random_point<COMPILE_DIMENSION, typename front_type::container_type>();
+        REQUIRE(replicated.local().dominates(p) == reference.dominates(p));
+    }
+
+    SECTION("Global iteration") {
+        size_t counter = 0;
+        for (const auto &[k, v] : sf) {
+            REQUIRE(reference.contains(k));
+            ++counter;
+        }
+        REQUIRE(counter == reference.size());
+        // elements come from the shard the iterator reports
+        for (auto it = sf.begin(); it != sf.end(); ++it) {
+            REQUIRE(sf.shard(it.shard()).contains(it->first));
+        }
+    }
+
+    SECTION("Cached global view") {
+        const auto &csf = sf;
+        if (csf.begin() != csf.end()) {
+            // the merge is reused until a shard changes
+            REQUIRE(&*csf.begin() == &*csf.begin());
+            auto best = reference.begin()->first;
+            for (size_t d = 0; d < best.dimensions(); ++d) {
+                best[d] = is_mini[d] ? -1e10 : 1e10;
+            }
+            sf.insert(0, value_type(best, 0));
+            size_t counter = 0;
+            for (auto it = csf.begin(); it != csf.end(); ++it) {
+                REQUIRE(it->first == best);
+                ++counter;
+            }
+            REQUIRE(counter == 1);
+        }
+    }
+
+    SECTION("Global queries") {
+        for (size_t i = 0; i < 100; ++i) {
+            auto p = random_point<COMPILE_DIMENSION, typename front_type::container_type>();
+            REQUIRE(sf.dominates(p) == reference.dominates(p));
+            auto it = sf.find_nearest(p);
+            REQUIRE(it != sf.end());
+            auto ref_it = reference.find_nearest(p);
+            REQUIRE(p.distance(it->first) == Approx(p.distance(ref_it->first)));
+        }
+    }
+}
+
+TEST_CASE("Sharded Front") {
+    SECTION("2 dimensions") {
+        test_sharded_front<2>(4, {true, false}, false);
+    }
+    SECTION("3 dimensions") {
+        test_sharded_front<3>(3, {true, true, true}, false);
+    }
+    SECTION("Single shard") {
+        test_sharded_front<2>(1, {true, true}, false);
+    }
+    SECTION("Parallel 2 dimensions") {
+        test_sharded_front<2>(4, {true, false}, true);
+    }
+    SECTION("Parallel 3 dimensions") {
+        test_sharded_front<3>(3, {true, true, true}, true);
+    }
+}
+
+TEST_CASE("Parallel For") {
+    using namespace pareto;
+    SECTION("Workers") {
+        // the caller runs the first block and the workers run the others
+        std::mutex ids_mutex;
+        std::set<std::thread::id> ids;
+        std::vector<size_t> visits(100, 0);
+        parallel_for(
+            visits.size(),
+            [&](size_t i) {
+                ++visits[i];
+                std::lock_guard<std::mutex> lock(ids_mutex);
+                ids.insert(std::this_thread::get_id());
+            },
+            4);
+        REQUIRE(ids.size() > 1);
+        REQUIRE(default_thread_pool().size() >= 3);
+        REQUIRE(std::all_of(visits.begin(), visits.end(),
+                            [](size_t v) { return v == 1; }));
+    }
+
+    SECTION("Nested calls") {
+        std::atomic<size_t> counter{0};
+        parallel_for(
+            4,
+            [&](size_t) {
+                parallel_for(
+                    10, [&](size_t) { ++counter; }, 4);
+            },
+            4);
+        REQUIRE(counter == 40);
+    }
+
+    SECTION("Exceptions") {
+        REQUIRE_THROWS_AS(parallel_for(
+                              8,
+                              [](size_t i) {
+                                  if (i == 5) {
+                                      throw std::runtime_error("task 5");
+                                  }
+                              },
+                              4),
+                          std::runtime_error);
+    }
+}
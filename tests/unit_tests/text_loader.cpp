@@ -0,0 +1,53 @@
+
+#include "../test_helpers.h"
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <pareto/archive.h>
+#include <pareto/text_loader.h>
+
+TEST_CASE("Text loader") {
+    /*
+     * Reference fronts and CSV files are loaded with one
+     * point per line.
+     */
+    using namespace pareto;
+    const std::string text = "# reference front\n"
+                             "f1, f2\n"
+                             "0.1, 0.9\n"
+                             "\n"
+                             "0.5\t+5e-1\r\n"
+                             "% comment\n"
+                             "0.6;0.6\n"
+                             "0.9 0.1";
+    // many small chunks in parallel
+    text_loader_options options;
+    options.number_of_threads = 4;
+    options.min_chunk_size = 1;
+    auto values = parse_text_points<double, 2, unsigned>(text, options);
+    REQUIRE(values.size() == 4);
+    REQUIRE(values[1].first == point<double, 2>({0.5, 0.5}));
+    REQUIRE(values[3].second == 3);
+    REQUIRE(parse_text_points<double, 0>(text).front().first.dimensions() ==
+            2);
+    REQUIRE_THROWS_AS((parse_text_points<double, 3>(text)),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS((parse_text_points<double, 2>("0.1 0.9\n0.5 x\n")),
+                      std::invalid_argument);
+
+    // files go through the bulk loader
+    const auto path =
+        std::filesystem::temp_directory_path() / "pareto_text_loader.pf";
+    {
+        std::ofstream file(path);
+        file << text;
+    }
+    front<double, 2, unsigned> pf;
+    REQUIRE(load_text(pf, path, options) == 3);
+    REQUIRE_FALSE(pf.contains({0.6, 0.6}));
+    REQUIRE(pf.at({0.9, 0.1}) == 3);
+    archive<double, 2, unsigned> ar(10);
+    REQUIRE(load_text(ar, path) == 4);
+    REQUIRE(ar.size_fronts() == 2);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,108 @@
+
+#include "../test_helpers.h"
+#include <array>
+#include <catch2/catch.hpp>
+#include <limits>
+#include <pareto/archive.h>
+#include <sstream>
+
+TEST_CASE("Tracing hooks") {
+    /*
+     * Hooks are only called when the library
+     * is built with BUILD_PARETO_WITH_TRACING.
+     */
+    using namespace pareto;
+    struct counting_hooks : public trace_hooks {
+        void begin(traced_operation op, size_t) override {
+            ++begins[static_cast<size_t>(op)];
+        }
+        void end(traced_operation op, size_t,
+                 std::chrono::nanoseconds) override {
+            ++ends[static_cast<size_t>(op)];
+        }
+        std::array<size_t, number_of_traced_operations> begins{};
+        std::array<size_t, number_of_traced_operations> ends{};
+    };
+    counting_hooks hooks;
+    REQUIRE(set_trace_hooks(&hooks) == nullptr);
+    REQUIRE(get_trace_hooks() == &hooks);
+    front<double, 2, unsigned> pf;
+    pf(0.2, 0.8) = 1;
+    pf(0.8, 0.2) = 2;
+    // (0.4, 0.4) erases (0.5, 0.5)
+    pf(0.5, 0.5) = 3;
+    pf(0.4, 0.4) = 4;
+    pf.erase({0.2, 0.8});
+    auto it = pf.find_nearest({0.5, 0.5}, 1);
+    REQUIRE(it != pf.end());
+    REQUIRE(set_trace_hooks(nullptr) == &hooks);
+    pf(0.1, 0.9) = 5;
+    const auto insert_idx = static_cast<size_t>(traced_operation::insert);
+    const auto erase_idx = static_cast<size_t>(traced_operation::erase);
+    const auto nearest_idx =
+        static_cast<size_t>(traced_operation::find_nearest);
+    const auto dominates_idx =
+        static_cast<size_t>(traced_operation::dominates);
+    if constexpr (tracing_enabled) {
+        // the dominance checks and erasures inside insert
+        // are part of the insert operation
+        REQUIRE(hooks.begins[insert_idx] == 4);
+        REQUIRE(hooks.begins[erase_idx] == 1);
+        REQUIRE(hooks.begins[nearest_idx] == 1);
+        REQUIRE(hooks.begins[dominates_idx] == 0);
+    } else {
+        REQUIRE(hooks.begins[insert_idx] == 0);
+    }
+    REQUIRE(hooks.begins == hooks.ends);
+
+    // archives report their operations and not the
+    // operations on their fronts
+    hooks.begins = {};
+    hooks.ends = {};
+    set_trace_hooks(&hooks);
+    archive<double, 2, unsigned> ar(10);
+    ar(0.2, 0.8) = 1;
+    ar(0.5, 0.5) = 2;
+    ar(0.6, 0.6) = 3;
+    REQUIRE(ar.dominates(point<double, 2>({0.7, 0.7})));
+    set_trace_hooks(nullptr);
+    if constexpr (tracing_enabled) {
+        REQUIRE(hooks.begins[insert_idx] == 3);
+        REQUIRE(hooks.begins[dominates_idx] == 1);
+        REQUIRE(hooks.begins[erase_idx] == 0);
+    }
+    REQUIRE(hooks.begins == hooks.ends);
+
+    // The recorder can also be used directly
+    latency_recorder recorder;
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        recorder.end(traced_operation::insert, 0,
+                     std::chrono::nanoseconds(i * 1000));
+    }
+    const latency_histogram &h =
+        recorder.histogram(traced_operation::insert);
+    REQUIRE(h.count() == 1000);
+    REQUIRE(h.min() == 1000);
+    REQUIRE(h.max() == 1000000);
+    REQUIRE(h.mean() == Approx(500500.));
+    REQUIRE(h.percentile(50.) == Approx(500000.).epsilon(0.04));
+    REQUIRE(h.percentile(99.) == Approx(990000.).epsilon(0.04));
+    REQUIRE(h.percentile(100.) == 1000000);
+    REQUIRE(recorder.histogram(traced_operation::erase).count() == 0);
+    std::stringstream ss;
+    ss << recorder;
+    REQUIRE(ss.str().find("insert") != std::string::npos);
+    REQUIRE(ss.str().find("erase") == std::string::npos);
+    recorder.reset();
+    REQUIRE(h.count() == 0);
+
+    // Buckets have bounded relative error
+    for (uint64_t v : {uint64_t(0), uint64_t(63), uint64_t(64),
+                       uint64_t(1000), uint64_t(123456789),
+                       std::numeric_limits<uint64_t>::max()}) {
+        const size_t i = latency_histogram::bucket_index(v);
+        REQUIRE(i < latency_histogram::number_of_buckets);
+        REQUIRE(latency_histogram::lowest_equivalent_value(i) <= v);
+        REQUIRE(v <= latency_histogram::highest_equivalent_value(i));
+    }
+}
@@ -0,0 +1,48 @@
+
+#include "../test_helpers.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("Work stats") {
+    /*
+     * Counters are only updated when the library
+     * is built with BUILD_PARETO_WITH_STATS.
+     */
+    using namespace pareto;
+    front<double, 2, unsigned> pf;
+    reset_work_stats();
+    for (size_t i = 0; i < 100; ++i) {
+        const double x = static_cast<double>(i) / 100.;
+        pf(x, 1. - x) = static_cast<unsigned>(i);
+    }
+    work_stats s = get_work_stats();
+    if constexpr (work_stats_enabled) {
+        REQUIRE(s.allocations > 0);
+        REQUIRE(s.node_splits > 0);
+        REQUIRE(s.dominance_tests > 0);
+    } else {
+        REQUIRE(s.allocations == 0);
+        REQUIRE(s.dominance_tests == 0);
+    }
+
+    reset_work_stats();
+    auto it = pf.find_nearest({0.5, 0.5}, 3);
+    REQUIRE(std::distance(it, pf.end()) == 3);
+    s = get_work_stats();
+    if constexpr (work_stats_enabled) {
+        REQUIRE(s.nodes_visited > 0);
+        REQUIRE(s.heap_pops > 0);
+        REQUIRE(s.predicates_evaluated[3] > 0);
+        REQUIRE(s.total_predicates_evaluated() >=
+                s.predicates_evaluated[3]);
+    } else {
+        REQUIRE(s.nodes_visited == 0);
+        REQUIRE(s.total_predicates_evaluated() == 0);
+    }
+
+    reset_work_stats();
+    REQUIRE(get_work_stats().nodes_visited == 0);
+    work_stats total;
+    total += s;
+    total += s;
+    REQUIRE(total.nodes_visited == 2 * s.nodes_visited);
+}
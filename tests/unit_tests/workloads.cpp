@@ -0,0 +1,36 @@
+
+#include "../test_helpers.h"
+#include "../workloads.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("Workload generators") {
+    /*
+     * Shaped fronts have exactly n points and
+     * only depend on the shape, size, and seed.
+     */
+    for (front_shape shape : all_front_shapes) {
+        if (shape == front_shape::cloud) {
+            continue;
+        }
+        auto pf = create_shaped_front<3>(shape, 200);
+        REQUIRE(pf.size() == 200);
+        REQUIRE(pf == create_shaped_front<3>(shape, 200));
+        REQUIRE(pf != create_shaped_front<3>(shape, 200, 3, 42));
+        auto many = create_shaped_front<0>(shape, 100, 9);
+        REQUIRE(many.size() == 100);
+        REQUIRE(many.dimensions() == 9);
+        auto v = create_shaped_values<decltype(pf)>(shape, 50);
+        REQUIRE(v.size() == 50);
+        pareto::front<double, 3, unsigned> from_values(v.begin(),
+                                                       v.end());
+        REQUIRE(from_values.size() == 50);
+    }
+    auto pf = create_shaped_front<2>(front_shape::linear, 100);
+    for (const auto &[k, v] : pf) {
+        REQUIRE(k[0] + k[1] == Approx(1.));
+    }
+    pf = create_shaped_front<2>(front_shape::concave, 100);
+    for (const auto &[k, v] : pf) {
+        REQUIRE(k[0] * k[0] + k[1] * k[1] == Approx(1.));
+    }
+}
@@ -0,0 +1,238 @@
+//
+// Workload generators for tests and benchmarks
+//
+
+#ifndef PARETO_WORKLOADS_H
+#define PARETO_WORKLOADS_H
+
+#include <array>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <pareto/front.h>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "test_helpers.h"
+
+/// \brief Shapes of the fronts we generate for benchmarks
+/// Inserting random points from a normal distribution, as
+/// create_test_pareto does, generates a small front in a random cloud.
+/// Real optimization fronts look more like the fronts of the ZDT, DTLZ,
+/// and WFG test problems. These shapes follow these problems:
+/// * cloud: non-dominated points of a normal cloud (the old workload)
+/// * linear: the simplex sum(f) = 1 (DTLZ1)
+/// * concave: the positive orthant of the unit sphere (DTLZ2, WFG4)
+/// * convex: 1 minus the concave front (ZDT1, WFG2)
+/// * disconnected: 2^(m-1) separate regions (ZDT3, DTLZ7)
+/// * degenerate: a curve in any number of dimensions (DTLZ5, WFG3)
+/// All shapes except cloud work for any number of objectives, so the
+/// same generators give us many-objective fronts.
+enum class front_shape { cloud, linear, concave, convex, disconnected, degenerate };
+
+constexpr std::array<front_shape, 6> all_front_shapes = {
+    front_shape::cloud,        front_shape::linear,
+    front_shape::concave,      front_shape::convex,
+    front_shape::disconnected, front_shape::degenerate};
+
+inline std::string to_string(front_shape s) {
+    switch (s) {
+    case front_shape::cloud:
+        return "cloud";
+    case front_shape::linear:
+        return "linear";
+    case front_shape::concave:
+        return "concave";
+    case front_shape::convex:
+        return "convex";
+    case front_shape::disconnected:
+        return "disconnected";
+    case front_shape::degenerate:
+        return "degenerate";
+    }
+    return "unknown";
+}
+
+/// \brief Generate a point on the front of a given shape
+/// \param s Front shape
+/// \param m Number of objectives
+/// \param g Random number generator
+template <class POINT_T>
+POINT_T shaped_point(front_shape s, size_t m, std::mt19937 &g) {
+    POINT_T p(m);
+    std::uniform_real_distribution<double> ud(0., 1.);
+    std::normal_distribution<double> nd(0., 1.);
+    switch (s) {
+    case front_shape::cloud: {
+        for (size_t i = 0; i < m; ++i) {
+            p[i] = nd(g);
+        }
+        break;
+    }
+    case front_shape::linear: {
+        // uniform on the simplex from normalized exponential spacings
+        double sum = 0.;
+        for (size_t i = 0; i < m; ++i) {
+            p[i] = -std::log(1. - ud(g));
+            sum += p[i];
+        }
+        for (size_t i = 0; i < m; ++i) {
+            p[i] /= sum;
+        }
+        break;
+    }
+    case front_shape::concave:
+    case front_shape::convex: {
+        // uniform on the unit sphere from normalized gaussian vectors
+        double sum_of_squares = 0.;
+        for (size_t i = 0; i < m; ++i) {
+            p[i] = std::abs(nd(g));
+            sum_of_squares += p[i] * p[i];
+        }
+        const double norm = std::sqrt(sum_of_squares);
+        for (size_t i = 0; i < m; ++i) {
+            p[i] /= norm;
+            if (s == front_shape::convex) {
+                p[i] = 1. - p[i];
+            }
+        }
+        break;
+    }
+    case front_shape::disconnected: {
+        // DTLZ7 with g = 1. Its front has two intervals per position
+        // variable, where h(x) = x / 2 * (1 + sin(3 pi x)) is increasing
+        // and the value of h at the start of the second interval is
+        // the value of h at the end of the first interval.
+        constexpr double first_end = 0.2514118360;
+        constexpr double second_begin = 0.6316265307;
+        constexpr double second_end = 0.8594008566;
+        constexpr double total_length =
+            first_end + (second_end - second_begin);
+        const double pi = std::acos(-1.);
+        double h = static_cast<double>(m);
+        for (size_t i = 0; i + 1 < m; ++i) {
+            double x = ud(g) * total_length;
+            if (x > first_end) {
+                x += second_begin - first_end;
+            }
+            p[i] = x;
+            h -= x / 2. * (1. + std::sin(3. * pi * x));
+        }
+        p[m - 1] = 2. * h;
+        break;
+    }
+    case front_shape::degenerate: {
+        // all points are on a quarter circle, as in DTLZ5
+        const double pi = std::acos(-1.);
+        const double theta = ud(g) * pi / 2.;
+        p[0] = std::cos(theta);
+        const double rest =
+            m > 1 ? std::sin(theta) / std::sqrt(static_cast<double>(m - 1))
+                  : 0.;
+        for (size_t i = 1; i < m; ++i) {
+            p[i] = rest;
+        }
+        break;
+    }
+    }
+    return p;
+}
+
+/// \brief Generate a query point close to the front of a given shape
+/// The points are perturbed so that some of them are dominated by
+/// the front and some of them are not.
+template <class POINT_T>
+POINT_T shaped_query_point(front_shape s, size_t m, std::mt19937 &g) {
+    POINT_T p = shaped_point<POINT_T>(s, m, g);
+    if (s != front_shape::cloud) {
+        std::normal_distribution<double> nd(0., 0.05);
+        for (size_t i = 0; i < m; ++i) {
+            p[i] += nd(g);
+        }
+    }
+    return p;
+}
+
+/// \brief Generator for queries in benchmarks
+/// Each benchmark thread has its own generator.
+inline std::mt19937 &workload_generator() {
+    thread_local std::mt19937 g(
+        static_cast<std::mt19937::result_type>(fixed_seed()));
+    return g;
+}
+
+/// \brief Create n values of a given shape
+/// These values are not inserted in a front, so there might be
+/// dominated values in the cloud.
+template <class FRONT_T>
+std::vector<typename FRONT_T::value_type>
+create_shaped_values(front_shape s, size_t n,
+                     size_t m = FRONT_T::number_of_compile_dimensions) {
+    using point_type = typename FRONT_T::key_type;
+    using mapped_type = typename FRONT_T::mapped_type;
+    std::uniform_int_distribution<unsigned> ud(0, 40);
+    std::vector<typename FRONT_T::value_type> v;
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        v.emplace_back(shaped_point<point_type>(s, m, workload_generator()),
+                       static_cast<mapped_type>(ud(workload_generator())));
+    }
+    return v;
+}
+
+/// \brief Fill a front with n points of a given shape
+/// The fronts have exactly n points for all shapes except the cloud,
+/// whose non-dominated set might be smaller than n. The fronts only
+/// depend on the shape, size, and seed.
+/// \param m Number of objectives (only used if the front is empty and
+///          has no compile time dimension)
+template <class FRONT_T>
+void fill_shaped_front(FRONT_T &pf, front_shape s, size_t n, size_t m,
+                       uint64_t seed) {
+    using point_type = typename FRONT_T::key_type;
+    using mapped_type = typename FRONT_T::mapped_type;
+    if constexpr (FRONT_T::number_of_compile_dimensions != 0) {
+        m = FRONT_T::number_of_compile_dimensions;
+    }
+    std::mt19937 g(static_cast<std::mt19937::result_type>(seed));
+    std::uniform_int_distribution<unsigned> ud(0, 40);
+    const size_t max_tries = std::max(static_cast<size_t>(100000), n * 100);
+    for (size_t i = 0; i < max_tries && pf.size() < n; ++i) {
+        pf.insert(std::make_pair(shaped_point<point_type>(s, m, g),
+                                 static_cast<mapped_type>(ud(g))));
+    }
+}
+
+/// \brief Create a front with n points of a given shape
+template <size_t M, class Container = pareto::spatial_map<double, M, unsigned>>
+pareto::front<double, M, unsigned, Container>
+create_shaped_front(front_shape s, size_t n, size_t m = M,
+                    uint64_t seed = fixed_seed()) {
+    pareto::front<double, M, unsigned, Container> pf;
+    fill_shaped_front(pf, s, n, m, seed);
+    return pf;
+}
+
+/// \brief Get a front with n points of a given shape from a cache
+/// Benchmarks create the same fronts many times, so we only
+/// generate them once.
+template <size_t M, class Container = pareto::spatial_map<double, M, unsigned>>
+pareto::front<double, M, unsigned, Container>
+get_shaped_front_from_cache(front_shape s, size_t n, size_t m = M) {
+    using front_type = pareto::front<double, M, unsigned, Container>;
+    using cache_key_type = std::tuple<front_shape, size_t, size_t>;
+    static std::map<cache_key_type, front_type> cache;
+    static std::mutex working_with_cache;
+    std::lock_guard lock(working_with_cache);
+    cache_key_type k{s, n, m};
+    auto it = cache.find(k);
+    if (it == cache.end()) {
+        it = cache.emplace(k, create_shaped_front<M, Container>(s, n, m))
+                 .first;
+    }
+    return it->second;
+}
+
+#endif // PARETO_WORKLOADS_H